@@ -3,9 +3,13 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 frag_pos;
 
+layout (std140) uniform Camera
+{
+  mat4 view;
+  mat4 projection;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
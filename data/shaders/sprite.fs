@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 frag_color;
+
+in vec2 uv;
+in vec4 color;
+
+uniform sampler2D sprite_texture;
+
+void main()
+{
+  frag_color = texture(sprite_texture, uv) * color;
+}
@@ -0,0 +1,22 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aUV;
+layout (location = 2) in mat4 aTransform;
+layout (location = 6) in vec4 aColor;
+layout (location = 7) in vec4 aUVRect;
+
+layout (std140) uniform Camera
+{
+  mat4 view;
+  mat4 projection;
+};
+
+out vec2 uv;
+out vec4 color;
+
+void main()
+{
+  gl_Position = projection * view * aTransform * vec4(aPos, 1.0);
+  uv = aUVRect.xy + aUV * aUVRect.zw;
+  color = aColor;
+}
@@ -1,26 +1,95 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <VNgine/gl_resources.h>
+#include <VNgine/gl_state.h>
 #include <VNgine/helper.h>
+#include <VNgine/profiler.h>
 #include <VNgine/thunk.h>
 
 namespace VNgine
 {
 
+class GLDebugLog;
+
+/*
+ * The GLFW window and GL context the engine renders through.
+ *
+ * HEADLESS creates the window hidden, turns vsync off and points the default draw and read
+ * framebuffer at an offscreen RGBA8 + depth framebuffer of the requested size, so frames
+ * render at full speed on hosts without a display (e.g. Mesa llvmpipe on CI). present()
+ * then waits for the frame to finish instead of swapping, so the time between presents is
+ * the time the frame took to render.
+ *
+ * Where KHR_debug is available, the driver's debug messages go to a GLDebugLog.
+ *
+ * GL objects retired while the context is current are deleted by the window's GLResources
+ * once the frame that retired them has finished on the GPU.
+ */
 class Window : non_copyable<Window>
 {
 public:
-  Window(int width, int height, std::string_view title);
+  enum class Mode
+  {
+    WINDOWED,
+    HEADLESS
+  };
+
+  Window(int width, int height, std::string_view title, Mode mode = Mode::WINDOWED);
   ~Window();
+  // Does nothing when headless
   void show() const;
   int shouldClose() const;
   void poll() const;
-  void present() const;
+  // Call from the thread the context is current on. Also applies any resize that arrived
+  // since the last frame, closes the frame for the GL state counters, deletes the GL
+  // objects the GPU is done with and ends the frame for FrameMemory.
+  void present();
+
+  // Makes the context, its GL state tracker, resource pool and GPU profiler current on
+  // this thread
+  void makeContextCurrent();
+  // Releases the context from this thread
+  void releaseContext();
+
+  bool isHeadless() const;
+  // The framebuffer frames are drawn to: the offscreen one when headless, else 0
+  GLuint getFramebuffer() const;
+  // FNV-1a hash of the pixels drawn so far this frame, for checking that a scene renders
+  // the same from run to run. Reads the framebuffer back, so it waits for the GPU.
+  std::uint64_t hashFrame();
 
   GLFWwindow* getHandle() const;
+  GLState& getGLState();
+  GLResources& getGLResources();
+  GpuProfiler& getGpuProfiler();
+  // Null without KHR_debug
+  GLDebugLog* getDebugLog();
 private:
+  // Runs in poll(), which need not be on the context's thread, so it only records the size
+  void framebufferSizeCallback(GLFWwindow* window, int width, int height);
+  void createOffscreenFramebuffer(int width, int height);
+
   GLFWwindow* window_;
+  Mode mode_;
+  GLuint framebuffer_ = 0;
+  GLuint color_buffer_ = 0;
+  GLuint depth_buffer_ = 0;
+  int offscreen_width_ = 0;
+  int offscreen_height_ = 0;
+  GLState gl_state_;
+  GLResources gl_resources_;
+  GpuProfiler gpu_profiler_;
+  std::unique_ptr<GLDebugLog> debug_log_;
+  Thunk<Window, GLFWframebuffersizefun> framebuffer_size_thunk_;
+  // Width in the high half and height in the low half, or no_resize
+  std::atomic<std::uint64_t> pending_size_;
+  static constexpr std::uint64_t no_resize = ~std::uint64_t{ 0 };
 };
 
 }
@@ -0,0 +1,336 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <VNgine/helper.h>
+#include <VNgine/job_system.h>
+
+namespace VNgine
+{
+
+// Stays valid until the entity is destroyed; a destroyed entity's index is reused with a
+// new generation, so stale handles are told apart
+struct Entity
+{
+  std::uint32_t index;
+  std::uint32_t generation;
+
+  bool operator==(Entity const& other) const { return index == other.index && generation == other.generation; }
+  bool operator!=(Entity const& other) const { return !(*this == other); }
+};
+
+using ComponentId = std::uint32_t;
+
+namespace detail
+{
+
+// Assigns the next free id, recording the type's size and alignment for the store
+ComponentId registerComponent(std::size_t size, std::size_t alignment);
+
+}
+
+// Dense id of a component type, assigned on first use
+template <typename T>
+ComponentId componentId()
+{
+  if constexpr (std::is_const_v<T>)
+  {
+    // A const query shares the id of the component itself
+    return componentId<std::remove_const_t<T>>();
+  }
+  else
+  {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+      "Components are moved between chunks by copying their bytes.");
+    static ComponentId const id = detail::registerComponent(sizeof(T), alignof(T));
+    return id;
+  }
+}
+
+/*
+ * Entities and their components, grouped by component set into archetypes.
+ *
+ * Each archetype keeps its entities in fixed-size chunks of 16 KiB, with one array per
+ * component inside the chunk, so a query walks contiguous arrays of exactly the components
+ * it asks for. Entities stay packed: destroying one, or moving it to another archetype by
+ * adding or removing a component, moves the archetype's last entity into the hole.
+ * Archetypes remember where adding or removing each component leads, so structural
+ * changes after the first cost no lookup.
+ *
+ * Components must be trivially copyable, and at most 64 component types exist per program.
+ * Queries take components as template arguments; a const component is read only.
+ *
+ *   store.each<Position, Velocity const>([](Position& p, Velocity const& v) { ... });
+ *   store.eachChunk<Position>([](std::size_t count, Position* positions) { ... });
+ *
+ * No entity may be created, destroyed, or gain or lose a component while a query runs.
+ */
+class EntityStore : non_copyable<EntityStore>
+{
+public:
+  static constexpr std::size_t max_components = 64;
+  static constexpr std::size_t chunk_bytes = 16 * 1024;
+
+  EntityStore();
+  ~EntityStore();
+
+  template <typename... Components>
+  Entity create(Components const&... components);
+  void destroy(Entity entity);
+  bool isAlive(Entity entity) const;
+
+  // Adding a component the entity has overwrites it; removing one it lacks does nothing
+  template <typename T>
+  void add(Entity entity, T const& component);
+  template <typename T>
+  void remove(Entity entity);
+  template <typename T>
+  bool has(Entity entity) const;
+  // Null if the entity lacks the component. Invalidated by any structural change.
+  template <typename T>
+  T* get(Entity entity);
+
+  // Calls function(Components&...) for every entity that has all of Components
+  template <typename... Components, typename Function>
+  void each(Function&& function);
+  // Calls function(count, Components*...) once per matching chunk, with arrays of `count`
+  template <typename... Components, typename Function>
+  void eachChunk(Function&& function);
+  // As eachChunk, with matching chunks run as jobs. The function must be safe to call
+  // concurrently for different chunks.
+  template <typename... Components, typename Function>
+  void parallelEachChunk(JobSystem& jobs, Function&& function);
+
+  std::size_t size() const;
+  std::size_t archetypeCount() const;
+  std::size_t chunkCount() const;
+
+private:
+  using Mask = std::uint64_t;
+
+  class Chunk : non_copyable<Chunk>
+  {
+  public:
+    Chunk();
+    ~Chunk();
+    std::byte* data() const { return data_; }
+  private:
+    std::byte* data_;
+  };
+
+  struct Archetype
+  {
+    Mask mask;
+    std::size_t capacity;                             // entities per chunk
+    std::array<std::uint32_t, max_components> offsets;  // of each component's array in a chunk
+    std::array<std::uint32_t, max_components> sizes;
+    std::vector<ComponentId> components;
+    std::vector<std::unique_ptr<Chunk>> chunks;       // beyond size / capacity are spares
+    std::size_t size = 0;
+    std::array<Archetype*, max_components> add_edges{};
+    std::array<Archetype*, max_components> remove_edges{};
+
+    template <typename T>
+    T* column(std::size_t chunk) const
+    {
+      return reinterpret_cast<T*>(chunks[chunk]->data() + offsets[componentId<T>()]);
+    }
+    Entity* entities(std::size_t chunk) const
+    {
+      return reinterpret_cast<Entity*>(chunks[chunk]->data());
+    }
+    std::byte* component(ComponentId id, std::size_t row) const
+    {
+      return chunks[row / capacity]->data() + offsets[id] + (row % capacity) * sizes[id];
+    }
+    std::size_t chunkCount() const { return (size + capacity - 1) / capacity; }
+    std::size_t chunkSize(std::size_t chunk) const
+    {
+      return (chunk + 1 < chunkCount()) ? capacity : size - chunk * capacity;
+    }
+  };
+
+  struct Record
+  {
+    Archetype* archetype;
+    std::uint32_t row;
+    std::uint32_t generation;
+  };
+
+  template <typename... Components>
+  static Mask maskOf();
+
+  Archetype& archetypeFor(Mask mask);
+  // Appends a row for `entity` and returns it
+  std::uint32_t push(Archetype& archetype, Entity entity);
+  // Removes a row, moving the archetype's last entity into it
+  void erase(Archetype& archetype, std::uint32_t row);
+  // Moves the entity to `target`, keeping the components both archetypes share
+  void move(Entity entity, Archetype& target);
+  Entity allocateEntity();
+  Record& recordOf(Entity entity);
+  Record const& recordOf(Entity entity) const;
+
+  std::vector<std::unique_ptr<Archetype>> archetypes_;
+  std::unordered_map<Mask, Archetype*> archetype_lookup_;
+  std::vector<Record> records_;
+  std::vector<std::uint32_t> free_indices_;
+  std::size_t size_ = 0;
+#ifndef NDEBUG
+  mutable bool iterating_ = false;
+#endif
+};
+
+template <typename... Components>
+EntityStore::Mask EntityStore::maskOf()
+{
+  return (Mask{ 0 } | ... | (Mask{ 1 } << componentId<Components>()));
+}
+
+template <typename... Components>
+Entity EntityStore::create(Components const&... components)
+{
+  assert(!iterating_ && "Entity created during a query.");
+  Entity const entity = allocateEntity();
+  Archetype& archetype = archetypeFor(maskOf<Components...>());
+  std::uint32_t const row = push(archetype, entity);
+  (std::memcpy(archetype.component(componentId<Components>(), row), &components, sizeof(Components)), ...);
+  return entity;
+}
+
+template <typename T>
+void EntityStore::add(Entity entity, T const& component)
+{
+  assert(!iterating_ && "Component added during a query.");
+  ComponentId const id = componentId<T>();
+  Archetype* const source = recordOf(entity).archetype;
+  if (!(source->mask & (Mask{ 1 } << id)))
+  {
+    Archetype*& target = source->add_edges[id];
+    if (!target)
+    {
+      target = &archetypeFor(source->mask | (Mask{ 1 } << id));
+    }
+    move(entity, *target);
+  }
+  Record const& record = recordOf(entity);
+  std::memcpy(record.archetype->component(id, record.row), &component, sizeof(T));
+}
+
+template <typename T>
+void EntityStore::remove(Entity entity)
+{
+  assert(!iterating_ && "Component removed during a query.");
+  ComponentId const id = componentId<T>();
+  Archetype* const source = recordOf(entity).archetype;
+  if (source->mask & (Mask{ 1 } << id))
+  {
+    Archetype*& target = source->remove_edges[id];
+    if (!target)
+    {
+      target = &archetypeFor(source->mask & ~(Mask{ 1 } << id));
+    }
+    move(entity, *target);
+  }
+}
+
+template <typename T>
+bool EntityStore::has(Entity entity) const
+{
+  return recordOf(entity).archetype->mask & (Mask{ 1 } << componentId<T>());
+}
+
+template <typename T>
+T* EntityStore::get(Entity entity)
+{
+  Record const& record = recordOf(entity);
+  if (!has<T>(entity))
+  {
+    return nullptr;
+  }
+  return reinterpret_cast<T*>(record.archetype->component(componentId<T>(), record.row));
+}
+
+template <typename... Components, typename Function>
+void EntityStore::each(Function&& function)
+{
+  eachChunk<Components...>([&function](std::size_t count, Components*... columns)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      function(columns[i]...);
+    }
+  });
+}
+
+template <typename... Components, typename Function>
+void EntityStore::eachChunk(Function&& function)
+{
+  Mask const mask = maskOf<Components...>();
+#ifndef NDEBUG
+  iterating_ = true;
+#endif
+  for (std::unique_ptr<Archetype> const& archetype : archetypes_)
+  {
+    if ((archetype->mask & mask) != mask)
+    {
+      continue;
+    }
+    for (std::size_t chunk = 0, chunks = archetype->chunkCount(); chunk < chunks; ++chunk)
+    {
+      function(archetype->chunkSize(chunk), archetype->template column<Components>(chunk)...);
+    }
+  }
+#ifndef NDEBUG
+  iterating_ = false;
+#endif
+}
+
+template <typename... Components, typename Function>
+void EntityStore::parallelEachChunk(JobSystem& jobs, Function&& function)
+{
+  Mask const mask = maskOf<Components...>();
+  struct Work
+  {
+    Archetype const* archetype;
+    std::size_t chunk;
+  };
+  std::vector<Work> work;
+  for (std::unique_ptr<Archetype> const& archetype : archetypes_)
+  {
+    if ((archetype->mask & mask) == mask)
+    {
+      for (std::size_t chunk = 0, chunks = archetype->chunkCount(); chunk < chunks; ++chunk)
+      {
+        work.push_back({ archetype.get(), chunk });
+      }
+    }
+  }
+
+#ifndef NDEBUG
+  iterating_ = true;
+#endif
+  // A chunk is enough work to outweigh scheduling a job for it
+  jobs.parallelFor(work.size(), 1, [&work, &function](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      Work const& item = work[i];
+      function(item.archetype->chunkSize(item.chunk), item.archetype->template column<Components>(item.chunk)...);
+    }
+  });
+#ifndef NDEBUG
+  iterating_ = false;
+#endif
+}
+
+}
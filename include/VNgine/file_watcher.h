@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+/*
+ * Reports files in one directory that were written or replaced.
+ *
+ * The kernel queues change notifications (inotify on Linux), so checking costs a single
+ * non-blocking read and nothing touches the filesystem while nothing changes. Other
+ * platforms have no backend yet; there the watcher never reports anything.
+ */
+class FileWatcher : non_copyable<FileWatcher>
+{
+public:
+  explicit FileWatcher(std::string_view directory);
+  ~FileWatcher();
+
+  bool isWatching() const;
+  // File names, without the directory, changed since the previous call. Each name appears
+  // once however many times the file was written. Valid until the next call.
+  std::vector<std::string> const& poll();
+
+private:
+  int fd_ = -1;
+  std::vector<std::string> changed_;
+};
+
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <VNgine/helper.h>
+#include <VNgine/memory_tracker.h>
+
+namespace VNgine
+{
+
+/*
+ * Linear allocator for data that lives until the end of the frame: allocating bumps an
+ * offset, and reset() releases everything at once. Nothing is destroyed, so only trivially
+ * destructible types may be placed in it.
+ *
+ * A frame that runs out of room takes each further allocation from the heap instead, and
+ * the next reset() replaces the block with one big enough for the whole of that frame, so
+ * steady state costs no heap allocation at all. The heap blocks it holds are reported to
+ * MemoryTracker under its tag.
+ */
+class FrameAllocator : non_copyable<FrameAllocator>
+{
+public:
+  struct Stats
+  {
+    std::size_t used;       // bytes handed out this frame, alignment padding included
+    std::size_t peak;       // most bytes any frame used
+    std::size_t overflows;  // allocations that did not fit in the block
+  };
+
+  explicit FrameAllocator(std::size_t capacity, MemoryTag tag = MemoryTag::FRAME);
+  ~FrameAllocator();
+
+  // `alignment` must be a power of two
+  void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+  // Uninitialized room for `count` objects
+  template <typename T>
+  T* allocate(std::size_t count = 1);
+  template <typename T, typename... Args>
+  T* make(Args&&... args);
+
+  // Releases everything allocated since the last reset
+  void reset();
+
+  std::size_t getCapacity() const;
+  Stats const& stats() const;
+
+private:
+  void* allocateOverflow(std::size_t size, std::size_t alignment);
+
+  std::unique_ptr<std::byte[]> block_;
+  std::size_t capacity_;
+  std::size_t offset_ = 0;
+  std::vector<std::unique_ptr<std::byte[]>> overflow_;
+  std::size_t overflow_bytes_ = 0;
+  MemoryTag tag_;
+  Stats stats_{};
+};
+
+/*
+ * A FrameAllocator as a std::pmr resource, so standard containers can opt in:
+ *
+ *   std::pmr::vector<Glyph> glyphs{ FrameMemory::resource() };
+ *
+ * Deallocating does nothing; memory comes back when the allocator is reset, so the
+ * container must be gone by then.
+ */
+class FrameResource : public std::pmr::memory_resource, non_copyable<FrameResource>
+{
+public:
+  explicit FrameResource(FrameAllocator& allocator);
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+  bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override;
+
+  FrameAllocator& allocator_;
+};
+
+/*
+ * A frame arena for every thread that asks for one, for scratch data such as draw
+ * packets, text layout or file contents that is done with within a frame or so.
+ *
+ * Each thread has two FrameAllocators and uses them on alternate frames. Window::present()
+ * ends the frame for all threads by advancing a counter; a thread resets its arena for the
+ * new frame lazily, the first time it asks for it, so ending a frame touches no other
+ * thread's memory. Memory stays valid until endFrame() has been called twice after it
+ * was allocated: data built while the render thread still draws the previous frame is not
+ * pulled from under it.
+ */
+class FrameMemory
+{
+public:
+  static constexpr std::size_t initial_capacity = 256 * 1024;
+
+  // This thread's arena for the current frame
+  static FrameAllocator& allocator();
+  static std::pmr::memory_resource* resource();
+
+  static void endFrame();
+  static std::uint64_t frame();
+
+private:
+  static inline std::atomic<std::uint64_t> frame_{ 0 };
+};
+
+inline void* FrameAllocator::allocate(std::size_t size, std::size_t alignment)
+{
+  assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "Alignment must be a power of two.");
+  std::uintptr_t const base = reinterpret_cast<std::uintptr_t>(block_.get());
+  std::size_t const start = ((base + offset_ + alignment - 1) & ~(alignment - 1)) - base;
+  if (start + size > capacity_)
+  {
+    return allocateOverflow(size, alignment);
+  }
+  stats_.used += start + size - offset_;
+  offset_ = start + size;
+  return block_.get() + start;
+}
+
+template <typename T>
+T* FrameAllocator::allocate(std::size_t count)
+{
+  static_assert(std::is_trivially_destructible_v<T>, "Frame memory is released without running destructors.");
+  return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+}
+
+template <typename T, typename... Args>
+T* FrameAllocator::make(Args&&... args)
+{
+  return new (allocate<T>()) T{ std::forward<Args>(args)... };
+}
+
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+#include <GL/glew.h>
+
+#include <VNgine/helper.h>
+#include <VNgine/ring_buffer.h>
+
+namespace VNgine
+{
+
+struct GLDebugMessage
+{
+  static constexpr std::size_t max_text = 224;
+
+  std::uint64_t timestamp;  // steady clock nanoseconds at the time the callback ran
+  GLenum source;
+  GLenum type;
+  GLuint id;
+  GLenum severity;
+  std::uint32_t length;     // of the driver's text; longer than max_text - 1 means truncated
+  char text[max_text];      // nul-terminated
+};
+static_assert(std::is_trivially_copyable_v<GLDebugMessage>);
+static_assert(sizeof(GLDebugMessage) == 256, "Keep messages to four cache lines.");
+
+/*
+ * Receives KHR_debug messages and writes them out on a thread of its own.
+ *
+ * Some drivers report a performance warning on every draw, so the callback does no more
+ * than check the severity and copy the message into a lock-free queue; a full queue drops
+ * the message and counts it. The writer thread formats what it finds there:
+ *
+ * - Messages with the same source, type and ID (or text, for drivers that leave the ID 0)
+ *   are written once per `repeat_interval_ms`; the repeats in between are counted and
+ *   the count is appended to the next one that is written.
+ * - At most `lines_per_second` lines are written, so a flood of distinct messages does
+ *   not become a flood of output; lines held back are reported as a count.
+ *
+ * The driver calls back on whatever thread it likes unless the context is synchronous, so
+ * the queue takes any number of producers. Synchronous output calls back inside the GL
+ * call that raised the message, which is what a debugger breakpoint needs but serializes
+ * the driver, so it is only turned on when asked for.
+ */
+class GLDebugLog : non_copyable<GLDebugLog>
+{
+public:
+  static constexpr std::size_t capacity = 256;
+
+  enum class Severity : std::uint8_t
+  {
+    NOTIFICATION,
+    LOW,
+    MEDIUM,
+    HIGH
+  };
+
+  struct Options
+  {
+    Severity min_severity = Severity::LOW;
+    std::uint32_t repeat_interval_ms = 5000;
+    std::uint32_t lines_per_second = 20;
+    std::ostream* out = nullptr;  // std::cerr if not set
+  };
+
+  struct Stats
+  {
+    std::uint64_t received;      // callbacks, whatever their severity
+    std::uint64_t filtered;      // below the minimum severity
+    std::uint64_t dropped;       // queue full
+    std::uint64_t repeats;       // held back as a repeat of a message already written
+    std::uint64_t rate_limited;  // held back by the line limit
+    std::uint64_t written;
+  };
+
+  GLDebugLog();
+  explicit GLDebugLog(Options const& options);
+  // Writes out what is still queued, along with any repeat counts not yet reported
+  ~GLDebugLog();
+
+  // Points the current context's debug output here, asynchronous. The log must outlive
+  // the context or be uninstalled first. Context thread only, as are the two below.
+  void install();
+  void uninstall();
+  // Synchronous output calls back inside the GL call that raised the message, for a
+  // debugger breakpoint to stop on
+  void setSynchronous(bool synchronous);
+
+  void setMinSeverity(Severity severity);
+  Severity getMinSeverity() const;
+
+  // Waits until every message queued before the call has been written or held back
+  void flush();
+  Stats stats() const;
+
+  // Signature matches GLDEBUGPROC; `user` is the GLDebugLog
+  static void GLAPIENTRY callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                                  GLchar const* message, void const* user);
+  void receive(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, GLchar const* message);
+
+  static Severity severityOf(GLenum severity);
+
+private:
+  struct Repeat
+  {
+    GLuint id;
+    std::uint64_t written_at;
+    std::uint64_t count;  // held back since written_at
+  };
+
+  void writerMain();
+  void handle(GLDebugMessage const& message);
+  bool takeLine();
+  void write(GLDebugMessage const& message, std::uint64_t repeats);
+  void writeRepeatSummary();
+
+  Options options_;
+  std::ostream& out_;
+  std::atomic<Severity> min_severity_;
+  MpscRingBuffer<GLDebugMessage, capacity> queue_;
+
+  // Producers
+  std::atomic<std::uint64_t> received_{ 0 };
+  std::atomic<std::uint64_t> filtered_{ 0 };
+  std::atomic<std::uint64_t> dropped_{ 0 };
+  std::atomic<std::uint64_t> queued_{ 0 };
+
+  // Writer thread; the counters are read by stats()
+  std::unordered_map<std::uint64_t, Repeat> repeats_;
+  double line_budget_;
+  std::uint64_t budget_time_;
+  std::uint64_t held_back_ = 0;  // by the line limit, since the last line written
+  std::atomic<std::uint64_t> repeat_count_{ 0 };
+  std::atomic<std::uint64_t> rate_limited_{ 0 };
+  std::atomic<std::uint64_t> written_{ 0 };
+
+  // Wakes the writer, and flush() once the writer has caught up
+  std::mutex mutex_;
+  std::condition_variable wake_signal_;
+  std::condition_variable flushed_signal_;
+  std::uint64_t handled_ = 0;
+  bool flush_requested_ = false;
+  bool stopping_ = false;
+
+  std::thread writer_;
+};
+
+}
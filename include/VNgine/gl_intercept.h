@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace VNgine
+{
+
+/*
+ * Counts the GL calls the engine makes, per frame, by swapping GLEW's function pointers
+ * for counting wrappers that forward to the driver.
+ *
+ * Only built with VNGINE_GL_INTERCEPT; without it, none of this is compiled and Window
+ * does not call it, so there is no cost at all. install() runs after glewInit() in
+ * Window::Window, and Window::present() closes each frame.
+ *
+ * GLEW links the GL 1.1 entry points directly rather than through pointers, so glDrawArrays,
+ * glDrawElements, glBindTexture, glTexImage2D, glEnable and the like cannot be seen here.
+ * The engine's own draws are instanced and its texture binds are counted by GLState.
+ *
+ * Writes through a mapped pointer make no GL call either. StreamBuffer reports the bytes
+ * it hands out through countMappedWrite(); other mappings are only counted when their
+ * ranges are flushed explicitly.
+ */
+class GLIntercept
+{
+public:
+  struct Counts
+  {
+    std::uint64_t draw_calls;
+    std::uint64_t primitives;     // triangles, lines or points; indirect draws add none
+    std::uint64_t binds;          // buffers, vertex arrays, framebuffers, samplers, programs
+    std::uint64_t state_changes;  // texture units, blending and vertex attribute setup
+    std::uint64_t uniform_calls;
+    std::uint64_t buffer_bytes;   // uploaded, flushed from a mapping or written into a StreamBuffer
+  };
+
+  // Wraps the current GLEW pointers; call again after every glewInit()
+  static void install();
+  static bool isInstalled();
+
+  // For writers into mapped memory, which the wrappers cannot see
+  static void countMappedWrite(std::size_t bytes);
+
+  // Calls so far in the frame being recorded
+  static Counts frame();
+  static Counts const& lastFrame();
+  static Counts const& total();
+  static std::uint64_t frameCount();
+  // Ends the frame, printing a summary every `summary_interval` frames if set
+  static void endFrame();
+  // 0 turns the summary off
+  static void setSummaryInterval(std::size_t frames);
+};
+
+}
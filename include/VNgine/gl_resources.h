@@ -0,0 +1,210 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+enum class GLResourceType : std::uint8_t
+{
+  BUFFER,
+  VERTEX_ARRAY,
+  TEXTURE,
+  FRAMEBUFFER,
+  RENDERBUFFER,
+  SHADER,
+  PROGRAM,
+  COUNT
+};
+
+// 20 bits of slot index and 12 of generation; the type is part of the C++ type, so a
+// buffer handle cannot be passed where a texture is expected. 0 is never a valid handle.
+template <GLResourceType Type>
+struct GLHandle
+{
+  static constexpr unsigned index_bits = 20;
+  static constexpr std::uint32_t index_mask = (1u << index_bits) - 1;
+
+  std::uint32_t value = 0;
+
+  std::uint32_t index() const { return value & index_mask; }
+  std::uint32_t generation() const { return value >> index_bits; }
+  explicit operator bool() const { return value != 0; }
+  bool operator==(GLHandle other) const { return value == other.value; }
+  bool operator!=(GLHandle other) const { return value != other.value; }
+};
+
+using GLBufferHandle = GLHandle<GLResourceType::BUFFER>;
+using GLVertexArrayHandle = GLHandle<GLResourceType::VERTEX_ARRAY>;
+using GLTextureHandle = GLHandle<GLResourceType::TEXTURE>;
+using GLFramebufferHandle = GLHandle<GLResourceType::FRAMEBUFFER>;
+using GLRenderbufferHandle = GLHandle<GLResourceType::RENDERBUFFER>;
+using GLShaderHandle = GLHandle<GLResourceType::SHADER>;
+using GLProgramHandle = GLHandle<GLResourceType::PROGRAM>;
+
+/*
+ * Owns the GL objects of one context behind generational handles, and deletes them only
+ * once the GPU is done with them.
+ *
+ * Each object type has a table: a sparse array of slots, indexed by the handle, holding
+ * the slot's generation and where its object sits in a dense array of live names. Freeing
+ * a slot bumps its generation, so a handle kept past release() no longer resolves, and
+ * moves the last live name into the hole, so names() is always a packed array to iterate.
+ *
+ * release(), and retire() for objects created elsewhere, do not delete anything. The names
+ * wait in a list for the frame, and endFrame() puts a glFenceSync behind them; once a
+ * later endFrame() finds that fence signalled, every name of that frame is deleted with
+ * one driver call per type. Nothing is deleted while a draw that reads it may still be
+ * queued, and deletions never stall on the GPU.
+ *
+ * Like GLState, one is made current per thread alongside its context. Engine code retires
+ * objects through GLResources::retire(), which deletes immediately through GLState when no
+ * pool is current, as with a bare test context.
+ */
+class GLResources : non_copyable<GLResources>
+{
+public:
+  static constexpr std::size_t type_count = to_integral(GLResourceType::COUNT);
+
+  struct Stats
+  {
+    std::array<std::size_t, type_count> live;  // per type
+    std::size_t created;
+    std::size_t retired;       // names queued for deletion
+    std::size_t deleted;
+    std::size_t pending;       // retired, still waiting for their fence
+    std::size_t delete_calls;  // batched driver calls that deleted them
+    std::size_t stale_lookups;
+  };
+
+  GLResources() = default;
+  // Objects still owned must have been deleted by reset() while the context was current
+  ~GLResources();
+
+  void makeCurrent();
+  static GLResources* current();
+  static void clearCurrent();
+
+  // Generates the object; programs through glCreateProgram. Shaders need a kind, so they
+  // go through createShader().
+  template <GLResourceType Type>
+  GLHandle<Type> create();
+  GLShaderHandle createShader(GLenum kind);
+  // Takes ownership of an object made elsewhere
+  template <GLResourceType Type>
+  GLHandle<Type> adopt(GLuint name);
+
+  // 0 for a stale or empty handle
+  template <GLResourceType Type>
+  GLuint get(GLHandle<Type> handle) const;
+  template <GLResourceType Type>
+  bool isValid(GLHandle<Type> handle) const;
+  // Invalidates the handle now and deletes the object after the frame's fence
+  template <GLResourceType Type>
+  void release(GLHandle<Type> handle);
+
+  // Every live object of a type, in no particular order
+  array_view<GLuint const> names(GLResourceType type) const;
+
+  // Queues an object for deferred deletion on the current pool, or deletes it right away
+  // when no pool is current
+  static void retire(GLResourceType type, GLuint name);
+
+  // Fences the names retired this frame and deletes those of frames the GPU has finished
+  void endFrame();
+  // Waits for every fence and deletes every object, owned or retired. Context thread only.
+  void reset();
+
+  Stats stats() const;
+
+private:
+  struct Table
+  {
+    // Sparse, by slot: generation, and the dense position or the next free slot
+    std::vector<std::uint16_t> generations;
+    std::vector<std::uint32_t> positions;
+    std::uint32_t free_slot = none;
+    // Dense, by position
+    std::vector<GLuint> names;
+    std::vector<std::uint32_t> slots;
+  };
+
+  struct RetiredFrame
+  {
+    GLsync fence = nullptr;
+    std::array<std::vector<GLuint>, type_count> names;
+  };
+
+  static constexpr std::uint32_t none = 0xFFFFFFFF;
+  static constexpr std::uint32_t generation_mask = (1u << (32 - GLBufferHandle::index_bits)) - 1;
+
+  std::uint32_t insert(GLResourceType type, GLuint name);
+  GLuint lookup(GLResourceType type, std::uint32_t value) const;
+  void remove(GLResourceType type, std::uint32_t value);
+  void queue(GLResourceType type, GLuint name);
+  void destroy(RetiredFrame& frame);
+  static void destroy(GLResourceType type, std::vector<GLuint> const& names);
+  static GLuint generate(GLResourceType type);
+
+  std::array<Table, type_count> tables_;
+  RetiredFrame current_frame_;
+  std::deque<RetiredFrame> in_flight_;
+  std::vector<RetiredFrame> spare_frames_;  // keep their vectors' capacity
+  Stats stats_{};
+  mutable std::size_t stale_lookups_ = 0;
+};
+
+template <GLResourceType Type>
+GLHandle<Type> GLResources::create()
+{
+  static_assert(Type != GLResourceType::SHADER, "Shaders are created with createShader().");
+  return adopt<Type>(generate(Type));
+}
+
+template <GLResourceType Type>
+GLHandle<Type> GLResources::adopt(GLuint name)
+{
+  return GLHandle<Type>{ insert(Type, name) };
+}
+
+template <GLResourceType Type>
+GLuint GLResources::get(GLHandle<Type> handle) const
+{
+  return lookup(Type, handle.value);
+}
+
+inline GLuint GLResources::lookup(GLResourceType type, std::uint32_t value) const
+{
+  Table const& table = tables_[to_integral(type)];
+  std::uint32_t const index = value & GLBufferHandle::index_mask;
+  if (value == 0 || index >= table.generations.size() || table.generations[index] != value >> GLBufferHandle::index_bits)
+  {
+    ++stale_lookups_;
+    return 0;
+  }
+  return table.names[table.positions[index]];
+}
+
+template <GLResourceType Type>
+bool GLResources::isValid(GLHandle<Type> handle) const
+{
+  Table const& table = tables_[to_integral(Type)];
+  return handle && handle.index() < table.generations.size()
+    && table.generations[handle.index()] == handle.generation();
+}
+
+template <GLResourceType Type>
+void GLResources::release(GLHandle<Type> handle)
+{
+  remove(Type, handle.value);
+}
+
+}
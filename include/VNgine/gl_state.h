@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <GL/glew.h>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+/*
+ * Shadow of the GL bindings and capabilities the engine changes, so that binding what is
+ * already bound costs a compare instead of a driver call.
+ *
+ * One tracker belongs to each context; Window creates its own and makes it current. Engine
+ * code reaches it through GLState::current(). On a thread with no tracker current, that
+ * returns a pass-through instance which issues every call.
+ *
+ * Capability changes are only recorded by enable() and disable(). flush() applies the net
+ * difference, so toggling a capability back and forth between draws costs nothing. Engine
+ * draw paths flush before drawing; code issuing its own draw calls should do the same.
+ *
+ * Anything that changes GL state behind the tracker's back must call invalidate(), which
+ * makes the next call of each kind go to the driver again. Objects must be deleted through
+ * the delete functions here, because GL unbinds a deleted object and may reuse its name.
+ */
+class GLState : non_copyable<GLState>
+{
+public:
+  struct Stats
+  {
+    std::size_t issued;
+    std::size_t skipped;
+  };
+
+  static constexpr std::size_t texture_units = 16;
+  static constexpr std::size_t uniform_buffer_bindings = 36;
+
+  GLState();
+  ~GLState();
+
+  // Routes GLState::current() on this thread to this tracker
+  void makeCurrent();
+  // Leaves this thread with no tracker, as when its context moves to another thread
+  static void clearCurrent();
+  static GLState& current();
+
+  // Forgets everything; the next call of each kind is issued
+  void invalidate();
+
+  void useProgram(GLuint program);
+  void bindVertexArray(GLuint vertex_array);
+  void bindBuffer(GLenum target, GLuint buffer);
+  void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+  // `unit` counts from zero, not from GL_TEXTURE0
+  void activeTexture(GLuint unit);
+  // Binds to the active texture unit
+  void bindTexture(GLenum target, GLuint texture);
+  void bindTexture(GLuint unit, GLenum target, GLuint texture);
+  void bindFramebuffer(GLenum target, GLuint framebuffer);
+  void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+  void blendFunc(GLenum source, GLenum destination);
+
+  void enable(GLenum capability);
+  void disable(GLenum capability);
+  void flush();
+
+  void deleteProgram(GLuint program);
+  void deleteVertexArray(GLuint vertex_array);
+  void deleteBuffer(GLuint buffer);
+  void deleteTexture(GLuint texture);
+  void deleteFramebuffer(GLuint framebuffer);
+  // Many objects in one driver call
+  void deleteVertexArrays(GLsizei count, GLuint const* vertex_arrays);
+  void deleteBuffers(GLsizei count, GLuint const* buffers);
+  void deleteTextures(GLsizei count, GLuint const* textures);
+  void deleteFramebuffers(GLsizei count, GLuint const* framebuffers);
+
+  // Calls made so far this frame, and over the whole of the last one
+  Stats const& stats() const;
+  Stats const& lastFrame() const;
+  void endFrame();
+
+private:
+  static constexpr GLuint unknown = 0xFFFFFFFF;
+  static constexpr std::size_t buffer_targets = 9;
+  static constexpr std::size_t texture_targets = 8;
+  static constexpr std::size_t capabilities = 13;
+
+  explicit GLState(bool tracking);
+  // Counts the call and says whether it must be issued; updates `cached` if so
+  bool change(GLuint& cached, GLuint value);
+
+  bool tracking_;
+  GLuint program_;
+  GLuint vertex_array_;
+  GLuint active_texture_;
+  GLuint draw_framebuffer_;
+  GLuint read_framebuffer_;
+  std::array<GLuint, buffer_targets> buffers_;
+  std::array<GLuint, uniform_buffer_bindings> uniform_buffers_;
+  std::array<std::array<GLuint, texture_targets>, texture_units> textures_;
+  std::array<GLint, 4> viewport_;
+  std::array<GLuint, 2> blend_func_;
+  // Bit i stands for the capability at index i of the table in gl_state.cpp
+  std::uint32_t capabilities_wanted_ = 0;
+  std::uint32_t capabilities_applied_ = 0;
+  std::uint32_t capabilities_known_ = 0;
+  std::uint32_t capabilities_touched_ = 0;
+  Stats stats_{};
+  Stats last_frame_{};
+};
+
+}
@@ -3,6 +3,9 @@
  */
 
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 #include <type_traits>
 #include <filesystem>
 
@@ -17,6 +20,28 @@ protected:
   ~non_copyable() = default; // Protected non-virtual destructor
 };
 
+// Non-owning view of a contiguous range, standing in for std::span until we move past C++17
+template <typename T>
+class array_view
+{
+public:
+  constexpr array_view() = default;
+  constexpr array_view(T* data, std::size_t size)
+    : data_{ data }, size_{ size }
+  {}
+
+  constexpr T* begin() const { return data_; }
+  constexpr T* end() const { return data_ + size_; }
+  constexpr T* data() const { return data_; }
+  constexpr std::size_t size() const { return size_; }
+  constexpr bool empty() const { return size_ == 0; }
+  constexpr T& operator[](std::size_t index) const { return data_[index]; }
+
+private:
+  T* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
 template<bool Condition, typename ValType>
 struct conditional_value;
 
@@ -46,6 +71,36 @@ constexpr auto to_integral(Enum e) -> std::underlying_type_t<Enum>
   return static_cast<std::underlying_type_t<Enum>>(e);
 }
 
+// 64-bit FNV-1a, usable at compile time for names known up front
+constexpr std::uint64_t fnv1a_hash(std::string_view string)
+{
+  std::uint64_t hash = 0xCBF29CE484222325;
+  for (char const c : string)
+  {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3;
+  }
+  return hash;
+}
+
+// A name with its hash computed once, at compile time for literals
+class hashed_name
+{
+public:
+  constexpr hashed_name(std::string_view name)
+    : name_{ name }, hash_{ fnv1a_hash(name) }
+  {}
+  constexpr hashed_name(char const* name)
+    : hashed_name{ std::string_view{ name } }
+  {}
+
+  constexpr std::string_view str() const { return name_; }
+  constexpr std::uint64_t hash() const { return hash_; }
+
+private:
+  std::string_view name_;
+  std::uint64_t hash_;
+};
+
 template<typename Target, typename Source>
 constexpr auto brute_cast(Source const& s) -> std::enable_if_t<sizeof(Target) == sizeof(Source), Target>
 {
@@ -1,20 +1,33 @@
 #pragma once
 #include <VNgine/engine.h>
+#include <VNgine/input_queue.h>
+#include <VNgine/input_state.h>
 
 namespace VNgine
 {
 
-class Input
+class Input : non_copyable<Input>
 {
 public:
   Input(Window const& window);
+  ~Input();
 
-  // Simple on-keypress callback to test whether it can access params and `this` ptr
-  void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+  // Events received since the previous call, also folded into state(); call once per
+  // frame after Window::poll()
+  array_view<InputEvent const> drain();
+  std::size_t droppedEvents() const;
+
+  InputState const& state() const;
 
 private:
-  long long member_;
-  Thunk<Input, GLFWkeyfun> key_callback_thunk_;
+  GLFWwindow* window_;
+  InputQueue queue_;
+  InputState state_;
+  Thunk<InputQueue, GLFWkeyfun> key_callback_thunk_;
+  Thunk<InputQueue, GLFWcharfun> char_callback_thunk_;
+  Thunk<InputQueue, GLFWcursorposfun> cursor_pos_callback_thunk_;
+  Thunk<InputQueue, GLFWscrollfun> scroll_callback_thunk_;
+  Thunk<InputQueue, GLFWmousebuttonfun> mouse_button_callback_thunk_;
 };
 
 }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+
+#include <VNgine/helper.h>
+#include <VNgine/ring_buffer.h>
+
+namespace VNgine
+{
+
+struct InputEvent
+{
+  enum class Type : std::uint8_t
+  {
+    Key,
+    Char,
+    CursorPos,
+    Scroll,
+    MouseButton
+  };
+
+  Type type;
+  std::uint8_t action;       // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT for keys and buttons
+  std::uint16_t mods;        // GLFW_MOD_* bits for keys and buttons
+  std::int32_t code;         // key, mouse button or Unicode code point
+  std::int32_t scancode;     // keys only
+  float x;                   // cursor position or scroll offset
+  float y;
+  std::uint64_t timestamp;   // steady clock nanoseconds at the time the callback ran
+};
+static_assert(std::is_trivially_copyable_v<InputEvent>);
+static_assert(sizeof(InputEvent) == 32, "Keep events compact, two to a cache line.");
+
+/*
+ * Collects GLFW input callbacks as InputEvents and hands them to the game loop in bulk.
+ *
+ * The callbacks only copy a few words into a lock-free ring buffer, so they are cheap
+ * enough to run inside glfwPollEvents even under a flood of input. The frame then calls
+ * drain() once and walks the events at its leisure. Callbacks are the single producer and
+ * drain() the single consumer, so they may run on different threads.
+ */
+class InputQueue : non_copyable<InputQueue>
+{
+public:
+  static constexpr std::size_t capacity = 1024;
+
+  InputQueue();
+
+  // Returns every event received since the previous call, oldest first. Runs of cursor
+  // motion with nothing in between are coalesced into their last position. The view stays
+  // valid until the next call.
+  array_view<InputEvent const> drain();
+
+  // Events lost because the queue was full when they arrived
+  std::size_t droppedEvents() const;
+
+  // Signatures match GLFW's so these can be bound to thunks
+  void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+  void charCallback(GLFWwindow* window, unsigned int codepoint);
+  void cursorPosCallback(GLFWwindow* window, double x, double y);
+  void scrollCallback(GLFWwindow* window, double x_offset, double y_offset);
+  void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+
+private:
+  void push(InputEvent const& event);
+
+  SpscRingBuffer<InputEvent, capacity> events_;
+  std::atomic<std::size_t> dropped_{ 0 };
+  // Reused every frame so draining never allocates
+  std::vector<InputEvent> frame_events_;
+};
+
+}
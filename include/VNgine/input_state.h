@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <GLFW/glfw3.h>
+
+#include <VNgine/helper.h>
+#include <VNgine/input_queue.h>
+
+namespace VNgine
+{
+
+// Keys and mouse buttons share one index space so a binding can name either
+constexpr std::size_t key_count = GLFW_KEY_LAST + 1;
+constexpr std::size_t mouse_button_count = GLFW_MOUSE_BUTTON_LAST + 1;
+constexpr std::size_t button_count = key_count + mouse_button_count;
+
+constexpr std::uint16_t key(int glfw_key)
+{
+  return static_cast<std::uint16_t>(glfw_key);
+}
+
+constexpr std::uint16_t mouseButton(int glfw_button)
+{
+  return static_cast<std::uint16_t>(key_count + glfw_button);
+}
+
+// Fixed-size bit set over the button index space, usable in constant expressions
+class ButtonSet
+{
+public:
+  static constexpr std::size_t word_count = (button_count + 63) / 64;
+
+  constexpr bool test(std::size_t button) const
+  {
+    return (words_[button / 64] >> (button % 64)) & 1;
+  }
+
+  constexpr void set(std::size_t button)
+  {
+    words_[button / 64] |= std::uint64_t{ 1 } << (button % 64);
+  }
+
+  constexpr void reset(std::size_t button)
+  {
+    words_[button / 64] &= ~(std::uint64_t{ 1 } << (button % 64));
+  }
+
+  constexpr void clear()
+  {
+    for (std::uint64_t& word : words_)
+    {
+      word = 0;
+    }
+  }
+
+private:
+  std::array<std::uint64_t, word_count> words_{};
+};
+
+/*
+ * Snapshot of keyboard and mouse state for the current frame.
+ *
+ * Held buttons live in one bit set that carries over between frames. Presses and releases
+ * are recorded in two more that start empty every frame, so a tap that goes down and up
+ * between two frames still reads as pressed and released for the frame that drained it.
+ */
+class InputState
+{
+public:
+  // Clears the per-frame edges and scroll delta; call before applying a frame's events
+  void beginFrame();
+  void apply(InputEvent const& event);
+
+  bool down(std::size_t button) const { return down_.test(button); }
+  bool pressed(std::size_t button) const { return pressed_.test(button); }
+  bool released(std::size_t button) const { return released_.test(button); }
+
+  float cursorX() const { return cursor_x_; }
+  float cursorY() const { return cursor_y_; }
+  float scrollX() const { return scroll_x_; }
+  float scrollY() const { return scroll_y_; }
+
+private:
+  void setButton(std::size_t button, int action);
+
+  ButtonSet down_;
+  ButtonSet pressed_;
+  ButtonSet released_;
+  float cursor_x_ = 0.0f;
+  float cursor_y_ = 0.0f;
+  float scroll_x_ = 0.0f;
+  float scroll_y_ = 0.0f;
+};
+
+// Reports an action bound to more than MaxBindings buttons and aborts. Not constexpr, so
+// reaching it also stops a constexpr ActionMap from compiling.
+[[noreturn]] void bindingOverflow();
+
+/*
+ * Maps game actions to the buttons that trigger them, declared as a constexpr table:
+ *
+ *   enum class Action { Jump, Fire, Count };
+ *   constexpr ActionMap<Action> actions{ {
+ *     { Action::Jump, key(GLFW_KEY_SPACE) },
+ *     { Action::Fire, mouseButton(GLFW_MOUSE_BUTTON_LEFT) },
+ *     { Action::Fire, key(GLFW_KEY_LEFT_CONTROL) },
+ *   } };
+ *
+ * Each action keeps up to MaxBindings button indices inline, so a query is that many bit
+ * tests against the state, and with a constant map and action the indices fold away.
+ */
+template <typename Action, std::size_t MaxBindings = 4, std::size_t ActionCount = to_integral(Action::Count)>
+class ActionMap
+{
+public:
+  struct Binding
+  {
+    Action action;
+    std::uint16_t button;
+  };
+
+  template <std::size_t N>
+  constexpr ActionMap(Binding const (&bindings)[N])
+  {
+    for (auto& buttons : buttons_)
+    {
+      for (std::uint16_t& button : buttons)
+      {
+        button = unbound;
+      }
+    }
+    for (Binding const& binding : bindings)
+    {
+      auto& buttons = buttons_[to_integral(binding.action)];
+      std::size_t slot = 0;
+      while (slot < MaxBindings && buttons[slot] != unbound)
+      {
+        ++slot;
+      }
+      if (slot == MaxBindings)
+      {
+        bindingOverflow();
+      }
+      buttons[slot] = binding.button;
+    }
+  }
+
+  bool down(InputState const& state, Action action) const
+  {
+    return any(action, [&state](std::size_t button) { return state.down(button); });
+  }
+
+  bool pressed(InputState const& state, Action action) const
+  {
+    return any(action, [&state](std::size_t button) { return state.pressed(button); });
+  }
+
+  bool released(InputState const& state, Action action) const
+  {
+    return any(action, [&state](std::size_t button) { return state.released(button); });
+  }
+
+private:
+  static constexpr std::uint16_t unbound = 0xFFFF;
+
+  template <typename Test>
+  bool any(Action action, Test test) const
+  {
+    for (std::uint16_t const button : buttons_[to_integral(action)])
+    {
+      if (button == unbound)
+      {
+        return false;
+      }
+      if (test(button))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::array<std::array<std::uint16_t, MaxBindings>, ActionCount> buttons_{};
+};
+
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+// Number of jobs started against it that have not finished yet. Owned by whoever waits.
+class JobCounter : non_copyable<JobCounter>
+{
+public:
+  JobCounter() = default;
+  ~JobCounter();
+
+  bool isDone() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+  friend class JobSystem;
+  std::atomic<std::uint32_t> pending_{ 0 };
+};
+
+/*
+ * Work-stealing job scheduler.
+ *
+ * The thread that creates the JobSystem becomes worker 0 and `worker_count` more threads
+ * are started beside it. Each worker has a Chase-Lev deque of jobs: jobs it starts go on
+ * its own deque and it runs them newest first, and a worker that runs dry steals the
+ * oldest job of a random other worker. Idle workers spin briefly, then sleep until a job
+ * is queued.
+ *
+ * Jobs are small trivially copyable callables, lambdas capturing a few references or
+ * pointers, copied into a 64-byte job slot; nothing is heap allocated per job. A job is
+ * started against a JobCounter, and wait() on that counter returns once all its jobs are
+ * done, running queued jobs in the meantime instead of blocking. A running job may start
+ * children with runChild(), which count against its own counter, so waiting for a parent
+ * also waits for everything it spawned:
+ *
+ *   VNgine::JobCounter counter;
+ *   jobs.run(counter, [&] { jobs.runChild([&] { ... }); ... });
+ *   jobs.wait(counter);
+ *
+ * Only worker threads, the creating thread among them, may start jobs or wait. With
+ * `pin_threads`, worker thread i is bound to core i, so the OS does not migrate it away
+ * from the caches it has warmed; the creating thread is left alone.
+ */
+class JobSystem : non_copyable<JobSystem>
+{
+public:
+  // Bytes a job's callable may occupy
+  static constexpr std::size_t job_data_bytes = 40;
+  // Jobs each worker can have queued at once
+  static constexpr std::size_t queue_capacity = 4096;
+
+  struct Options
+  {
+    std::size_t worker_count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    bool pin_threads = false;
+  };
+
+  struct Stats
+  {
+    std::uint64_t jobs;    // run to completion
+    std::uint64_t steals;  // taken from another worker's deque
+    std::uint64_t sleeps;  // times a worker ran out of work and went to sleep
+  };
+
+  JobSystem();
+  explicit JobSystem(Options const& options);
+  ~JobSystem();
+
+  template <typename Function>
+  void run(JobCounter& counter, Function const& function);
+  // Starts a job counted against the counter of the job that is running on this thread
+  template <typename Function>
+  void runChild(Function const& function);
+  // Runs other jobs until every job counted against `counter` has finished
+  void wait(JobCounter const& counter);
+
+  // Calls function(begin, end) over [0, count) in ranges of at most `grain`, split in
+  // halves as workers steal them, and returns when all are done
+  template <typename Function>
+  void parallelFor(std::size_t count, std::size_t grain, Function const& function);
+
+  // Workers, the creating thread included
+  std::size_t threadCount() const;
+  Stats stats() const;
+
+private:
+  struct Job;
+  struct Worker;
+  using Invoke = void (*)(void const* data);
+
+  template <typename Function>
+  static void invoke(void const* data);
+
+  void submit(JobCounter& counter, Invoke invoke, void const* data, std::size_t size);
+  JobCounter& currentCounter() const;
+  Worker& currentWorker() const;
+  Job* findJob(Worker& worker);
+  void execute(Worker& worker, Job* job);
+  void workerMain(std::size_t index, bool pin);
+
+  static thread_local Worker* current_worker_;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  Worker* previous_worker_;
+  std::vector<std::thread> threads_;
+
+  // Sleeping workers wake on a queued job. `queued_` counts jobs sitting in deques.
+  std::atomic<std::size_t> queued_{ 0 };
+  std::atomic<std::size_t> sleeping_{ 0 };
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_signal_;
+  bool stopping_ = false;
+};
+
+template <typename Function>
+void JobSystem::invoke(void const* data)
+{
+  (*static_cast<Function const*>(data))();
+}
+
+template <typename Function>
+void JobSystem::run(JobCounter& counter, Function const& function)
+{
+  static_assert(std::is_trivially_copyable_v<Function> && std::is_trivially_destructible_v<Function>,
+    "Jobs are copied bytewise; capture references or pointers.");
+  static_assert(sizeof(Function) <= job_data_bytes && alignof(Function) <= alignof(void*),
+    "Job captures too large; capture a pointer to the state instead.");
+  submit(counter, &invoke<Function>, &function, sizeof(Function));
+}
+
+template <typename Function>
+void JobSystem::runChild(Function const& function)
+{
+  run(currentCounter(), function);
+}
+
+template <typename Function>
+void JobSystem::parallelFor(std::size_t count, std::size_t grain, Function const& function)
+{
+  struct Range
+  {
+    JobSystem* jobs;
+    Function const* function;
+    std::size_t begin;
+    std::size_t end;
+    std::size_t grain;
+
+    void operator()() const
+    {
+      // Keep the first half, hand out the second, so thieves take big ranges
+      std::size_t split_end = end;
+      while (split_end - begin > grain)
+      {
+        std::size_t const middle = begin + (split_end - begin) / 2;
+        jobs->runChild(Range{ jobs, function, middle, split_end, grain });
+        split_end = middle;
+      }
+      (*function)(begin, split_end);
+    }
+  };
+  if (count == 0)
+  {
+    return;
+  }
+  JobCounter counter;
+  run(counter, Range{ this, &function, 0, count, std::max<std::size_t>(grain, 1) });
+  wait(counter);
+}
+
+}
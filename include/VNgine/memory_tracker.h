@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+// What a block of engine memory is for, as tallied by MemoryTracker
+enum class MemoryTag : std::uint8_t
+{
+  GENERAL,
+  FRAME,      // frame arenas
+  RENDERING,  // render queues and other per-frame GPU submission data
+  SHADERS,
+  ENTITIES,
+  COUNT
+};
+
+/*
+ * Process-wide tally of the memory the engine's allocators hold, per tag.
+ *
+ * Allocators report the blocks they take from the heap, not each object they hand out,
+ * so a frame arena costs two atomic additions per block rather than per allocation, and
+ * the numbers say how much memory each part of the engine keeps, padding and free slots
+ * included. Wrap a std::pmr resource in a TrackedResource to count a container's own
+ * allocations under a tag.
+ */
+class MemoryTracker
+{
+public:
+  struct Stats
+  {
+    std::size_t current;      // bytes held right now
+    std::size_t peak;         // most bytes held at once
+    std::size_t allocations;  // blocks ever taken
+  };
+
+  static void allocated(MemoryTag tag, std::size_t bytes);
+  static void released(MemoryTag tag, std::size_t bytes);
+
+  static Stats stats(MemoryTag tag);
+  // Over all tags; the peak is of the sum, not a sum of peaks
+  static Stats total();
+  static char const* name(MemoryTag tag);
+  // One line per tag that has ever allocated
+  static void report(std::ostream& out);
+};
+
+// Forwards to another std::pmr resource, counting what passes through under a tag
+class TrackedResource : public std::pmr::memory_resource, non_copyable<TrackedResource>
+{
+public:
+  explicit TrackedResource(MemoryTag tag, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+  bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override;
+
+  MemoryTag tag_;
+  std::pmr::memory_resource* upstream_;
+};
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <VNgine/helper.h>
+#include <VNgine/memory_tracker.h>
+
+namespace VNgine
+{
+
+/*
+ * Fixed-size slots for objects of one type that come and go often, such as particles or
+ * pending uploads. Slots are carved out of chunks of `ChunkSize` and freed slots go on an
+ * intrusive free list, so create() and destroy() are a few instructions each and never
+ * touch the heap once the pool has grown to its working size. Chunks are kept until the
+ * pool is destroyed, and their bytes are reported to MemoryTracker under the pool's tag.
+ *
+ * Not thread-safe; give each thread a pool of its own.
+ */
+template <typename T, std::size_t ChunkSize = 64>
+class ObjectPool : non_copyable<ObjectPool<T, ChunkSize>>
+{
+  static_assert(ChunkSize != 0, "Chunks need at least one slot.");
+public:
+  explicit ObjectPool(MemoryTag tag = MemoryTag::GENERAL)
+    : tag_{ tag }
+  {}
+
+  // Every object must have been destroyed first
+  ~ObjectPool()
+  {
+    assert(live_ == 0 && "ObjectPool destroyed with objects still alive.");
+    MemoryTracker::released(tag_, chunks_.size() * sizeof(Slot) * ChunkSize);
+  }
+
+  template <typename... Args>
+  T* create(Args&&... args)
+  {
+    if (!free_)
+    {
+      grow();
+    }
+    Slot* const slot = free_;
+    free_ = slot->next;
+    ++live_;
+    return new (slot->storage) T{ std::forward<Args>(args)... };
+  }
+
+  void destroy(T* object)
+  {
+    assert(object && live_ != 0);
+    object->~T();
+    Slot* const slot = reinterpret_cast<Slot*>(object);
+    slot->next = free_;
+    free_ = slot;
+    --live_;
+  }
+
+  std::size_t size() const { return live_; }
+  std::size_t capacity() const { return chunks_.size() * ChunkSize; }
+
+private:
+  union Slot
+  {
+    Slot* next;
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+  void grow()
+  {
+    chunks_.emplace_back(new Slot[ChunkSize]);
+    MemoryTracker::allocated(tag_, sizeof(Slot) * ChunkSize);
+    Slot* const chunk = chunks_.back().get();
+    // Linked in address order, so a fresh pool hands out consecutive slots
+    for (std::size_t i = ChunkSize; i-- > 0;)
+    {
+      chunk[i].next = free_;
+      free_ = &chunk[i];
+    }
+  }
+
+  std::vector<std::unique_ptr<Slot[]>> chunks_;
+  Slot* free_ = nullptr;
+  std::size_t live_ = 0;
+  MemoryTag tag_;
+};
+
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define VNGINE_PROFILER_RDTSC
+#endif
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+/*
+ * Process-wide record of timed CPU and GPU scopes, written out as a Chrome trace.
+ *
+ * Each thread records its CPU scopes into a ring buffer of its own, so recording takes no
+ * lock and the last 32768 scopes of every thread are kept. Timestamps are raw TSC ticks on
+ * x86-64 and steady_clock nanoseconds elsewhere; ticks are converted when the trace is
+ * written, against steady_clock readings taken at startup and at export. GPU scopes come
+ * from GpuProfiler, already in steady_clock nanoseconds, and share one ring of the same
+ * size behind a lock.
+ *
+ * Recording is off until setEnabled(true), and costs one relaxed load per scope while off.
+ * Built without VNGINE_PROFILING, the VNGINE_PROFILE_SCOPE and VNGINE_GPU_SCOPE macros
+ * compile to nothing at all. Scope names must be string literals or otherwise outlive the
+ * trace.
+ *
+ * The trace loads in chrome://tracing or https://ui.perfetto.dev. Write it while no other
+ * thread is recording, e.g. after the render thread and jobs are done, or scopes being
+ * overwritten may come out garbled.
+ */
+class Profiler
+{
+public:
+  static constexpr std::size_t events_per_thread = 32768;
+
+  static void setEnabled(bool enabled);
+  static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Ticks of the CPU scope clock
+  static std::uint64_t now();
+  static std::uint64_t steadyNanoseconds();
+
+  static void recordCpu(char const* name, std::uint64_t begin, std::uint64_t end);
+  static void recordGpu(char const* name, std::uint64_t begin_ns, std::uint64_t end_ns);
+  // Labels the calling thread's track in the trace
+  static void setThreadName(std::string name);
+
+  // Chrome trace-event JSON of everything recorded since the last clear()
+  static void writeChromeTrace(std::ostream& out);
+  static bool writeChromeTrace(std::string const& path);
+  static void clear();
+
+private:
+  static inline std::atomic<bool> enabled_{ false };
+};
+
+// Times its own lifetime as a CPU scope
+class CpuScope : non_copyable<CpuScope>
+{
+public:
+  explicit CpuScope(char const* name)
+    : name_{ name },
+      begin_{ Profiler::isEnabled() ? Profiler::now() : 0 }
+  {}
+  ~CpuScope()
+  {
+    if (begin_)
+    {
+      Profiler::recordCpu(name_, begin_, Profiler::now());
+    }
+  }
+
+private:
+  char const* name_;
+  std::uint64_t begin_;
+};
+
+/*
+ * GPU scope timings for one GL context, from GL_TIMESTAMP queries.
+ *
+ * A scope issues a timestamp query at its start and one at its end; unlike GL_TIME_ELAPSED
+ * queries, these nest. Results are read back in endFrame() a few frames later, once the
+ * GPU has got that far, and a frame whose results are still not in when its queries are
+ * needed again is dropped rather than waited for. GPU timestamps are mapped to
+ * steady_clock with an offset sampled when the first query is made.
+ *
+ * Like GLState, one is made current per thread alongside its context; VNGINE_GPU_SCOPE
+ * times the enclosing block on the current one.
+ */
+class GpuProfiler : non_copyable<GpuProfiler>
+{
+public:
+  static constexpr std::size_t frames_in_flight = 4;
+
+  struct Stats
+  {
+    std::size_t frames_read;
+    std::size_t frames_dropped;
+    std::size_t scopes;
+  };
+
+  GpuProfiler() = default;
+  ~GpuProfiler();
+
+  void makeCurrent();
+  static GpuProfiler* current();
+  static void clearCurrent();
+  // Deletes the queries; call with the context current before it is destroyed
+  void reset();
+
+  // Returns a handle for end()
+  std::size_t begin(char const* name);
+  void end(std::size_t scope);
+  // Closes the frame's scopes and reads back every older frame whose results are ready
+  void endFrame();
+
+  Stats const& stats() const;
+
+private:
+  struct Scope
+  {
+    char const* name;
+    GLuint begin_query;
+    GLuint end_query;
+  };
+
+  struct Frame
+  {
+    std::vector<Scope> scopes;
+    std::vector<GLuint> queries;  // two per scope, kept for reuse
+    GLuint last_query = 0;        // timestamps complete in order, so this one is done last
+    bool pending = false;
+  };
+
+  GLuint query(Frame& frame, std::size_t index);
+  // Returns false, leaving the frame pending, if its last query is not done yet
+  bool read(Frame& frame);
+
+  Frame frames_[frames_in_flight];
+  std::size_t frame_ = 0;
+  std::int64_t gpu_to_steady_ns_ = 0;
+  bool calibrated_ = false;
+  Stats stats_{};
+};
+
+class GpuScope : non_copyable<GpuScope>
+{
+public:
+  explicit GpuScope(char const* name)
+    : profiler_{ Profiler::isEnabled() ? GpuProfiler::current() : nullptr },
+      scope_{ profiler_ ? profiler_->begin(name) : 0 }
+  {}
+  ~GpuScope()
+  {
+    if (profiler_)
+    {
+      profiler_->end(scope_);
+    }
+  }
+
+private:
+  GpuProfiler* profiler_;
+  std::size_t scope_;
+};
+
+inline std::uint64_t Profiler::now()
+{
+#ifdef VNGINE_PROFILER_RDTSC
+  return __rdtsc();
+#else
+  return steadyNanoseconds();
+#endif
+}
+
+}
+
+#define VNGINE_PROFILE_CONCAT_INNER(a, b) a##b
+#define VNGINE_PROFILE_CONCAT(a, b) VNGINE_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef VNGINE_PROFILING
+#define VNGINE_PROFILE_SCOPE(name) ::VNgine::CpuScope const VNGINE_PROFILE_CONCAT(profile_scope_, __LINE__){ name }
+#define VNGINE_GPU_SCOPE(name) ::VNgine::GpuScope const VNGINE_PROFILE_CONCAT(gpu_scope_, __LINE__){ name }
+#else
+#define VNGINE_PROFILE_SCOPE(name) ((void)0)
+#define VNGINE_GPU_SCOPE(name) ((void)0)
+#endif
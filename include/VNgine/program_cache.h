@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include <GL/glew.h>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+/*
+ * Persistent cache of linked program binaries (glGetProgramBinary / glProgramBinary).
+ *
+ * Entries are keyed by the hashes of the shader sources, any preprocessor defines and the
+ * driver's vendor, renderer and version strings, so a driver update simply misses. Every
+ * file carries a checksum; a corrupt file or one the driver rejects counts as a miss and
+ * the caller compiles from source as if there were no cache.
+ */
+class ProgramCache : non_copyable<ProgramCache>
+{
+public:
+  struct Stats
+  {
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t rejected;       // entries found but corrupt or refused by the driver
+    std::size_t stores;
+    std::size_t bytes_read;
+    std::size_t bytes_written;
+  };
+
+  // Needs a current GL context. Disabled when the driver offers no binary formats.
+  explicit ProgramCache(std::string_view directory);
+
+  std::uint64_t key(std::uint64_t vs_hash, std::uint64_t fs_hash, std::string_view defines = {}) const;
+  // Loads and validates the binary stored for `key` into `program`, returning true if it linked
+  bool load(GLuint program, std::uint64_t key);
+  // Saves the binary of a successfully linked `program`
+  void store(GLuint program, std::uint64_t key);
+
+  bool isEnabled() const;
+  Stats const& stats() const;
+
+private:
+  std::filesystem::path pathFor(std::uint64_t key) const;
+
+  std::filesystem::path directory_;
+  std::uint64_t driver_hash_ = 0;
+  bool enabled_ = false;
+  Stats stats_{};
+};
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <VNgine/frame_allocator.h>
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+class ShaderProgram;
+
+/*
+ * 64-bit draw order, most significant field first:
+ *
+ *   layer 8 | depth 24 | program 10 | material 10 | texture 12
+ *
+ * The program, material and texture fields only group packets that share state, so any
+ * small id that is stable within a frame will do; larger values are masked, which costs
+ * grouping but never correctness. Opaque passes usually leave depth at zero so state
+ * decides the order, and transparent ones fill it in back to front.
+ */
+struct RenderKey
+{
+  static constexpr unsigned texture_bits = 12;
+  static constexpr unsigned material_bits = 10;
+  static constexpr unsigned program_bits = 10;
+  static constexpr unsigned depth_bits = 24;
+  static constexpr unsigned layer_bits = 8;
+
+  static constexpr std::uint64_t make(std::uint8_t layer, std::uint32_t depth, std::uint32_t program,
+                                      std::uint32_t material, std::uint32_t texture)
+  {
+    return (std::uint64_t{ layer } << (depth_bits + program_bits + material_bits + texture_bits))
+      | (std::uint64_t{ depth & mask(depth_bits) } << (program_bits + material_bits + texture_bits))
+      | (std::uint64_t{ program & mask(program_bits) } << (material_bits + texture_bits))
+      | (std::uint64_t{ material & mask(material_bits) } << texture_bits)
+      | std::uint64_t{ texture & mask(texture_bits) };
+  }
+
+  // Quantizes a view distance in [0, far] for the depth field; `back_to_front` makes the
+  // farthest packets sort first
+  static std::uint32_t depth(float distance, float far, bool back_to_front = false);
+
+private:
+  static constexpr std::uint32_t mask(unsigned bits)
+  {
+    return (std::uint32_t{ 1 } << bits) - 1;
+  }
+};
+
+// One draw and the state it needs. `first` is the first vertex for array draws and the byte
+// offset of the first index for indexed ones.
+struct DrawCommand
+{
+  ShaderProgram const* program;
+  GLuint vertex_array;
+  GLuint texture;               // bound to unit 0 as GL_TEXTURE_2D; 0 leaves the unit alone
+  GLenum mode = GL_TRIANGLES;
+  GLenum index_type = GL_NONE;  // GL_NONE draws arrays
+  GLsizei count;
+  GLsizei instance_count = 1;
+  std::size_t first = 0;
+  // Runs once the program is in use, to set per-draw uniforms from `payload`
+  void (*prepare)(ShaderProgram const& program, void const* payload) = nullptr;
+  void const* payload = nullptr;
+};
+
+/*
+ * Draws for a frame, submitted in any order and issued in key order:
+ *
+ *   DrawCommand& draw = queue.submit(RenderKey::make(...));
+ *   fill in draw, with any payload from queue.allocate<T>()
+ *   ...
+ *   queue.sort();
+ *   queue.execute();     // binds only what changes between consecutive packets
+ *   queue.clear();       // once the frame is done with its payloads
+ *
+ * Commands and payloads live in a FrameAllocator, so submitting costs no heap allocation
+ * once the queue has seen a frame of the same size. The sort is an LSD radix sort over the
+ * bytes of the key, skipping bytes all packets share, and keeps submission order among
+ * equal keys.
+ */
+class RenderQueue : non_copyable<RenderQueue>
+{
+public:
+  struct Packet
+  {
+    std::uint64_t key;
+    DrawCommand const* command;
+  };
+
+  struct Stats
+  {
+    std::size_t draw_calls;
+    std::size_t program_changes;
+    std::size_t vertex_array_changes;
+    std::size_t texture_changes;
+  };
+
+  explicit RenderQueue(std::size_t capacity = 4096, std::size_t payload_bytes = 256 * 1024);
+
+  DrawCommand& submit(std::uint64_t key);
+  // Frame memory for a command's payload, valid until clear()
+  template <typename T>
+  T* allocate(std::size_t count = 1);
+
+  void sort();
+  void execute();
+  void clear();
+
+  array_view<Packet const> getPackets() const;
+  FrameAllocator const& getAllocator() const;
+  // Counts for the most recent execute()
+  Stats const& stats() const;
+
+private:
+  std::vector<Packet> packets_;
+  std::vector<Packet> scratch_;
+  FrameAllocator memory_;
+  bool sorted_ = true;
+  Stats stats_{};
+};
+
+inline DrawCommand& RenderQueue::submit(std::uint64_t key)
+{
+  DrawCommand* const command = memory_.make<DrawCommand>();
+  packets_.push_back({ key, command });
+  sorted_ = false;
+  return *command;
+}
+
+template <typename T>
+T* RenderQueue::allocate(std::size_t count)
+{
+  return memory_.allocate<T>(count);
+}
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <VNgine/engine.h>
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+/*
+ * Moves a Window's context to a thread of its own, which renders and presents frames the
+ * main thread describes in packets. The main thread keeps simulating, and keeps calling
+ * Window::poll() as GLFW requires, while a blocking swap waits out vsync elsewhere.
+ *
+ *   RenderThread<Packet> renderer{ window, [&](Packet const& packet) { draw it }, 2 };
+ *   while (running)
+ *   {
+ *     window.poll();
+ *     Packet& packet = renderer.beginFrame();
+ *     fill in packet
+ *     renderer.submit();
+ *   }
+ *
+ * Packets are recycled, so containers in them keep their capacity from frame to frame. The
+ * render function only ever sees a packet after it was submitted, and the main thread only
+ * gets it back once it has been presented, so neither side needs to lock it. With
+ * `frames_in_flight` packets, beginFrame() waits while that many are queued or rendering,
+ * which bounds latency at that many frames.
+ *
+ * GL objects can be created before the render thread starts, since they belong to the
+ * context rather than a thread, and destroyed after it stops. While it runs, all GL calls
+ * must come from the render function. The context returns to the constructing thread when
+ * the render thread is destroyed.
+ */
+class RenderThreadBase : non_copyable<RenderThreadBase>
+{
+public:
+  struct Stats
+  {
+    std::size_t frames;               // frames presented
+    std::uint64_t main_wait_ns;       // main thread blocked in beginFrame() on a full pipeline
+    std::uint64_t render_wait_ns;     // render thread idle, waiting for a packet
+    std::uint64_t render_ns;          // render thread rendering and presenting
+    std::uint64_t latency_ns;         // summed over frames, from beginFrame() returning to presented
+    std::uint64_t max_latency_ns;
+  };
+
+  // Waits until every submitted frame has been presented
+  void finish();
+  // Render time the main thread did not wait for, so ran alongside it
+  static std::uint64_t overlapNs(Stats const& stats);
+  Stats stats() const;
+
+protected:
+  RenderThreadBase(Window& window, std::size_t frames_in_flight);
+  ~RenderThreadBase();
+
+  // Derived constructors start the thread once the render function can run, and derived
+  // destructors stop it before their members go away
+  void start();
+  void stop();
+  std::size_t acquireSlot();
+  void submitSlot();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  virtual void render(std::size_t slot) = 0;
+  void run();
+
+  Window& window_;
+  std::size_t const slots_;
+  std::thread thread_;
+  mutable std::mutex mutex_;
+  std::condition_variable submitted_signal_;
+  std::condition_variable presented_signal_;
+  std::size_t submitted_ = 0;
+  std::size_t presented_ = 0;
+  bool stopping_ = false;
+  std::vector<Clock::time_point> frame_starts_;
+  Stats stats_{};
+};
+
+template <typename Packet>
+class RenderThread : public RenderThreadBase
+{
+public:
+  using Render = std::function<void(Packet const&)>;
+
+  RenderThread(Window& window, Render render, std::size_t frames_in_flight = 2)
+    : RenderThreadBase{ window, frames_in_flight },
+      render_{ std::move(render) },
+      packets_(frames_in_flight < 1 ? 1 : frames_in_flight)
+  {
+    start();
+  }
+
+  ~RenderThread()
+  {
+    stop();
+  }
+
+  // The packet for the next frame, holding whatever was written to it frames_in_flight
+  // frames ago
+  Packet& beginFrame()
+  {
+    return packets_[acquireSlot()];
+  }
+
+  // Hands the packet from beginFrame() to the render thread
+  void submit()
+  {
+    submitSlot();
+  }
+
+private:
+  void render(std::size_t slot) override
+  {
+    render_(packets_[slot]);
+  }
+
+  Render render_;
+  std::vector<Packet> packets_;
+};
+
+}
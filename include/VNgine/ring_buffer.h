@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+/*
+ * Fixed-capacity lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * Indices grow monotonically and are masked on access, so full and empty are told apart
+ * without wasting a slot. Each side keeps a cached copy of the other side's index and only
+ * reloads it when the cached value says the queue is full (or empty), which keeps the two
+ * cache lines from bouncing on every operation.
+ */
+template <typename T, std::size_t Capacity>
+class SpscRingBuffer : non_copyable<SpscRingBuffer<T, Capacity>>
+{
+  static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+  static_assert(std::is_trivially_copyable_v<T>, "Items are copied in and out of the buffer.");
+public:
+  static constexpr std::size_t capacity = Capacity;
+
+  SpscRingBuffer() = default;
+
+  // Producer only. Returns false, leaving the buffer untouched, when it is full.
+  bool push(T const& item)
+  {
+    std::size_t const tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ == Capacity)
+    {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ == Capacity)
+      {
+        return false;
+      }
+    }
+    items_[tail & (Capacity - 1)] = item;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only. Returns false when the buffer is empty.
+  bool pop(T& item)
+  {
+    std::size_t const head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_)
+    {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_)
+      {
+        return false;
+      }
+    }
+    item = items_[head & (Capacity - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only. Hands every item available right now to `function` in order, then
+  // releases them all with a single store. Returns the number of items consumed.
+  template <typename Function>
+  std::size_t consume(Function&& function)
+  {
+    std::size_t const head = head_.load(std::memory_order_relaxed);
+    tail_cache_ = tail_.load(std::memory_order_acquire);
+    for (std::size_t index = head; index != tail_cache_; ++index)
+    {
+      function(items_[index & (Capacity - 1)]);
+    }
+    head_.store(tail_cache_, std::memory_order_release);
+    return tail_cache_ - head;
+  }
+
+  // Approximate when called while the other side is running
+  std::size_t size() const
+  {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+private:
+  // Consumer side
+  alignas(64) std::atomic<std::size_t> head_{ 0 };
+  std::size_t tail_cache_ = 0;
+  // Producer side
+  alignas(64) std::atomic<std::size_t> tail_{ 0 };
+  std::size_t head_cache_ = 0;
+
+  alignas(64) std::array<T, Capacity> items_;
+};
+
+/*
+ * Fixed-capacity lock-free queue for any number of producer threads and one consumer.
+ *
+ * Producers claim a slot by advancing the tail with a compare-and-swap, then publish the
+ * item through the slot's sequence number, after D. Vyukov's bounded MPMC queue. The
+ * consumer reads the sequence alone to tell a published slot from an empty one or one a
+ * producer is still writing, so it never touches the contended tail.
+ */
+template <typename T, std::size_t Capacity>
+class MpscRingBuffer : non_copyable<MpscRingBuffer<T, Capacity>>
+{
+  static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+  static_assert(std::is_trivially_copyable_v<T>, "Items are copied in and out of the buffer.");
+public:
+  static constexpr std::size_t capacity = Capacity;
+
+  MpscRingBuffer()
+  {
+    for (std::size_t i = 0; i < Capacity; ++i)
+    {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Any thread. Returns false, leaving the buffer untouched, when it is full.
+  bool push(T const& item)
+  {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      Cell& cell = cells_[tail & (Capacity - 1)];
+      std::size_t const sequence = cell.sequence.load(std::memory_order_acquire);
+      std::intptr_t const difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(tail);
+      if (difference == 0)
+      {
+        if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+        {
+          cell.item = item;
+          cell.sequence.store(tail + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (difference < 0)
+      {
+        // The consumer has not released this slot from the previous lap yet
+        return false;
+      }
+      else
+      {
+        tail = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Consumer only. Returns false when the buffer is empty, or the oldest item is still
+  // being written.
+  bool pop(T& item)
+  {
+    std::size_t const head = head_.load(std::memory_order_relaxed);
+    Cell& cell = cells_[head & (Capacity - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+    {
+      return false;
+    }
+    item = cell.item;
+    cell.sequence.store(head + Capacity, std::memory_order_release);
+    head_.store(head + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Approximate when called while other threads are running
+  std::size_t size() const
+  {
+    std::size_t const head = head_.load(std::memory_order_relaxed);
+    std::size_t const tail = tail_.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+  }
+
+private:
+  struct Cell
+  {
+    std::atomic<std::size_t> sequence;
+    T item;
+  };
+
+  // Producers' side
+  alignas(64) std::atomic<std::size_t> tail_{ 0 };
+  // Consumer's side
+  alignas(64) std::atomic<std::size_t> head_{ 0 };
+
+  alignas(64) std::array<Cell, Capacity> cells_;
+};
+
+}
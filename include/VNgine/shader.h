@@ -1,14 +1,32 @@
 #pragma once
 
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <vector>
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
+#include <VNgine/file_watcher.h>
+#include <VNgine/program_cache.h>
+#include <VNgine/shader_table.h>
+#include <VNgine/uniform.h>
+#include <VNgine/uniform_buffer.h>
+
 namespace VNgine
 {
 
+// Compiles and links are issued without waiting; the result is fetched on first demand
+enum class BuildStatus
+{
+  PENDING,
+  SUCCEEDED,
+  FAILED
+};
+
 class Shader
 {
 public:
@@ -24,36 +42,140 @@ public:
 
   std::string_view getName() const;
   Type getType() const;
+  // Issues the compile on first use if the pool did not already
   GLuint getID() const;
+  std::uint64_t getSourceHash() const;
+  // Bumped each time hot reload replaces the compiled shader
+  std::uint32_t getVersion() const;
+
+  // True once the driver is done compiling. Never blocks when parallel shader compilation
+  // is supported; otherwise the driver compiles synchronously and this is always true.
+  bool isReady() const;
+  // Waits for compilation to finish and reports the info log if it failed
+  bool isCompiled() const;
 
 private:
+  friend class ShaderPool;
+
   std::string name_;
   Type type_ = Type::INVALID;
-  GLuint id_ = std::numeric_limits<GLuint>::max();
+  std::string source_;
+  std::uint64_t source_hash_;
+  mutable GLuint id_ = std::numeric_limits<GLuint>::max();
+  mutable BuildStatus status_ = BuildStatus::PENDING;
+  std::uint32_t version_ = 0;
 
-  Shader(std::string_view name, Type type, char const* source);
+  Shader(std::string_view name, Type type, std::string_view source);
+  bool isCompileIssued() const;
+  // Compiles `source` and swaps it in, keeping the current shader if it fails to compile
+  bool reload(std::string_view source);
 };
 
 class ShaderPool
 {
 public:
-  ShaderPool(std::string_view directory);
-  Shader const& getVS(std::string_view name) const;
-  Shader const& getFS(std::string_view name) const;
+  // With a program cache, shaders are only compiled for programs that miss it; without one,
+  // every compile is issued up front
+  ShaderPool(std::string_view directory, ProgramCache* cache = nullptr);
+  // Resolve names to handles once and keep the handles; returns nothing if the shader is missing
+  std::optional<ShaderHandle> find(ShaderName name, Shader::Type type) const;
+  Shader const& get(ShaderHandle handle) const;
+  // True once every shader compile issued so far has finished
+  bool isReady() const;
+  ProgramCache* getProgramCache() const;
+
+  // Starts watching the directory for edited shaders; false if it cannot be watched
+  bool watch();
+  // Recompiles shaders whose files changed since the last call and returns how many were
+  // replaced. Costs one non-blocking read while nothing changes. Call between frames.
+  std::size_t update();
+  // Bumped by every update() that replaced or added a shader
+  std::uint64_t getGeneration() const;
 private:
+  Shader const& add(std::string_view name, Shader::Type type, std::string_view source);
+
+  std::string directory_;
   std::vector<Shader> entries_;
+  ShaderTable table_;
+  ProgramCache* cache_;
+  std::unique_ptr<FileWatcher> watcher_;
+  std::uint64_t generation_ = 0;
 };
 
 class ShaderProgram
 {
 public:
-  ShaderProgram(ShaderPool const& pool, std::string_view vs_name, std::string_view fs_name);
+  ShaderProgram(ShaderPool const& pool, ShaderName vs_name, ShaderName fs_name);
+  ShaderProgram(ShaderPool const& pool, ShaderHandle vs, ShaderHandle fs);
   ~ShaderProgram();
+  // Same as Shader::isReady(), for linking. Render with the program once this is true to
+  // avoid stalling the frame on a link still in progress.
+  bool isReady() const;
+  // Waits for linking to finish and reports the info log if it failed
+  bool isLinked() const;
+  // Relinks if the pool reloaded one of this program's shaders, swapping the new program in
+  // only if it links. Returns true when the GL program changed, in which case uniform
+  // locations must be looked up again. Call between frames, after ShaderPool::update().
+  bool update();
   void use() const;
-  GLint getUniformLocation(std::string_view name) const;
-  void setUniform(GLint location, glm::mat4 const& matrix) const;
+
+  // Resolved from the table reflected at link time; -1 if the program has no such uniform.
+  // Look locations up once and keep them, since each lookup is a hashed search.
+  GLint getUniformLocation(UniformName name) const;
+  // The program must be in use. Values equal to what the program already holds are not sent.
+  template <typename T>
+  void setUniform(GLint location, T const& value) const;
+  // Sets `count` elements of an array uniform, starting with the element at `location`
+  template <typename T>
+  void setUniform(GLint location, T const* values, std::size_t count) const;
+  void setUniform(GLint location, bool value) const;
+  // Points the named `layout (std140) uniform` block at `buffer`, again after every relink
+  void bindUniformBlock(UniformName block, UniformBufferBase const& buffer);
+  UniformTable const& getUniforms() const;
 private:
+  struct BlockBinding
+  {
+    std::string name;
+    GLuint binding;
+    std::size_t size;
+  };
+
+  void link(Shader const& vs, Shader const& fs, ProgramCache* cache);
+  // Fetches the link status, reporting failures and storing successes in the cache
+  bool checkLink() const;
+  // Fills the uniform table and applies block bindings once the program has linked
+  void reflect() const;
+  void applyBlockBinding(BlockBinding const& binding) const;
+
   GLuint id_;
+  ShaderPool const* pool_ = nullptr;
+  ShaderHandle vs_{};
+  ShaderHandle fs_{};
+  std::uint32_t vs_version_ = 0;
+  std::uint32_t fs_version_ = 0;
+  std::uint64_t pool_generation_ = 0;
+  std::string label_;
+  mutable BuildStatus status_ = BuildStatus::PENDING;
+  // Set while a freshly linked binary still has to be written to the cache
+  mutable ProgramCache* pending_store_ = nullptr;
+  std::uint64_t cache_key_ = 0;
+  mutable UniformTable uniforms_;
+  std::vector<BlockBinding> block_bindings_;
 };
 
-}
\ No newline at end of file
+template <typename T>
+void ShaderProgram::setUniform(GLint location, T const& value) const
+{
+  setUniform(location, &value, 1);
+}
+
+template <typename T>
+void ShaderProgram::setUniform(GLint location, T const* values, std::size_t count) const
+{
+  if (uniforms_.update(location, values, count))
+  {
+    UniformTraits<T>::upload(location, static_cast<GLsizei>(count), values);
+  }
+}
+
+}
\ No newline at end of file
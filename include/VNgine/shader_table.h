@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+using ShaderName = hashed_name;
+
+// Resolved position of a shader in its pool; stays valid for the life of the pool
+struct ShaderHandle
+{
+  std::uint32_t index;
+};
+
+/*
+ * Open-addressing map from (name, shader type) to a ShaderHandle.
+ *
+ * Slots hold the full hash next to the key, so a probe only touches the name string once the
+ * hash and type already match. Linear probing over a power-of-two table kept at most half full.
+ */
+class ShaderTable
+{
+public:
+  void reserve(std::size_t count);
+  // Returns false, leaving the existing entry, if the key is already present
+  bool insert(ShaderName name, int type, ShaderHandle handle);
+  std::optional<ShaderHandle> find(ShaderName name, int type) const;
+  std::size_t size() const;
+
+private:
+  struct Slot
+  {
+    std::uint64_t hash = 0;
+    int type = 0;
+    std::uint32_t index = empty;
+    std::string name;
+  };
+  static constexpr std::uint32_t empty = 0xFFFFFFFF;
+
+  std::size_t probe(ShaderName name, int type) const;
+  void rehash(std::size_t capacity);
+
+  std::vector<Slot> slots_;
+  std::size_t size_ = 0;
+};
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <VNgine/helper.h>
+#include <VNgine/stream_buffer.h>
+
+namespace VNgine
+{
+
+class ShaderProgram;
+
+// Per-instance vertex data, read by sprite.vs at the attribute locations below
+struct SpriteInstance
+{
+  glm::mat4 transform;
+  glm::vec4 color;
+  glm::vec4 uv_rect;    // offset in xy, size in zw, in texture coordinates
+};
+static_assert(std::is_trivially_copyable_v<SpriteInstance>);
+
+/*
+ * Collects sprites for a frame and draws them as instanced quads, one draw call per run
+ * of sprites sharing a layer, program and texture. Instances stream through a StreamBuffer,
+ * so call begin() and end() once per frame.
+ *
+ *   batch.begin();
+ *   batch.draw(program, texture, transform);   // any number of times
+ *   batch.end();                                // sorts, uploads and draws
+ *
+ * Sprites are sorted by layer first, so lower layers always end up underneath, then by
+ * program and texture. Submission order is kept only within one program and texture run:
+ * same-layer sprites with different programs or textures may be reordered, so translucent
+ * sprites that overlap need distinct layers to blend in a fixed order.
+ *
+ * The quad is a unit square centred on the origin, with texture coordinates at location 1
+ * and the instance transform, color and UV rect at locations 2-5, 6 and 7. Texture 0
+ * binds a 1x1 white texture, so untextured sprites are just their color.
+ */
+class SpriteBatch : non_copyable<SpriteBatch>
+{
+public:
+  struct Stats
+  {
+    std::size_t sprites;
+    std::size_t draw_calls;
+  };
+
+  // Vertex attribute locations shared with the sprite shaders
+  static constexpr GLuint position_location = 0;
+  static constexpr GLuint uv_location = 1;
+  static constexpr GLuint transform_location = 2;
+  static constexpr GLuint color_location = 6;
+  static constexpr GLuint uv_rect_location = 7;
+
+  // Each frame's instance region starts with room for `capacity` sprites and grows when a
+  // frame needs more
+  explicit SpriteBatch(std::size_t capacity = 4096);
+  ~SpriteBatch();
+
+  void begin();
+  void draw(ShaderProgram const& program, GLuint texture, glm::mat4 const& transform,
+            glm::vec4 const& color = glm::vec4{ 1.0f }, glm::vec4 const& uv_rect = { 0.0f, 0.0f, 1.0f, 1.0f },
+            std::uint8_t layer = 0);
+  // Draws everything submitted since begin()
+  void end();
+
+  // Counts for the most recent end()
+  Stats const& stats() const;
+  StreamBuffer::Stats const& streamStats() const;
+
+private:
+  // Layer, program slot, texture and submission index, most significant first
+  static constexpr unsigned index_bits = 24;
+  static constexpr unsigned texture_bits = 24;
+  static constexpr unsigned program_bits = 8;
+
+  std::uint64_t makeKey(ShaderProgram const& program, GLuint texture, std::uint8_t layer);
+  void pointInstanceAttributes(std::size_t first_instance) const;
+
+  GLuint vao_ = 0;
+  GLuint quad_vbo_ = 0;
+  GLuint quad_ebo_ = 0;
+  GLuint white_texture_ = 0;
+  std::size_t capacity_;
+  std::unique_ptr<StreamBuffer> instance_stream_;
+  bool base_instance_;
+
+  std::vector<SpriteInstance> instances_;
+  std::vector<std::uint64_t> keys_;
+  std::vector<ShaderProgram const*> programs_;  // indexed by program slot, this frame
+  Stats stats_{};
+};
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+/*
+ * GPU buffer for data rewritten every frame: sprite instances, text quads, UI vertices.
+ *
+ * The buffer is split into `region_count` regions (three by default) and each frame
+ * writes into the next one, so the CPU fills one region while the GPU still reads the
+ * previous frames'. With ARB_buffer_storage the whole buffer is mapped once, persistently
+ * and coherently, and a fence per region guards against overwriting data in flight;
+ * waiting on one of those fences is counted as a stall. Without it, every frame orphans
+ * the buffer and maps the ranges it writes unsynchronized, leaving the driver to keep the
+ * old storage alive.
+ *
+ *   auto const allocation = stream.map(bytes, alignment);
+ *   write to allocation.data, draw from allocation.offset
+ *   stream.unmap();
+ *   ...
+ *   stream.endFrame();     // after the frame's last draw from this buffer
+ */
+class StreamBuffer : non_copyable<StreamBuffer>
+{
+public:
+  enum class Strategy
+  {
+    PERSISTENT,
+    ORPHAN
+  };
+
+  struct Allocation
+  {
+    void* data;           // null if the request did not fit in what is left of the region
+    std::size_t offset;   // byte offset into the buffer, for attribute pointers and binds
+  };
+
+  struct Stats
+  {
+    std::size_t frames;
+    std::size_t bytes_written;
+    std::size_t stalls;         // frames that waited for the GPU to release their region
+    std::uint64_t stall_ns;
+    std::size_t overflows;      // map() requests refused for lack of room
+  };
+
+  // Persistent mapping when the driver supports it
+  static Strategy defaultStrategy();
+
+  StreamBuffer(GLenum target, std::size_t region_size, std::size_t region_count = 3,
+               Strategy strategy = defaultStrategy());
+  ~StreamBuffer();
+
+  // Reserves `size` bytes at an offset that is a multiple of `alignment` (which need not be
+  // a power of two, so it can be a vertex stride). Binds the buffer to its target.
+  Allocation map(std::size_t size, std::size_t alignment = 16);
+  // Ends the write started by the last map()
+  void unmap();
+  // Fences the region written this frame and moves on to the next
+  void endFrame();
+
+  GLuint getID() const;
+  GLenum getTarget() const;
+  std::size_t getRegionSize() const;
+  Strategy getStrategy() const;
+  Stats const& stats() const;
+
+private:
+  // Waits, if need be, until the GPU is done with the current region
+  void acquireRegion();
+
+  GLuint id_ = 0;
+  GLenum target_;
+  std::size_t region_size_;
+  std::size_t region_count_;
+  Strategy strategy_;
+  std::byte* persistent_ = nullptr;
+  std::vector<GLsync> fences_;
+  std::size_t region_ = 0;
+  std::size_t used_ = 0;        // bytes handed out from the current region
+  bool acquired_ = false;
+  bool mapped_ = false;
+  Stats stats_{};
+};
+
+}
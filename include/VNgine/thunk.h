@@ -1,236 +1,463 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cassert>
-#include <mutex>
-#include <iostream>
-
-#define WIN32_LEAN_AND_MEAN
-#define NOMINMAX
-#include <Windows.h>
-#include <intrin.h>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <GLFW/glfw3.h>
 
 #include <VNgine/helper.h>
+#include <VNgine/trampoline.h>
+
+#if !defined(_WIN64) && !defined(__x86_64__) && !defined(VNGINE_STATIC_THUNKS)
+#error "JIT thunks are only implemented for x86-64; configure with VNGINE_STATIC_THUNKS=ON."
+#endif
 
 namespace VNgine
 {
 
+namespace detail
+{
+
+// Machine code for one thunk signature, with two 8-byte slots left to patch per instance
+struct BytecodeImage
+{
+  std::uint8_t const* bytes;
+  std::size_t size;
+  std::size_t this_offset;
+  std::size_t function_offset;
+};
+
+}
+
+/*
+ * Executable memory for thunks, carved out of page-sized slabs.
+ *
+ * Each slab holds fixed-size slots of one size class, so a thunk is one slot and the
+ * slot's address alone identifies its slab. Freed slots are recycled through lock-free
+ * per-class free lists whose links live outside the executable pages; only committing a
+ * new slab takes a lock.
+ *
+ * The slabs are mapped twice, at different addresses: thunks are written through a
+ * read+write view and run from a read+execute one, so no page is both writable and
+ * executable, and creating a thunk never changes the protection of pages that other
+ * thunks, maybe mid-call on another thread, are running from.
+ */
 class ThunkHeap : non_copyable<ThunkHeap>
 {
+public:
+  struct Stats
+  {
+    std::size_t live_thunks;
+    std::size_t slabs;
+    std::size_t committed_bytes;              // executable memory backing all slabs
+    std::size_t live_bytes;                   // bytes taken by the slots of live thunks
+    double fragmentation;                     // share of committed memory not holding a live thunk
+  };
+  static Stats stats();
+
+  // While a batch is alive, the instruction cache is flushed once per slab written on this
+  // thread when it ends, instead of once per thunk. Thunks created inside a batch must not
+  // be called before the batch is destroyed.
+  class Batch : non_copyable<Batch>
+  {
+  public:
+    Batch();
+    ~Batch();
+  private:
+    friend class ThunkHeap;
+    Batch* outer_;
+    std::vector<std::uint32_t> written_slabs_;
+  };
+
 protected:
   ThunkHeap();
-  void* alloc(std::size_t size);
+  // Copies a bytecode image into an executable slot, patches in the instance and
+  // function pointers, and returns where it was placed
+  void* emplace(detail::BytecodeImage const& image, void* instance, void* function);
   void dealloc(void* mem);
-private:
-  static void* volatile bytecode_heap;
-  static std::mutex heap_mutex;
-  static void __cdecl cleanup();
 };
 
-template<typename... Args>
-class ThunkBase : ThunkHeap
+namespace detail
 {
-protected:
-  static constexpr auto ArgCount = sizeof...(Args);
 
-  template <std::size_t N>
-  using ArgType = std::tuple_element_t<N, std::tuple<Args...>>;
+// Resolves a pointer to member function into the address of the code it calls
+// and the `this` pointer that code expects, so a thunk can call it directly.
+template <typename T, typename Method>
+std::pair<void*, void*> resolve_method(T* instance, Method method)
+{
+#ifdef _MSC_VER
+  // MSVC represents single-inheritance method pointers as a plain code pointer.
+  // It may actually be a pointer to a vcall thunk but it will still work.
+  return { instance, brute_cast<void*>(method) };
+#else
+  // Itanium C++ ABI: { ptr, adj }. `adj` is added to `this`, and if `ptr` is odd
+  // the method is virtual and (ptr - 1) is its byte offset into the vtable.
+  struct ItaniumMethod
+  {
+    std::uintptr_t ptr;
+    std::ptrdiff_t adj;
+  };
+  auto const parts = brute_cast<ItaniumMethod>(method);
+  char* const self = reinterpret_cast<char*>(instance) + parts.adj;
+  if (parts.ptr & 1)
+  {
+    char const* const vtable = *reinterpret_cast<char* const*>(self);
+    return { self, *reinterpret_cast<void* const*>(vtable + parts.ptr - 1) };
+  }
+  return { self, reinterpret_cast<void*>(parts.ptr) };
+#endif
+}
 
-  ThunkBase(void* instance, void* function)
+enum Reg : std::uint8_t
+{
+  RAX = 0, RCX = 1, RDX = 2, RSP = 4, RSI = 6, RDI = 7, R8 = 8, R9 = 9
+};
+
+/*
+ * Compile-time x86-64 encoder covering only the instructions thunks emit.
+ * The two 64-bit immediates are emitted as zero and their offsets recorded for patching.
+ */
+template <std::size_t Capacity>
+struct Assembler
+{
+  std::array<std::uint8_t, Capacity> bytes{};
+  std::size_t size = 0;
+  std::size_t this_offset = 0;
+  std::size_t function_offset = 0;
+
+  constexpr void byte(std::uint8_t b)
   {
-    // Grab the bytecode-sized chunk of executable memory from the heap
-    bytecode_ = static_cast<Bytecode*>(alloc(sizeof(Bytecode)));
-    if (!bytecode_)
+    bytes[size++] = b;
+  }
+  constexpr void u32(std::uint32_t v)
+  {
+    for (int i = 0; i < 4; ++i)
     {
-      assert(!"Failed to allocate bytecode on heap.");
+      byte(std::uint8_t(v >> (8 * i)));
     }
-    // Use placement new to construct the bytecode in the allocated executable heap memory
-    new (bytecode_) Bytecode{ instance, function };
-    std::cout << sizeof(Bytecode) << " bytes of machine code\n";
   }
 
-  ~ThunkBase()
+  // mov dst, src
+  constexpr void mov(Reg dst, Reg src)
   {
-    // Explicitly call dtor because it was allocated with placement new
-    bytecode_->~Bytecode();
-    // Release the executable memory it was placed in
-    dealloc(bytecode_);
+    byte(rex(src, dst)); byte(0x89); byte(std::uint8_t(0xC0 | ((src & 7) << 3) | (dst & 7)));
   }
-
-  struct Bytecode_StackCopy
+  // movaps dst, src (xmm0-7)
+  constexpr void movaps(std::uint8_t dst, std::uint8_t src)
   {
-#pragma pack(push, 1)
-    std::uint8_t mov_r10_rsi[3];              // store original RSI and RDI, calling convention says they are nonvolatile
-    std::uint8_t mov_r11_rdi[3];
-
-    // Let n = (argc - 4), the number of spilled arguments.
-    // Copy $n QWORDs from [rsp + 40] to [rsp - ($n * 8)]
-    // This will copy all previously spilled arguments to below the new shadow space
-    std::uint8_t mov_rsi_rsp[3];              // SRC = rsp + 40
-    std::uint8_t add_rsi_40[4];
-    std::uint8_t mov_rdi_rsp[3];              // DST = rsp - (n * 8)
-    std::uint8_t add_rdi[3];
-    std::uint32_t rsp_copy_offset;
-    std::uint8_t mov_rcx_N[3];                // N = n
-    std::uint32_t N;
-    std::uint8_t rep_movsq[3];                // memcpy(SRC, DST, N)
-
-    std::uint8_t mov_rsi_r10[3];              // restore original RSI and RDI
-    std::uint8_t mov_rdi_r11[3];
-#pragma pack(pop)
-    Bytecode_StackCopy(uint32_t spilled_args);
-  };
+    byte(0x0F); byte(0x28); byte(std::uint8_t(0xC0 | (dst << 3) | src));
+  }
+  // mov qword ptr [rsp + offset], src
+  constexpr void store(std::uint32_t offset, Reg src)
+  {
+    byte(rex(src, RSP)); byte(0x89); byte(std::uint8_t(0x84 | ((src & 7) << 3))); byte(0x24); u32(offset);
+  }
+  // movsd qword ptr [rsp + offset], src (xmm0-7)
+  constexpr void store_sse(std::uint32_t offset, std::uint8_t src)
+  {
+    byte(0xF2); byte(0x0F); byte(0x11); byte(std::uint8_t(0x84 | (src << 3))); byte(0x24); u32(offset);
+  }
+  // mov dst, qword ptr [rsp + offset]
+  constexpr void load(Reg dst, std::uint32_t offset)
+  {
+    byte(rex(dst, RSP)); byte(0x8B); byte(std::uint8_t(0x84 | ((dst & 7) << 3))); byte(0x24); u32(offset);
+  }
+  // mov dst, imm64, returning where the immediate goes
+  constexpr std::size_t mov_imm(Reg dst)
+  {
+    byte(std::uint8_t(0x48 | (dst >> 3))); byte(std::uint8_t(0xB8 | (dst & 7)));
+    std::size_t const offset = size;
+    u32(0); u32(0);
+    return offset;
+  }
+  constexpr void sub_rsp(std::uint32_t v) { byte(0x48); byte(0x81); byte(0xEC); u32(v); }
+  constexpr void add_rsp(std::uint32_t v) { byte(0x48); byte(0x81); byte(0xC4); u32(v); }
+  constexpr void call_rax() { byte(0xFF); byte(0xD0); }
+  constexpr void jmp_rax() { byte(0xFF); byte(0xE0); }
+  constexpr void ret() { byte(0xC3); }
+  // int3 padding in case something goes wrong
+  constexpr void trap() { byte(0xCC); byte(0xCC); byte(0xCC); }
+
+  // REX.W prefix, extending ModRM.reg and ModRM.rm for r8-r15
+  static constexpr std::uint8_t rex(Reg reg, Reg rm)
+  {
+    return std::uint8_t(0x48 | ((reg >> 3) << 2) | (rm >> 3));
+  }
+};
+
+template <typename T>
+constexpr bool is_integer_arg_v = std::is_integral_v<T> || std::is_enum_v<T>
+                               || std::is_pointer_v<T> || std::is_reference_v<T>;
+template <typename T>
+constexpr bool is_sse_arg_v = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template <typename... Args>
+struct ThunkSignature
+{
+  static_assert(((is_integer_arg_v<Args> || is_sse_arg_v<Args>) && ...),
+    "Thunk arguments must be scalars passed in a single register.");
+
+  static constexpr std::size_t ArgCount = sizeof...(Args);
+  static constexpr std::array<bool, ArgCount> is_sse{ is_sse_arg_v<Args>... };
+  // Generous upper bound on the generated size, used as assembler capacity
+  static constexpr std::size_t MaxSize = 64 + 16 * ArgCount;
+};
+
+/*
+ * System V AMD64 code generator.
+ *
+ * Integer-class arguments arrive in RDI, RSI, RDX, RCX, R8, R9 and floating point ones in XMM0-7,
+ * with the rest on the stack in parameter order. The member function expects `this` in RDI, so
+ * every integer argument moves one register up; XMM arguments are unaffected.
+ *
+ * While at most five integer arguments are passed, everything still fits in registers and the
+ * thunk ends in a tail jump: the stack, including the caller's return address, is left untouched.
+ * With six or more, the value arriving in R9 becomes a stack argument, so the thunk builds a new
+ * argument area below the return address and calls. It only ever writes above RSP after moving
+ * it, so no red zone is used; the callee is free to use its own.
+ */
+template <typename... Args>
+struct SysVCodegen : ThunkSignature<Args...>
+{
+  using Signature = ThunkSignature<Args...>;
 
-  struct Bytecode_ShiftArgs
+  template <std::size_t Capacity>
+  static constexpr Assembler<Capacity> assemble()
   {
-    using u8_3 = std::uint8_t[3];
-    using u8_list = std::initializer_list<std::uint8_t>;
-#pragma pack (push, 1)
-    std::enable_if_t<(ArgCount >= 3), u8_3> shift_arg3;
-    std::enable_if_t<(ArgCount >= 2), u8_3> shift_arg2;
-    std::enable_if_t<(ArgCount >= 1), u8_3> shift_arg1;
-#pragma pack (pop)
-    Bytecode_ShiftArgs()
+    constexpr Reg int_regs[] = { RDI, RSI, RDX, RCX, R8, R9 };
+
+    // Where each outgoing stack argument comes from: the incoming stack slot index, or -1 for R9
+    std::array<int, Signature::ArgCount + 1> stack_sources{};
+    std::size_t stack_count = 0;
+    std::size_t int_count = 0;
+    std::size_t sse_count = 0;
+    int incoming_slot = 0;
+    for (std::size_t i = 0; i < Signature::ArgCount; ++i)
     {
-      if constexpr (ArgCount >= 1)
+      bool const sse = Signature::is_sse[i];
+      if (sse ? (sse_count++ >= 8) : (int_count++ >= 6))
       {
-        auto const list = (std::is_floating_point_v < ArgType<0>>) ?
-        (u8_list{ 0x0F, 0x28, 0xC8 }) :   // movaps xmm1, xmm0
-        (u8_list{ 0x48, 0x89, 0xC2 });    // mov rdx, rax
-
-        std::copy(list.begin(), list.end(), shift_arg1);
+        stack_sources[stack_count++] = incoming_slot++;
       }
-
-      if constexpr (ArgCount >= 2)
+      else if (!sse && int_count == 6)
       {
-        auto const list = (std::is_floating_point_v<ArgType<1>>) ?
-          (u8_list{ 0x0F, 0x28, 0xD1 }) :   // movaps xmm2, xmm1
-          (u8_list{ 0x49, 0x89, 0xD0 });    // mov r8, rdx
-
-        std::copy(list.begin(), list.end(), shift_arg2);
+        stack_sources[stack_count++] = -1;
       }
+    }
+    bool const spills_r9 = int_count >= 6;
+    std::size_t const shifted = std::min<std::size_t>(int_count, 5);
 
-      if constexpr (ArgCount >= 3)
-      {
-        auto const list = (std::is_floating_point_v<ArgType<2>>) ?
-          (u8_list{ 0x0F, 0x28, 0xDA }) :   // movaps xmm3, xmm2
-          (u8_list{ 0x4D, 0x89, 0xC1 });    // mov r8, rdx
+    Assembler<Capacity> code{};
+    std::uint32_t frame = 0;
+    if (spills_r9)
+    {
+      // Entry RSP is 8 mod 16 because of the return address; keep the call 16-byte aligned
+      frame = std::uint32_t(stack_count * 8);
+      frame += (frame % 16 == 0) ? 8 : 0;
 
-        std::copy(list.begin(), list.end(), shift_arg3);
+      code.sub_rsp(frame);
+      for (std::size_t j = 0; j < stack_count; ++j)
+      {
+        auto const out_offset = std::uint32_t(j * 8);
+        if (stack_sources[j] < 0)
+        {
+          code.store(out_offset, R9);
+        }
+        else
+        {
+          // Skip the new frame and the return address to reach the caller's stack arguments
+          code.load(RAX, frame + 8 + std::uint32_t(stack_sources[j]) * 8);
+          code.store(out_offset, RAX);
+        }
       }
     }
-  };
 
-  struct Bytecode
-  {
-    constexpr static uint32_t spilled_args = std::max(ArgCount - 4, {0});
-#pragma pack(push, 1)
-    std::uint8_t mov_rax_rcx[3];              // store RCX value for later; RCX is needed for copy operation
+    // Shift from the highest register down so nothing is overwritten before it is read
+    for (std::size_t i = shifted; i-- > 0;)
+    {
+      code.mov(int_regs[i + 1], int_regs[i]);
+    }
 
-    std::enable_if_t<(spilled_args > 0), Bytecode_StackCopy> stack_copy;
+    code.this_offset = code.mov_imm(RDI);
+    code.function_offset = code.mov_imm(RAX);
 
-    std::uint8_t mov_qword_ptr_rsp_r9[4];     // spill the argument from R9 onto the stack
-    std::uint32_t spill_offset;
+    if (spills_r9)
+    {
+      code.call_rax();
+      code.add_rsp(frame);
+      code.ret();
+    }
+    else
+    {
+      code.jmp_rax();
+    }
+    code.trap();
+    return code;
+  }
+};
 
-    std::uint8_t sub_rsp[3];                  // create the shadow space for the member callback, plus argument space
-    std::uint32_t rsp_grow_offset;            // (32 for shadow space + 8 for spilled arg from r9 + 8 for each arg past 4)
+/*
+ * Win64 code generator.
+ *
+ * Arguments are assigned by position: the first four go in RCX/XMM0, RDX/XMM1, R8/XMM2 and
+ * R9/XMM3, the rest on the stack above 32 bytes of caller-allocated shadow space. `this` takes
+ * position 0, so every argument moves one position along.
+ *
+ * With up to three arguments this is a register shuffle and a tail jump; the caller's shadow
+ * space is reused by the callee. With four or more, the fourth becomes a stack argument, so the
+ * thunk allocates shadow space plus the shifted stack arguments, keeping RSP 16-byte aligned
+ * at the call, and calls.
+ */
+template <typename... Args>
+struct Win64Codegen : ThunkSignature<Args...>
+{
+  using Signature = ThunkSignature<Args...>;
 
-    Bytecode_ShiftArgs shift_args;
+  template <std::size_t Capacity>
+  static constexpr Assembler<Capacity> assemble()
+  {
+    constexpr Reg int_regs[] = { RCX, RDX, R8, R9 };
+    constexpr std::size_t n = Signature::ArgCount;
 
-    std::uint8_t mov_rcx[2];                  // store the `this` ptr in RCX
-    void* this_ptr;
+    Assembler<Capacity> code{};
+    std::uint32_t frame = 0;
+    if (n >= 4)
+    {
+      // Shadow space plus stack arguments from position 4 on; entry RSP is 8 mod 16
+      frame = std::uint32_t(32 + 8 * (n - 3));
+      frame += (frame % 16 == 0) ? 8 : 0;
 
-    std::uint8_t mov_rax[2];                  // store the pointer to member function in RAX
-    void* function;                           // it may actually be a pointer to vtable but it will still work
+      code.sub_rsp(frame);
+      // The argument at position p (>= 4) moves from [entry rsp + 8 + 8p] to [callee rsp + 8 + 8(p + 1)]
+      for (std::size_t p = n; p-- > 4;)
+      {
+        code.load(RAX, frame + 8 + std::uint32_t(p * 8));
+        code.store(std::uint32_t((p + 1) * 8), RAX);
+      }
+      // The fourth argument moves from R9/XMM3 to the first stack slot after the shadow space
+      if (Signature::is_sse[3])
+      {
+        code.store_sse(32, 3);
+      }
+      else
+      {
+        code.store(32, R9);
+      }
+    }
+
+    for (std::size_t p = std::min<std::size_t>(n, 3); p-- > 0;)
+    {
+      if (Signature::is_sse[p])
+      {
+        code.movaps(std::uint8_t(p + 1), std::uint8_t(p));
+      }
+      else
+      {
+        code.mov(int_regs[p + 1], int_regs[p]);
+      }
+    }
 
-    std::uint8_t call_rax[2];                 // execute the member function and allow it to return back here
-    std::uint8_t add_rsp_48[4];               // clean up the shadow space and the space for the spilled arguments
-                                              // (32 for shadow space + 8 for spilled arg from r9 + 8 for each arg past 4)
+    code.this_offset = code.mov_imm(RCX);
+    code.function_offset = code.mov_imm(RAX);
 
-    std::uint8_t ret[1];                      // return to whatever called the callback
+    if (n >= 4)
+    {
+      code.call_rax();
+      code.add_rsp(frame);
+      code.ret();
+    }
+    else
+    {
+      code.jmp_rax();
+    }
+    code.trap();
+    return code;
+  }
+};
 
-    std::uint8_t int_3[9];                    // just a bunch of interrupts to stop in case something goes wrong
-#pragma pack(pop)
-    Bytecode(void* instance, void* function);
-  };
+// The assembled machine code for a signature, trimmed to size and baked into the binary
+template <typename Codegen>
+struct BytecodeTemplate
+{
+private:
+  static constexpr auto assembled = Codegen::template assemble<Codegen::MaxSize>();
 
-  // Really don't want bytecode to be mutated by a derived class, hence the getter
-  Bytecode* getBytecode() const
+  template <std::size_t... I>
+  static constexpr std::array<std::uint8_t, sizeof...(I)> trim(std::index_sequence<I...>)
   {
-    return bytecode_;
+    return { assembled.bytes[I]... };
   }
 
-  void flushInstructionCache() const
+public:
+  static constexpr std::size_t size = assembled.size;
+  static constexpr std::size_t this_offset = assembled.this_offset;
+  static constexpr std::size_t function_offset = assembled.function_offset;
+  static constexpr std::array<std::uint8_t, size> bytes = trim(std::make_index_sequence<size>{});
+
+  static constexpr BytecodeImage image()
   {
-#ifdef _WIN64
-    // Flush instruction cache. May be required on some architectures which
-    // don't feature strong cache coherency guarantees, though not on neither
-    // x86, x64 nor AMD64.
-    FlushInstructionCache(GetCurrentProcess(), bytecode_, sizeof(Bytecode));
-#endif
+    return { bytes.data(), size, this_offset, function_offset };
   }
-
-private:
-  Bytecode* bytecode_;
 };
 
+#ifdef _WIN64
 template <typename... Args>
-ThunkBase<Args...>::Bytecode_StackCopy::Bytecode_StackCopy(uint32_t spilled_args)
-  : mov_r10_rsi{ 0x49, 0x89, 0xF2 },                             // mov r10, rsi
-    mov_r11_rdi{ 0x49, 0x89, 0xFB },                             // mov r11, rdi
-
-    mov_rsi_rsp{ 0x48, 0x89, 0xE6 },                             // mov rsi, rsp
-    add_rsi_40{ 0x48, 0x83, 0xC6, 0x28 },                        // add rsi, 40
-    mov_rdi_rsp{ 0x48, 0x89, 0xE7 },                             // mov rdi, rsp
-    add_rdi{ 0x48, 0x81, 0xC7 },                                 // add rdi, {-n * 8}
-    rsp_copy_offset{ (-(spilled_args * 8)) },
-    mov_rcx_N{ 0x48, 0xC7, 0xC1 },                               // mov rcx, {n}
-    N{ (spilled_args) },
-    rep_movsq{ 0xF3, 0x48, 0xA5 },                               // rep movsq
-
-    mov_rsi_r10{ 0x4C, 0x89, 0xD6 },                             // mov rsi, r10
-    mov_rdi_r11{ 0x4C, 0x89, 0xDF }                              // mov rdi, r11
-{}
-
+using NativeCodegen = Win64Codegen<Args...>;
+#else
 template <typename... Args>
-ThunkBase<Args...>::Bytecode::Bytecode(void* instance, void* function) :
-
-  /* Used https://defuse.ca/online-x86-assembler to translate into machine code */
-
-  mov_rax_rcx{ 0x48, 0x89, 0xC8 },                             // mov rax, rcx
-
-  stack_copy{spilled_args},
+using NativeCodegen = SysVCodegen<Args...>;
+#endif
 
-  mov_qword_ptr_rsp_r9{ 0x4C, 0x89, 0x8C, 0x24 },              // mov qword ptr[rsp - {8 * (n + 1)}], r9
-  spill_offset{ (-(8 * (spilled_args + 1))) },
+}
 
-  sub_rsp{ 0x48, 0x81, 0xEC },                                 // sub rsp, {32 + 8 + (n * 8)}
-  rsp_grow_offset{ (32 + 8 + (spilled_args * 8)) },
+template<typename... Args>
+class ThunkBase : ThunkHeap
+{
+protected:
+  static constexpr auto ArgCount = sizeof...(Args);
 
-  shift_args{},
+  using Bytecode = detail::BytecodeTemplate<detail::NativeCodegen<Args...>>;
 
-  mov_rcx{ 0x48, 0xB9 },                                       // mov rcx, this_ptr
-  this_ptr{ instance },
+  ThunkBase(void* instance, void* function)
+    // Copy the precomputed machine code into executable memory and patch in both pointers
+    : bytecode_{ emplace(Bytecode::image(), instance, function) }
+  {
+    if (!bytecode_)
+    {
+      assert(!"Failed to allocate bytecode on heap.");
+    }
+  }
 
-  mov_rax{ 0x48, 0xB8 },                                       // mov rax, function
-  function{ function },
+  ~ThunkBase()
+  {
+    // Release the executable memory the bytecode was placed in
+    dealloc(bytecode_);
+  }
 
-  call_rax{ 0xFF, 0xD0 },                                      // call rax
-  add_rsp_48{ 0x48, 0x83, 0xC4, 0x30 },                        // add rsp, 48
-  ret{ 0xC3 },                                                 // ret
+  // Really don't want bytecode to be mutated by a derived class, hence the getter
+  void* getBytecode() const
+  {
+    return bytecode_;
+  }
 
-  int_3{ 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC }// int3 int3 int3 ...
-{}
+private:
+  void* bytecode_;
+};
 
 // This incomplete template class is here to provide type deduction
 template<typename, typename>
-class Thunk;
+class JitThunk;
 
 // This is a specialization of the incomplete class,
 // which formats the template arguments as so to extract information from a function pointer type
 template<class T, typename Ret, typename... Args>
-class Thunk<T, Ret(*)(Args...)> : ThunkBase<Args...>
+class JitThunk<T, Ret(*)(Args...)> : ThunkBase<Args...>
 {
 public:
   constexpr static std::size_t ArgC = sizeof...(Args);
@@ -240,12 +467,9 @@ public:
   using method_type = Ret(T::*)(Args...);
 
   // Take a `this` pointer and a method pointer to bind
-  Thunk(T* instance, method_type method)
-    : ThunkBase<Args...>{ instance, brute_cast<void*>(method) }
-  {
-    // ThunkBase constructor modifies executable memory, on some processors this requires an icache flush
-    ThunkBase<Args...>::flushInstructionCache();
-  }
+  JitThunk(T* instance, method_type method)
+    : JitThunk{ detail::resolve_method(instance, method) }
+  {}
 
   // Returns a callback which can be called like a non-member function
   callback_type getCallback() const
@@ -254,6 +478,21 @@ public:
     // so we can simply pretend it is a function pointer.
     return reinterpret_cast<callback_type>(ThunkBase<Args...>::getBytecode());
   }
+
+private:
+  explicit JitThunk(std::pair<void*, void*> target)
+    : ThunkBase<Args...>{ target.first, target.second }
+  {}
 };
 
+// Binds a method of T to a plain callback of type Callback, e.g. Thunk<Input, GLFWkeyfun>.
+// Hardened hosts which forbid executable memory use the static trampoline pool instead.
+#ifdef VNGINE_STATIC_THUNKS
+template <typename T, typename Callback>
+using Thunk = StaticThunk<T, Callback>;
+#else
+template <typename T, typename Callback>
+using Thunk = JitThunk<T, Callback>;
+#endif
+
 }
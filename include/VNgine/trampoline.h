@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+#include <VNgine/helper.h>
+
+// Number of static trampolines compiled in per callback signature
+#ifndef VNGINE_STATIC_THUNK_SLOTS
+#define VNGINE_STATIC_THUNK_SLOTS 64
+#endif
+
+namespace VNgine
+{
+
+// Reports a callback signature with every trampoline slot taken and aborts. A null
+// callback would silently unregister the GLFW handler instead.
+[[noreturn]] void trampolineOverflow();
+
+/*
+ * Thunk backend for hosts that forbid writable-then-executable memory.
+ *
+ * For every callback signature, a fixed array of ordinary functions is instantiated at
+ * compile time. Trampoline I forwards its arguments to whatever is bound in slot I of a
+ * data table, so binding a method is a data write and no code is ever generated. The
+ * cost over a JIT thunk is one load from the table and one extra indirect call.
+ */
+template <typename Callback>
+class TrampolinePool;
+
+template <typename Ret, typename... Args>
+class TrampolinePool<Ret(*)(Args...)>
+{
+public:
+  using callback_type = Ret(*)(Args...);
+  static constexpr std::size_t Capacity = VNGINE_STATIC_THUNK_SLOTS;
+
+  // Binds a method to a free slot and returns its index; aborts if the pool is exhausted
+  template <typename T>
+  static std::size_t acquire(T* instance, Ret(T::* method)(Args...))
+  {
+    using method_type = Ret(T::*)(Args...);
+    static_assert(sizeof(method_type) <= sizeof(Slot::method), "Method pointer too large for a trampoline slot.");
+
+    for (std::size_t index = 0; index < Capacity; ++index)
+    {
+      Slot& slot = slots_[index];
+      if (!slot.used.test_and_set(std::memory_order_acquire))
+      {
+        slot.instance = instance;
+        std::memcpy(slot.method, &method, sizeof(method_type));
+        slot.invoke = &invoke<T>;
+        return index;
+      }
+    }
+    trampolineOverflow();
+  }
+
+  static void release(std::size_t index)
+  {
+    slots_[index].used.clear(std::memory_order_release);
+  }
+
+  static callback_type callback(std::size_t index)
+  {
+    return trampolines_[index];
+  }
+
+private:
+  struct Slot
+  {
+    std::atomic_flag used = ATOMIC_FLAG_INIT;
+    void* instance = nullptr;
+    Ret (*invoke)(Slot const&, Args...) = nullptr;
+    // Method pointers are stored as bytes since their size and layout depend on T
+    alignas(std::max_align_t) unsigned char method[4 * sizeof(void*)];
+  };
+
+  template <typename T>
+  static Ret invoke(Slot const& slot, Args... args)
+  {
+    Ret(T::* method)(Args...);
+    std::memcpy(&method, slot.method, sizeof(method));
+    return (static_cast<T*>(slot.instance)->*method)(args...);
+  }
+
+  template <std::size_t Index>
+  static Ret trampoline(Args... args)
+  {
+    Slot const& slot = slots_[Index];
+    return slot.invoke(slot, args...);
+  }
+
+  template <std::size_t... Index>
+  static constexpr std::array<callback_type, sizeof...(Index)> makeTrampolines(std::index_sequence<Index...>)
+  {
+    return { &trampoline<Index>... };
+  }
+
+  static inline Slot slots_[Capacity];
+  static std::array<callback_type, Capacity> const trampolines_;
+};
+
+template <typename Ret, typename... Args>
+std::array<Ret(*)(Args...), TrampolinePool<Ret(*)(Args...)>::Capacity> const
+  TrampolinePool<Ret(*)(Args...)>::trampolines_ = makeTrampolines(std::make_index_sequence<Capacity>{});
+
+// This incomplete template class is here to provide type deduction
+template<typename, typename>
+class StaticThunk;
+
+// Same interface as JitThunk, backed by a slot in the signature's TrampolinePool
+template<class T, typename Ret, typename... Args>
+class StaticThunk<T, Ret(*)(Args...)> : non_copyable<StaticThunk<T, Ret(*)(Args...)>>
+{
+  using Pool = TrampolinePool<Ret(*)(Args...)>;
+public:
+  constexpr static std::size_t ArgC = sizeof...(Args);
+  // Type of the callback function, as passed by template argument
+  using callback_type = Ret(*)(Args...);
+  // Type of the corresponding method in T which has the same signature
+  using method_type = Ret(T::*)(Args...);
+
+  // Take a `this` pointer and a method pointer to bind
+  StaticThunk(T* instance, method_type method)
+    : slot_{ Pool::acquire(instance, method) }
+  {}
+
+  ~StaticThunk()
+  {
+    Pool::release(slot_);
+  }
+
+  // Returns a callback which can be called like a non-member function
+  callback_type getCallback() const
+  {
+    return Pool::callback(slot_);
+  }
+
+private:
+  std::size_t slot_;
+};
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace VNgine
+{
+
+/*
+ * Positions, rotations and scales of many objects, stored as one array per component so
+ * that world matrices can be built several objects at a time with SIMD.
+ *
+ * Rotations are kept as unit quaternions, converted once when set, so building a matrix
+ * needs no trigonometry or normalization. computeMatrices() writes
+ * translate * rotate * scale for every object, the same matrix glm::translate, glm::rotate
+ * and glm::scale compose, and uses the widest kernel the CPU supports: AVX2 handles eight
+ * objects per step, SSE four, and a scalar loop the rest and any non-x86 target. Matrices
+ * are written with a stride, so they can go straight into instance data such as a
+ * SpriteInstance array or a mapped StreamBuffer.
+ */
+class TransformArray
+{
+public:
+  enum class Kernel
+  {
+    SCALAR,
+    SSE,
+    AVX2
+  };
+
+  static bool isSupported(Kernel kernel);
+  static Kernel bestKernel();
+
+  // Returns the new object's index. `angle` is in radians about `axis`, as for glm::rotate;
+  // the axis need not be normalized.
+  std::size_t add(glm::vec3 const& position, float angle = 0.0f, glm::vec3 const& axis = { 0.0f, 0.0f, 1.0f },
+                  glm::vec3 const& scale = glm::vec3{ 1.0f });
+  void setPosition(std::size_t index, glm::vec3 const& position);
+  void setRotation(std::size_t index, float angle, glm::vec3 const& axis);
+  void setScale(std::size_t index, glm::vec3 const& scale);
+  glm::vec3 getPosition(std::size_t index) const;
+
+  std::size_t size() const;
+  void reserve(std::size_t count);
+  void clear();
+
+  // Writes a column-major glm::mat4 for object i at `out` + i * `stride` bytes
+  void computeMatrices(void* out, std::size_t stride = sizeof(glm::mat4)) const;
+  void computeMatrices(void* out, std::size_t stride, Kernel kernel) const;
+
+private:
+  std::vector<float> position_x_;
+  std::vector<float> position_y_;
+  std::vector<float> position_z_;
+  std::vector<float> rotation_x_;
+  std::vector<float> rotation_y_;
+  std::vector<float> rotation_z_;
+  std::vector<float> rotation_w_;
+  std::vector<float> scale_x_;
+  std::vector<float> scale_y_;
+  std::vector<float> scale_z_;
+};
+
+}
@@ -0,0 +1,356 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+using UniformName = hashed_name;
+
+bool isSamplerType(GLenum type);
+
+// Maps a C++ value type to the GLSL uniform types it may be assigned to and the call that uploads it
+template <typename T>
+struct UniformTraits;
+
+template <>
+struct UniformTraits<float>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT; }
+  static void upload(GLint location, GLsizei count, float const* values) { glUniform1fv(location, count, values); }
+};
+
+template <>
+struct UniformTraits<glm::vec2>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_VEC2; }
+  static void upload(GLint location, GLsizei count, glm::vec2 const* values) { glUniform2fv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::vec3>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_VEC3; }
+  static void upload(GLint location, GLsizei count, glm::vec3 const* values) { glUniform3fv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::vec4>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_VEC4; }
+  static void upload(GLint location, GLsizei count, glm::vec4 const* values) { glUniform4fv(location, count, glm::value_ptr(*values)); }
+};
+
+// Booleans and samplers are set through their integer forms, as GL requires
+template <>
+struct UniformTraits<GLint>
+{
+  static bool accepts(GLenum type) { return type == GL_INT || type == GL_BOOL || isSamplerType(type); }
+  static void upload(GLint location, GLsizei count, GLint const* values) { glUniform1iv(location, count, values); }
+};
+
+template <>
+struct UniformTraits<glm::ivec2>
+{
+  static bool accepts(GLenum type) { return type == GL_INT_VEC2 || type == GL_BOOL_VEC2; }
+  static void upload(GLint location, GLsizei count, glm::ivec2 const* values) { glUniform2iv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::ivec3>
+{
+  static bool accepts(GLenum type) { return type == GL_INT_VEC3 || type == GL_BOOL_VEC3; }
+  static void upload(GLint location, GLsizei count, glm::ivec3 const* values) { glUniform3iv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::ivec4>
+{
+  static bool accepts(GLenum type) { return type == GL_INT_VEC4 || type == GL_BOOL_VEC4; }
+  static void upload(GLint location, GLsizei count, glm::ivec4 const* values) { glUniform4iv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<GLuint>
+{
+  static bool accepts(GLenum type) { return type == GL_UNSIGNED_INT; }
+  static void upload(GLint location, GLsizei count, GLuint const* values) { glUniform1uiv(location, count, values); }
+};
+
+template <>
+struct UniformTraits<glm::uvec2>
+{
+  static bool accepts(GLenum type) { return type == GL_UNSIGNED_INT_VEC2; }
+  static void upload(GLint location, GLsizei count, glm::uvec2 const* values) { glUniform2uiv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::uvec3>
+{
+  static bool accepts(GLenum type) { return type == GL_UNSIGNED_INT_VEC3; }
+  static void upload(GLint location, GLsizei count, glm::uvec3 const* values) { glUniform3uiv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::uvec4>
+{
+  static bool accepts(GLenum type) { return type == GL_UNSIGNED_INT_VEC4; }
+  static void upload(GLint location, GLsizei count, glm::uvec4 const* values) { glUniform4uiv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::mat2>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_MAT2; }
+  static void upload(GLint location, GLsizei count, glm::mat2 const* values) { glUniformMatrix2fv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::mat3>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_MAT3; }
+  static void upload(GLint location, GLsizei count, glm::mat3 const* values) { glUniformMatrix3fv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::mat4>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_MAT4; }
+  static void upload(GLint location, GLsizei count, glm::mat4 const* values) { glUniformMatrix4fv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::mat2x3>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_MAT2x3; }
+  static void upload(GLint location, GLsizei count, glm::mat2x3 const* values) { glUniformMatrix2x3fv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::mat2x4>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_MAT2x4; }
+  static void upload(GLint location, GLsizei count, glm::mat2x4 const* values) { glUniformMatrix2x4fv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::mat3x2>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_MAT3x2; }
+  static void upload(GLint location, GLsizei count, glm::mat3x2 const* values) { glUniformMatrix3x2fv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::mat3x4>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_MAT3x4; }
+  static void upload(GLint location, GLsizei count, glm::mat3x4 const* values) { glUniformMatrix3x4fv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::mat4x2>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_MAT4x2; }
+  static void upload(GLint location, GLsizei count, glm::mat4x2 const* values) { glUniformMatrix4x2fv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::mat4x3>
+{
+  static bool accepts(GLenum type) { return type == GL_FLOAT_MAT4x3; }
+  static void upload(GLint location, GLsizei count, glm::mat4x3 const* values) { glUniformMatrix4x3fv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+// Doubles need GL 4.0 or ARB_gpu_shader_fp64, which a program using them already implies
+template <>
+struct UniformTraits<double>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE; }
+  static void upload(GLint location, GLsizei count, double const* values) { glUniform1dv(location, count, values); }
+};
+
+template <>
+struct UniformTraits<glm::dvec2>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_VEC2; }
+  static void upload(GLint location, GLsizei count, glm::dvec2 const* values) { glUniform2dv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dvec3>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_VEC3; }
+  static void upload(GLint location, GLsizei count, glm::dvec3 const* values) { glUniform3dv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dvec4>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_VEC4; }
+  static void upload(GLint location, GLsizei count, glm::dvec4 const* values) { glUniform4dv(location, count, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dmat2>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_MAT2; }
+  static void upload(GLint location, GLsizei count, glm::dmat2 const* values) { glUniformMatrix2dv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dmat3>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_MAT3; }
+  static void upload(GLint location, GLsizei count, glm::dmat3 const* values) { glUniformMatrix3dv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dmat4>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_MAT4; }
+  static void upload(GLint location, GLsizei count, glm::dmat4 const* values) { glUniformMatrix4dv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dmat2x3>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_MAT2x3; }
+  static void upload(GLint location, GLsizei count, glm::dmat2x3 const* values) { glUniformMatrix2x3dv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dmat2x4>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_MAT2x4; }
+  static void upload(GLint location, GLsizei count, glm::dmat2x4 const* values) { glUniformMatrix2x4dv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dmat3x2>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_MAT3x2; }
+  static void upload(GLint location, GLsizei count, glm::dmat3x2 const* values) { glUniformMatrix3x2dv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dmat3x4>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_MAT3x4; }
+  static void upload(GLint location, GLsizei count, glm::dmat3x4 const* values) { glUniformMatrix3x4dv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dmat4x2>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_MAT4x2; }
+  static void upload(GLint location, GLsizei count, glm::dmat4x2 const* values) { glUniformMatrix4x2dv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+template <>
+struct UniformTraits<glm::dmat4x3>
+{
+  static bool accepts(GLenum type) { return type == GL_DOUBLE_MAT4x3; }
+  static void upload(GLint location, GLsizei count, glm::dmat4x3 const* values) { glUniformMatrix4x3dv(location, count, GL_FALSE, glm::value_ptr(*values)); }
+};
+
+struct Uniform
+{
+  std::string name;     // arrays are listed once, without the trailing [0]
+  std::uint64_t hash;
+  GLint location;       // element i of an array is at location + i
+  GLenum type;
+  GLint count;          // array length, 1 otherwise
+};
+
+struct UniformBlock
+{
+  std::string name;
+  std::uint64_t hash;
+  GLuint index;
+  GLint size;           // bytes, as laid out by the driver
+};
+
+/*
+ * Every active uniform and uniform block of a linked program, reflected once after linking.
+ *
+ * Lookups binary search a flat array sorted by name hash. Each uniform location also owns a
+ * slice of a shadow buffer holding the value the program currently has, seeded from the
+ * program itself, so setting a uniform to the value it already holds costs a memcmp
+ * instead of a GL call.
+ */
+class UniformTable
+{
+public:
+  struct Stats
+  {
+    std::size_t uploads = 0;
+    std::size_t skipped = 0;  // redundant sets caught by the shadow values
+  };
+
+  // Replaces the table with the contents of `program`, which must be linked
+  void reflect(GLuint program);
+
+  Uniform const* find(UniformName name) const;
+  UniformBlock const* findBlock(UniformName name) const;
+  array_view<Uniform const> uniforms() const { return { uniforms_.data(), uniforms_.size() }; }
+  array_view<UniformBlock const> blocks() const { return { blocks_.data(), blocks_.size() }; }
+
+  // Records `count` consecutive values starting at `location`. Returns false, leaving the
+  // shadow as it was, when the program already holds exactly these values.
+  template <typename T>
+  bool update(GLint location, T const* values, std::size_t count);
+
+  Stats const& stats() const { return stats_; }
+
+private:
+  struct Slot
+  {
+    GLenum type = 0;
+    std::uint32_t stride = 0;  // shadow bytes per element
+    std::uint32_t offset = 0;
+    std::uint32_t end = 0;     // end of the shadow for the rest of the array
+  };
+
+  std::vector<Uniform> uniforms_;
+  std::vector<UniformBlock> blocks_;
+  std::vector<Slot> slots_;    // indexed by location
+  std::vector<std::byte> shadow_;
+  Stats stats_;
+};
+
+template <typename T>
+bool UniformTable::update(GLint location, T const* values, std::size_t count)
+{
+  // GL ignores location -1, which is what a uniform the compiler optimized out resolves to
+  if (location < 0 || static_cast<std::size_t>(location) >= slots_.size())
+  {
+    return false;
+  }
+  Slot const& slot = slots_[location];
+  assert(UniformTraits<T>::accepts(slot.type) && sizeof(T) == slot.stride && "Uniform set with the wrong type.");
+  std::size_t const bytes = sizeof(T) * count;
+  assert(slot.offset + bytes <= slot.end && "Uniform array set past its end.");
+
+  std::byte* const shadow = shadow_.data() + slot.offset;
+  if (std::memcmp(shadow, values, bytes) == 0)
+  {
+    ++stats_.skipped;
+    return false;
+  }
+  std::memcpy(shadow, values, bytes);
+  ++stats_.uploads;
+  return true;
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+namespace std140
+{
+
+// std140 aligns vec3s, and every element of an array, to 16 bytes. Wrap those members in
+// this so the C++ struct matches the block, e.g. `std140::padded<glm::vec3> light_dir;`.
+template <typename T>
+struct alignas(16) padded
+{
+  T value;
+};
+
+}
+
+/*
+ * A uniform buffer bound to a fixed binding point, holding data every program reads the
+ * same way, such as the camera. Upload once per frame and each program that binds the
+ * block by name (ShaderProgram::bindUniformBlock) sees it without any per-program calls.
+ */
+class UniformBufferBase : non_copyable<UniformBufferBase>
+{
+public:
+  GLuint getID() const;
+  GLuint getBinding() const;
+  std::size_t getSize() const;
+  std::size_t getUploads() const;
+
+protected:
+  UniformBufferBase(GLuint binding, std::size_t size);
+  ~UniformBufferBase();
+  // Skipped when the data matches the previous upload
+  void upload(void const* data);
+
+private:
+  GLuint id_;
+  GLuint binding_;
+  std::vector<std::byte> shadow_;
+  bool uploaded_ = false;
+  std::size_t uploads_ = 0;
+};
+
+// `Block` mirrors a `layout (std140) uniform` block member for member; see std140::padded
+template <typename Block>
+class UniformBuffer : public UniformBufferBase
+{
+  static_assert(std::is_trivially_copyable_v<Block>, "Uniform blocks are uploaded as raw bytes.");
+  static_assert(sizeof(Block) % 16 == 0, "std140 rounds a block's size up to a multiple of 16 bytes.");
+
+public:
+  explicit UniformBuffer(GLuint binding)
+    : UniformBufferBase{ binding, sizeof(Block) }
+  {}
+
+  void update(Block const& block)
+  {
+    upload(&block);
+  }
+};
+
+}
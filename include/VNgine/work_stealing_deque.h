@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <VNgine/helper.h>
+
+namespace VNgine
+{
+
+/*
+ * Fixed-capacity Chase-Lev deque: one owner thread pushes and pops at the bottom, any
+ * number of other threads steal from the top.
+ *
+ * The owner works LIFO, so the job it just pushed, whose data is still in cache, runs next,
+ * while thieves take the oldest job, which is usually the biggest piece of a split-up task.
+ * Only the last item is contended: owner and thieves agree on it with a compare-and-swap
+ * of the top index; everything else is plain loads and stores. The memory orders follow
+ * Lê et al., "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+template <typename T, std::size_t Capacity>
+class WorkStealingDeque : non_copyable<WorkStealingDeque<T, Capacity>>
+{
+  static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+  static_assert(std::is_trivially_copyable_v<T>, "Items are read by thieves racing with the owner.");
+public:
+  static constexpr std::size_t capacity = Capacity;
+
+  WorkStealingDeque() = default;
+
+  // Owner only. Returns false, leaving the deque untouched, when it is full.
+  bool push(T const& item)
+  {
+    std::int64_t const bottom = bottom_.load(std::memory_order_relaxed);
+    std::int64_t const top = top_.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<std::int64_t>(Capacity))
+    {
+      return false;
+    }
+    items_[bottom & (Capacity - 1)].store(item, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Owner only. Takes the most recently pushed item; returns false when there is none.
+  bool pop(T& item)
+  {
+    std::int64_t const bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom)
+    {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+    item = items_[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (top != bottom)
+    {
+      return true;
+    }
+    // The last item: a thief may be taking it at the same time
+    bool const won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  // Any thread. Takes the oldest item; returns false when the deque is empty or another
+  // thread took that item first.
+  bool steal(T& item)
+  {
+    std::int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t const bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+      return false;
+    }
+    item = items_[top & (Capacity - 1)].load(std::memory_order_relaxed);
+    return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+  // Approximate when called while other threads are running
+  std::size_t size() const
+  {
+    std::int64_t const size = bottom_.load(std::memory_order_acquire) - top_.load(std::memory_order_acquire);
+    return size > 0 ? static_cast<std::size_t>(size) : 0;
+  }
+
+private:
+  // Thieves' side
+  alignas(64) std::atomic<std::int64_t> top_{ 0 };
+  // Owner's side
+  alignas(64) std::atomic<std::int64_t> bottom_{ 0 };
+
+  alignas(64) std::array<std::atomic<T>, Capacity> items_{};
+};
+
+}
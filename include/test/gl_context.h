@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdio>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <VNgine/gl_state.h>
+
+namespace test
+{
+
+// Hidden window with a current GL 3.3 core context, for benchmarks that need the driver.
+// Hosts without a display or GL driver get an invalid context and should skip. Like Window,
+// it owns the GL state tracker for its context and makes it current.
+class GLContext
+{
+public:
+  GLContext()
+  {
+    if (!glfwInit())
+    {
+      return;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    window_ = glfwCreateWindow(64, 64, "", nullptr, nullptr);
+    if (!window_)
+    {
+      return;
+    }
+    glfwMakeContextCurrent(window_);
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK)
+    {
+      glfwDestroyWindow(window_);
+      window_ = nullptr;
+      return;
+    }
+    gl_state_.makeCurrent();
+  }
+
+  ~GLContext()
+  {
+    if (window_)
+    {
+      glfwDestroyWindow(window_);
+    }
+  }
+
+  GLContext(GLContext const&) = delete;
+  GLContext& operator=(GLContext const&) = delete;
+
+  explicit operator bool() const { return window_ != nullptr; }
+  GLFWwindow* window() const { return window_; }
+
+  static void skip(char const* label)
+  {
+    std::printf("  %-48s skipped, no GL context could be created\n", label);
+  }
+
+private:
+  GLFWwindow* window_ = nullptr;
+  VNgine::GLState gl_state_;
+};
+
+}
@@ -1,2 +1,102 @@
 #pragma once
 
+/*
+ * Minimal self-registering test harness for the `test` target.
+ * Exceptions are disabled, so failed checks are recorded and the test keeps running.
+ * Benchmarks register the same way and only run when the target is started with --bench.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace test
+{
+
+struct Case
+{
+  char const* name;
+  void (*function)();
+};
+
+inline std::vector<Case>& registry()
+{
+  static std::vector<Case> cases;
+  return cases;
+}
+
+inline std::vector<Case>& benchmarks()
+{
+  static std::vector<Case> cases;
+  return cases;
+}
+
+inline int& failureCount()
+{
+  static int count = 0;
+  return count;
+}
+
+struct Registrar
+{
+  Registrar(std::vector<Case>& cases, char const* name, void (*function)())
+  {
+    cases.push_back({ name, function });
+  }
+};
+
+inline void reportFailure(char const* expression, char const* file, int line)
+{
+  ++failureCount();
+  std::fprintf(stderr, "  [FAILED] %s\n    at %s:%i\n", expression, file, line);
+}
+
+// Runs every registered test and returns the number of failed checks
+inline int runAll()
+{
+  for (Case const& test_case : registry())
+  {
+    int const failures_before = failureCount();
+    test_case.function();
+    std::printf("[%s] %s\n", (failureCount() == failures_before) ? "PASS" : "FAIL", test_case.name);
+  }
+  return failureCount();
+}
+
+inline int runBenchmarks()
+{
+  for (Case const& benchmark : benchmarks())
+  {
+    std::printf("[BENCH] %s\n", benchmark.name);
+    benchmark.function();
+  }
+  return failureCount();
+}
+
+// Times one run of `function` and prints the total and the average cost per operation
+template <typename Function>
+double measure(char const* label, std::size_t operations, Function&& function)
+{
+  auto const start = std::chrono::steady_clock::now();
+  function();
+  std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+  std::printf("  %-48s %10.3f ms %12.1f ns/op\n", label,
+    elapsed.count() * 1e3, elapsed.count() * 1e9 / static_cast<double>(operations));
+  return elapsed.count();
+}
+
+}
+
+#define TEST_CASE(name)                                                                  \
+  static void name();                                                                    \
+  static ::test::Registrar const name##_registrar{ ::test::registry(), #name, &name };   \
+  static void name()
+
+#define BENCHMARK(name)                                                                  \
+  static void name();                                                                    \
+  static ::test::Registrar const name##_registrar{ ::test::benchmarks(), #name, &name }; \
+  static void name()
+
+#define CHECK(expression) \
+  ((expression) ? (void)0 : ::test::reportFailure(#expression, __FILE__, __LINE__))
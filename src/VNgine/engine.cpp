@@ -1,49 +1,32 @@
 #include <VNgine/engine.h>
+#include <VNgine/frame_allocator.h>
+#include <VNgine/gl_debug_log.h>
+#include <VNgine/gl_intercept.h>
 
 #include <cassert>
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <string_view>
+#include <vector>
 
 namespace
 {
 
-void GLAPIENTRY
-messageCallback(GLenum source,
-  GLenum type,
-  GLuint id,
-  GLenum severity,
-  GLsizei length,
-  const GLchar* message,
-  const void* userParam)
-{
-  // temp hack
-  //if (severity > GL_DEBUG_SEVERITY_MEDIUM)
-  {
-    fprintf(stderr, "GL CALLBACK: %s type = 0x%x, severity = 0x%x, message = %s\n",
-      (type == GL_DEBUG_TYPE_ERROR ? "** GL ERROR **" : ""),
-      type, severity, message);
-  }
-}
-
 void errorCallback(int error, const char* description)
 {
   fprintf(stderr, "[ERROR]: GLFW error %i:\n%s\n", error, description);
 }
 
-void framebufferSizeCallback(GLFWwindow* window, int width, int height)
-{
-  // make sure the viewport matches the new window dimensions; note that width and 
-  // height will be significantly larger than specified on retina displays.
-  glViewport(0, 0, width, height);
-}
-
 }
 
 namespace VNgine
 {
 
-Window::Window(int width, int height, std::string_view title)
+Window::Window(int width, int height, std::string_view title, Mode mode)
+  : mode_{ mode },
+    framebuffer_size_thunk_{ this, &Window::framebufferSizeCallback },
+    pending_size_{ no_resize }
 {
   glfwSetErrorCallback(errorCallback);
 
@@ -56,13 +39,24 @@ Window::Window(int width, int height, std::string_view title)
   glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
 #endif
   glfwWindowHint(GLFW_DOUBLEBUFFER, GLFW_TRUE);
+  glfwWindowHint(GLFW_VISIBLE, isHeadless() ? GLFW_FALSE : GLFW_TRUE);
 
   window_ = glfwCreateWindow(width, height, title.data(), nullptr, nullptr);
+  if (!window_)
+  {
+    std::cerr << "[ERROR] Could not create a window with a GL 3.3 core context.\n";
+    assert(!"Window creation failed");
+  }
   glfwMakeContextCurrent(window_);
-  glfwSwapInterval(1);
+  // Headless frames are never shown, so nothing should hold them to the display's rate
+  glfwSwapInterval(isHeadless() ? 0 : 1);
 
-  glfwSetFramebufferSizeCallback(window_, framebufferSizeCallback);
-  glfwSetWindowAspectRatio(window_, 16, 9);
+  // The offscreen framebuffer keeps the size it was created with
+  if (!isHeadless())
+  {
+    glfwSetFramebufferSizeCallback(window_, framebuffer_size_thunk_.getCallback());
+    glfwSetWindowAspectRatio(window_, 16, 9);
+  }
 
   GLenum err = glewInit();
   if (GLEW_OK != err)
@@ -71,21 +65,47 @@ Window::Window(int width, int height, std::string_view title)
     std::cerr << glewGetErrorString(err) << std::endl;
     assert(!"GLEW failed to initialize");
   }
+#ifdef VNGINE_GL_INTERCEPT
+  GLIntercept::install();
+#endif
+  gl_state_.makeCurrent();
+  gl_resources_.makeCurrent();
+  gpu_profiler_.makeCurrent();
+  if (isHeadless())
+  {
+    createOffscreenFramebuffer(width, height);
+  }
 
   if (GLEW_KHR_debug)
   {
-    glEnable(GL_DEBUG_OUTPUT);
-    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-    glDebugMessageCallback(messageCallback, nullptr);
+    debug_log_ = std::make_unique<GLDebugLog>();
+    debug_log_->install();
   }
 }
 Window::~Window()
 {
+  gpu_profiler_.reset();
+  if (debug_log_)
+  {
+    debug_log_->uninstall();
+  }
+  if (framebuffer_)
+  {
+    gl_state_.deleteFramebuffer(framebuffer_);
+    glDeleteRenderbuffers(1, &color_buffer_);
+    glDeleteRenderbuffers(1, &depth_buffer_);
+  }
+  // Anything retired but not yet deleted, and anything still owned, goes with the context
+  gl_resources_.reset();
+  glfwSetFramebufferSizeCallback(window_, nullptr);
   glfwDestroyWindow(window_);
 }
 void Window::show() const
 {
-  glfwShowWindow(window_);
+  if (!isHeadless())
+  {
+    glfwShowWindow(window_);
+  }
 }
 int Window::shouldClose() const
 {
@@ -93,15 +113,118 @@ int Window::shouldClose() const
 }
 void Window::poll() const
 {
+  VNGINE_PROFILE_SCOPE("Window::poll");
   glfwPollEvents();
 }
-void Window::present() const
+void Window::present()
 {
-  glfwSwapBuffers(window_);
+  VNGINE_PROFILE_SCOPE("Window::present");
+  if (isHeadless())
+  {
+    // Stands in for the swap blocking on the GPU, so a frame's time includes rendering it
+    glFinish();
+  }
+  else
+  {
+    glfwSwapBuffers(window_);
+  }
+  std::uint64_t const size = pending_size_.exchange(no_resize, std::memory_order_acquire);
+  if (size != no_resize)
+  {
+    // make sure the viewport matches the new window dimensions; note that width and 
+    // height will be significantly larger than specified on retina displays.
+    gl_state_.viewport(0, 0, static_cast<GLsizei>(size >> 32), static_cast<GLsizei>(size & 0xFFFFFFFF));
+  }
+  gl_state_.endFrame();
+  gl_resources_.endFrame();
+  gpu_profiler_.endFrame();
+  FrameMemory::endFrame();
+#ifdef VNGINE_GL_INTERCEPT
+  GLIntercept::endFrame();
+#endif
+}
+void Window::makeContextCurrent()
+{
+  glfwMakeContextCurrent(window_);
+  gl_state_.makeCurrent();
+  gl_resources_.makeCurrent();
+  gpu_profiler_.makeCurrent();
+}
+void Window::releaseContext()
+{
+  GpuProfiler::clearCurrent();
+  GLResources::clearCurrent();
+  GLState::clearCurrent();
+  glfwMakeContextCurrent(nullptr);
+}
+bool Window::isHeadless() const
+{
+  return mode_ == Mode::HEADLESS;
+}
+GLuint Window::getFramebuffer() const
+{
+  return framebuffer_;
+}
+std::uint64_t Window::hashFrame()
+{
+  int width = offscreen_width_;
+  int height = offscreen_height_;
+  if (!isHeadless())
+  {
+    glfwGetFramebufferSize(window_, &width, &height);
+  }
+  std::vector<char> pixels(std::size_t(width) * std::size_t(height) * 4);
+  gl_state_.bindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer_);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+  return fnv1a_hash({ pixels.data(), pixels.size() });
 }
 GLFWwindow* Window::getHandle() const
 {
   return window_;
 }
+GLState& Window::getGLState()
+{
+  return gl_state_;
+}
+GLResources& Window::getGLResources()
+{
+  return gl_resources_;
+}
+GpuProfiler& Window::getGpuProfiler()
+{
+  return gpu_profiler_;
+}
+GLDebugLog* Window::getDebugLog()
+{
+  return debug_log_.get();
+}
+void Window::framebufferSizeCallback(GLFWwindow*, int width, int height)
+{
+  pending_size_.store((std::uint64_t(std::uint32_t(width)) << 32) | std::uint32_t(height), std::memory_order_release);
+}
+void Window::createOffscreenFramebuffer(int width, int height)
+{
+  offscreen_width_ = width;
+  offscreen_height_ = height;
+  glGenRenderbuffers(1, &color_buffer_);
+  glBindRenderbuffer(GL_RENDERBUFFER, color_buffer_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+  glGenRenderbuffers(1, &depth_buffer_);
+  glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glGenFramebuffers(1, &framebuffer_);
+  gl_state_.bindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_buffer_);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_buffer_);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+  {
+    std::cerr << "[ERROR] Offscreen framebuffer is incomplete.\n";
+    assert(!"Offscreen framebuffer is incomplete");
+  }
+  gl_state_.viewport(0, 0, width, height);
+}
 
 }
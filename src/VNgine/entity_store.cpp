@@ -0,0 +1,256 @@
+#include <VNgine/entity_store.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <new>
+
+namespace VNgine
+{
+
+namespace
+{
+
+struct ComponentInfo
+{
+  std::size_t size;
+  std::size_t alignment;
+};
+
+// Chunks are cache-line aligned, which also suits any component alignment up to that
+constexpr std::size_t chunk_alignment = 64;
+
+std::mutex component_mutex;
+std::array<ComponentInfo, EntityStore::max_components> component_infos;
+std::atomic<ComponentId> component_count{ 0 };
+
+// Going past any of the limits would write out of bounds, so every build stops here
+[[noreturn]] void componentLimitExceeded(char const* message)
+{
+  std::cerr << "[ERROR] " << message << '\n';
+  std::abort();
+}
+
+ComponentInfo componentInfo(ComponentId id)
+{
+  std::lock_guard<std::mutex> const lock{ component_mutex };
+  return component_infos[id];
+}
+
+}
+
+namespace detail
+{
+
+ComponentId registerComponent(std::size_t size, std::size_t alignment)
+{
+  std::lock_guard<std::mutex> const lock{ component_mutex };
+  ComponentId const id = component_count.load(std::memory_order_relaxed);
+  if (id >= EntityStore::max_components)
+  {
+    componentLimitExceeded("Too many component types.");
+  }
+  if (alignment > chunk_alignment)
+  {
+    componentLimitExceeded("Component alignment exceeds the chunk alignment.");
+  }
+  // One row of this component alone, with its entity and the padding before each array
+  if (sizeof(Entity) + size + 2 * chunk_alignment > EntityStore::chunk_bytes)
+  {
+    componentLimitExceeded("Component too large for a chunk.");
+  }
+  component_infos[id] = { size, alignment };
+  component_count.store(id + 1, std::memory_order_relaxed);
+  return id;
+}
+
+}
+
+EntityStore::Chunk::Chunk()
+  : data_{ static_cast<std::byte*>(::operator new(chunk_bytes, std::align_val_t{ chunk_alignment })) }
+{}
+
+EntityStore::Chunk::~Chunk()
+{
+  ::operator delete(data_, std::align_val_t{ chunk_alignment });
+}
+
+EntityStore::EntityStore()
+{
+  // The archetype of entities without components
+  archetypeFor(0);
+}
+
+EntityStore::~EntityStore() = default;
+
+void EntityStore::destroy(Entity entity)
+{
+  assert(!iterating_ && "Entity destroyed during a query.");
+  Record& record = recordOf(entity);
+  erase(*record.archetype, record.row);
+  record.archetype = nullptr;
+  ++record.generation;
+  free_indices_.push_back(entity.index);
+  --size_;
+}
+
+bool EntityStore::isAlive(Entity entity) const
+{
+  return entity.index < records_.size() && records_[entity.index].archetype
+    && records_[entity.index].generation == entity.generation;
+}
+
+std::size_t EntityStore::size() const
+{
+  return size_;
+}
+
+std::size_t EntityStore::archetypeCount() const
+{
+  return archetypes_.size();
+}
+
+std::size_t EntityStore::chunkCount() const
+{
+  std::size_t count = 0;
+  for (std::unique_ptr<Archetype> const& archetype : archetypes_)
+  {
+    count += archetype->chunkCount();
+  }
+  return count;
+}
+
+EntityStore::Archetype& EntityStore::archetypeFor(Mask mask)
+{
+  auto const found = archetype_lookup_.find(mask);
+  if (found != archetype_lookup_.end())
+  {
+    return *found->second;
+  }
+
+  auto archetype = std::make_unique<Archetype>();
+  archetype->mask = mask;
+  std::size_t row_bytes = sizeof(Entity);
+  for (ComponentId id = 0; id < max_components; ++id)
+  {
+    if (mask & (Mask{ 1 } << id))
+    {
+      archetype->components.push_back(id);
+      row_bytes += componentInfo(id).size;
+    }
+  }
+  // Leave room for the padding between arrays
+  std::size_t const padding = (archetype->components.size() + 1) * chunk_alignment;
+  if (row_bytes + padding > chunk_bytes)
+  {
+    componentLimitExceeded("Components too large to share a chunk.");
+  }
+  archetype->capacity = (chunk_bytes - padding) / row_bytes;
+
+  // The entity array first, then one array per component
+  archetype->offsets.fill(0);
+  archetype->sizes.fill(0);
+  std::size_t offset = archetype->capacity * sizeof(Entity);
+  for (ComponentId const id : archetype->components)
+  {
+    ComponentInfo const info = componentInfo(id);
+    offset = (offset + info.alignment - 1) / info.alignment * info.alignment;
+    archetype->offsets[id] = static_cast<std::uint32_t>(offset);
+    archetype->sizes[id] = static_cast<std::uint32_t>(info.size);
+    offset += archetype->capacity * info.size;
+  }
+  assert(offset <= chunk_bytes);
+
+  Archetype& result = *archetype;
+  archetype_lookup_.emplace(mask, archetype.get());
+  archetypes_.push_back(std::move(archetype));
+  return result;
+}
+
+std::uint32_t EntityStore::push(Archetype& archetype, Entity entity)
+{
+  std::size_t const row = archetype.size;
+  if (row / archetype.capacity == archetype.chunks.size())
+  {
+    archetype.chunks.push_back(std::make_unique<Chunk>());
+  }
+  ++archetype.size;
+  archetype.entities(row / archetype.capacity)[row % archetype.capacity] = entity;
+  Record& record = records_[entity.index];
+  record.archetype = &archetype;
+  record.row = static_cast<std::uint32_t>(row);
+  return record.row;
+}
+
+void EntityStore::erase(Archetype& archetype, std::uint32_t row)
+{
+  std::size_t const last = archetype.size - 1;
+  if (row != last)
+  {
+    for (ComponentId const id : archetype.components)
+    {
+      std::memcpy(archetype.component(id, row), archetype.component(id, last), archetype.sizes[id]);
+    }
+    Entity const moved = archetype.entities(last / archetype.capacity)[last % archetype.capacity];
+    archetype.entities(row / archetype.capacity)[row % archetype.capacity] = moved;
+    records_[moved.index].row = row;
+  }
+  --archetype.size;
+  // Keep one empty chunk as a spare, so an entity going back and forth does not
+  // allocate every time
+  std::size_t const needed = archetype.chunkCount() + 1;
+  if (archetype.chunks.size() > needed)
+  {
+    archetype.chunks.resize(needed);
+  }
+}
+
+void EntityStore::move(Entity entity, Archetype& target)
+{
+  Record& record = recordOf(entity);
+  Archetype& source = *record.archetype;
+  std::uint32_t const source_row = record.row;
+  std::uint32_t const target_row = push(target, entity);
+  for (ComponentId const id : target.components)
+  {
+    if (source.mask & (Mask{ 1 } << id))
+    {
+      std::memcpy(target.component(id, target_row), source.component(id, source_row), target.sizes[id]);
+    }
+  }
+  // push() pointed the record at the target, so erase() only fixes up the entity moved into
+  // the hole
+  erase(source, source_row);
+}
+
+Entity EntityStore::allocateEntity()
+{
+  std::uint32_t index;
+  if (!free_indices_.empty())
+  {
+    index = free_indices_.back();
+    free_indices_.pop_back();
+  }
+  else
+  {
+    index = static_cast<std::uint32_t>(records_.size());
+    records_.push_back({ nullptr, 0, 0 });
+  }
+  ++size_;
+  return { index, records_[index].generation };
+}
+
+EntityStore::Record& EntityStore::recordOf(Entity entity)
+{
+  assert(isAlive(entity) && "Entity is not alive.");
+  return records_[entity.index];
+}
+
+EntityStore::Record const& EntityStore::recordOf(Entity entity) const
+{
+  assert(isAlive(entity) && "Entity is not alive.");
+  return records_[entity.index];
+}
+
+}
@@ -0,0 +1,91 @@
+#include <VNgine/file_watcher.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace VNgine
+{
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher(std::string_view directory)
+  : fd_{ inotify_init1(IN_NONBLOCK | IN_CLOEXEC) }
+{
+  // Editors either write in place or write a temporary file and rename it over the original
+  std::string const path{ directory };
+  if (fd_ >= 0 && inotify_add_watch(fd_, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+  {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+FileWatcher::~FileWatcher()
+{
+  if (fd_ >= 0)
+  {
+    close(fd_);
+  }
+}
+
+std::vector<std::string> const& FileWatcher::poll()
+{
+  changed_.clear();
+  if (fd_ < 0)
+  {
+    return changed_;
+  }
+
+  alignas(inotify_event) char buffer[4096];
+  for (;;)
+  {
+    ssize_t const length = read(fd_, buffer, sizeof(buffer));
+    if (length <= 0)
+    {
+      break;
+    }
+    for (ssize_t offset = 0; offset < length; )
+    {
+      inotify_event event;
+      std::memcpy(&event, buffer + offset, sizeof(event));
+      if (event.len > 0)
+      {
+        std::string name{ buffer + offset + sizeof(inotify_event) };
+        if (std::find(changed_.begin(), changed_.end(), name) == changed_.end())
+        {
+          changed_.push_back(std::move(name));
+        }
+      }
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event.len);
+    }
+  }
+  return changed_;
+}
+
+#else
+
+FileWatcher::FileWatcher(std::string_view)
+{}
+
+FileWatcher::~FileWatcher()
+{}
+
+std::vector<std::string> const& FileWatcher::poll()
+{
+  return changed_;
+}
+
+#endif
+
+bool FileWatcher::isWatching() const
+{
+  return fd_ >= 0;
+}
+
+}
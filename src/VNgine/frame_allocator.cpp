@@ -0,0 +1,128 @@
+#include <VNgine/frame_allocator.h>
+
+#include <algorithm>
+
+namespace VNgine
+{
+
+FrameAllocator::FrameAllocator(std::size_t capacity, MemoryTag tag)
+  : block_{ new std::byte[std::max<std::size_t>(capacity, 1)] },
+    capacity_{ std::max<std::size_t>(capacity, 1) },
+    tag_{ tag }
+{
+  MemoryTracker::allocated(tag_, capacity_);
+}
+
+FrameAllocator::~FrameAllocator()
+{
+  MemoryTracker::released(tag_, capacity_ + overflow_bytes_);
+}
+
+void* FrameAllocator::allocateOverflow(std::size_t size, std::size_t alignment)
+{
+  ++stats_.overflows;
+  // Padded so the start can be aligned however the heap block comes back
+  std::size_t const padded = size + alignment - 1;
+  overflow_.emplace_back(new std::byte[std::max<std::size_t>(padded, 1)]);
+  overflow_bytes_ += std::max<std::size_t>(padded, 1);
+  MemoryTracker::allocated(tag_, std::max<std::size_t>(padded, 1));
+  stats_.used += padded;
+  std::uintptr_t const base = reinterpret_cast<std::uintptr_t>(overflow_.back().get());
+  return reinterpret_cast<void*>((base + alignment - 1) & ~(alignment - 1));
+}
+
+void FrameAllocator::reset()
+{
+  stats_.peak = std::max(stats_.peak, stats_.used);
+  if (!overflow_.empty())
+  {
+    overflow_.clear();
+    MemoryTracker::released(tag_, capacity_ + overflow_bytes_);
+    overflow_bytes_ = 0;
+    // Room for the whole of the frame that just overflowed, with some headroom
+    capacity_ = std::max(stats_.used + stats_.used / 2, capacity_ * 2);
+    block_.reset(new std::byte[capacity_]);
+    MemoryTracker::allocated(tag_, capacity_);
+  }
+  offset_ = 0;
+  stats_.used = 0;
+}
+
+std::size_t FrameAllocator::getCapacity() const
+{
+  return capacity_;
+}
+
+FrameAllocator::Stats const& FrameAllocator::stats() const
+{
+  return stats_;
+}
+
+FrameResource::FrameResource(FrameAllocator& allocator)
+  : allocator_{ allocator }
+{}
+
+void* FrameResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+  return allocator_.allocate(bytes, alignment);
+}
+
+void FrameResource::do_deallocate(void*, std::size_t, std::size_t)
+{}
+
+bool FrameResource::do_is_equal(std::pmr::memory_resource const& other) const noexcept
+{
+  return this == &other;
+}
+
+namespace
+{
+
+struct ThreadArenas
+{
+  struct Arena
+  {
+    FrameAllocator allocator{ FrameMemory::initial_capacity };
+    FrameResource resource{ allocator };
+    std::uint64_t frame = 0;
+  };
+
+  Arena arenas[2];
+};
+
+ThreadArenas::Arena& currentArena()
+{
+  thread_local ThreadArenas arenas;
+  std::uint64_t const frame = FrameMemory::frame();
+  ThreadArenas::Arena& arena = arenas.arenas[frame & 1];
+  if (arena.frame != frame)
+  {
+    arena.allocator.reset();
+    arena.frame = frame;
+  }
+  return arena;
+}
+
+}
+
+FrameAllocator& FrameMemory::allocator()
+{
+  return currentArena().allocator;
+}
+
+std::pmr::memory_resource* FrameMemory::resource()
+{
+  return &currentArena().resource;
+}
+
+void FrameMemory::endFrame()
+{
+  frame_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t FrameMemory::frame()
+{
+  return frame_.load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,306 @@
+#include <VNgine/gl_debug_log.h>
+#include <VNgine/profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+namespace VNgine
+{
+
+namespace
+{
+
+// Long enough that a burst of messages is usually written in one go
+constexpr std::chrono::milliseconds poll_interval{ 10 };
+
+char const* severityLabel(GLDebugLog::Severity severity)
+{
+  switch (severity)
+  {
+  case GLDebugLog::Severity::HIGH: return "[ERROR]";
+  case GLDebugLog::Severity::MEDIUM: return "[WARNING]";
+  default: return "[INFO]";
+  }
+}
+
+char const* sourceName(GLenum source)
+{
+  switch (source)
+  {
+  case GL_DEBUG_SOURCE_API: return "API";
+  case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "window system";
+  case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+  case GL_DEBUG_SOURCE_THIRD_PARTY: return "third party";
+  case GL_DEBUG_SOURCE_APPLICATION: return "application";
+  default: return "other";
+  }
+}
+
+char const* typeName(GLenum type)
+{
+  switch (type)
+  {
+  case GL_DEBUG_TYPE_ERROR: return "error";
+  case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated behavior";
+  case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "undefined behavior";
+  case GL_DEBUG_TYPE_PORTABILITY: return "portability";
+  case GL_DEBUG_TYPE_PERFORMANCE: return "performance";
+  case GL_DEBUG_TYPE_MARKER: return "marker";
+  case GL_DEBUG_TYPE_PUSH_GROUP: return "push group";
+  case GL_DEBUG_TYPE_POP_GROUP: return "pop group";
+  default: return "message";
+  }
+}
+
+}
+
+GLDebugLog::GLDebugLog()
+  : GLDebugLog{ Options{} }
+{}
+
+GLDebugLog::GLDebugLog(Options const& options)
+  : options_{ options },
+    out_{ options.out ? *options.out : std::cerr },
+    min_severity_{ options.min_severity },
+    line_budget_{ double(options.lines_per_second) },
+    budget_time_{ Profiler::steadyNanoseconds() },
+    writer_{ &GLDebugLog::writerMain, this }
+{}
+
+GLDebugLog::~GLDebugLog()
+{
+  {
+    std::lock_guard<std::mutex> const lock{ mutex_ };
+    stopping_ = true;
+  }
+  wake_signal_.notify_one();
+  writer_.join();
+}
+
+void GLDebugLog::install()
+{
+  glEnable(GL_DEBUG_OUTPUT);
+  glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  glDebugMessageCallback(&GLDebugLog::callback, this);
+}
+
+void GLDebugLog::uninstall()
+{
+  glDebugMessageCallback(nullptr, nullptr);
+  glDisable(GL_DEBUG_OUTPUT);
+}
+
+void GLDebugLog::setSynchronous(bool synchronous)
+{
+  if (synchronous)
+  {
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  }
+  else
+  {
+    glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  }
+}
+
+void GLDebugLog::setMinSeverity(Severity severity)
+{
+  min_severity_.store(severity, std::memory_order_relaxed);
+}
+
+GLDebugLog::Severity GLDebugLog::getMinSeverity() const
+{
+  return min_severity_.load(std::memory_order_relaxed);
+}
+
+void GLDebugLog::flush()
+{
+  std::uint64_t const target = queued_.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock{ mutex_ };
+  flush_requested_ = true;
+  wake_signal_.notify_one();
+  flushed_signal_.wait(lock, [&] { return handled_ >= target; });
+}
+
+GLDebugLog::Stats GLDebugLog::stats() const
+{
+  return {
+    received_.load(std::memory_order_relaxed),
+    filtered_.load(std::memory_order_relaxed),
+    dropped_.load(std::memory_order_relaxed),
+    repeat_count_.load(std::memory_order_relaxed),
+    rate_limited_.load(std::memory_order_relaxed),
+    written_.load(std::memory_order_relaxed)
+  };
+}
+
+void GLAPIENTRY GLDebugLog::callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                                     GLchar const* message, void const* user)
+{
+  static_cast<GLDebugLog*>(const_cast<void*>(user))->receive(source, type, id, severity, length, message);
+}
+
+void GLDebugLog::receive(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, GLchar const* message)
+{
+  received_.fetch_add(1, std::memory_order_relaxed);
+  if (severityOf(severity) < min_severity_.load(std::memory_order_relaxed))
+  {
+    filtered_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  GLDebugMessage entry;
+  entry.timestamp = Profiler::steadyNanoseconds();
+  entry.source = source;
+  entry.type = type;
+  entry.id = id;
+  entry.severity = severity;
+  // A negative length means the text is nul-terminated
+  std::size_t const text_length = length < 0 ? std::strlen(message) : std::size_t(length);
+  entry.length = std::uint32_t(text_length);
+  std::size_t const copied = std::min(text_length, GLDebugMessage::max_text - 1);
+  std::memcpy(entry.text, message, copied);
+  entry.text[copied] = '\0';
+  if (!queue_.push(entry))
+  {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  queued_.fetch_add(1, std::memory_order_release);
+}
+
+GLDebugLog::Severity GLDebugLog::severityOf(GLenum severity)
+{
+  switch (severity)
+  {
+  case GL_DEBUG_SEVERITY_HIGH: return Severity::HIGH;
+  case GL_DEBUG_SEVERITY_MEDIUM: return Severity::MEDIUM;
+  case GL_DEBUG_SEVERITY_LOW: return Severity::LOW;
+  default: return Severity::NOTIFICATION;
+  }
+}
+
+void GLDebugLog::writerMain()
+{
+  Profiler::setThreadName("GL debug log");
+  std::unique_lock<std::mutex> lock{ mutex_ };
+  for (;;)
+  {
+    bool const stopping = stopping_;
+    lock.unlock();
+    std::uint64_t handled = 0;
+    GLDebugMessage message;
+    while (queue_.pop(message))
+    {
+      handle(message);
+      ++handled;
+    }
+    if (handled)
+    {
+      out_.flush();
+    }
+    lock.lock();
+    handled_ += handled;
+    flushed_signal_.notify_all();
+    // Whatever was queued before the log began to stop has been handled
+    if (stopping)
+    {
+      break;
+    }
+    wake_signal_.wait_for(lock, poll_interval, [this] { return stopping_ || flush_requested_; });
+    flush_requested_ = false;
+  }
+  lock.unlock();
+  writeRepeatSummary();
+}
+
+void GLDebugLog::handle(GLDebugMessage const& message)
+{
+  std::uint64_t key = (std::uint64_t(message.source & 0xFFFF) << 48) | (std::uint64_t(message.type & 0xFFFF) << 32)
+    | message.id;
+  if (message.id == 0)
+  {
+    key ^= fnv1a_hash(message.text);
+  }
+  auto const [repeat, first] = repeats_.try_emplace(key, Repeat{ message.id, 0, 0 });
+  std::uint64_t const interval_ns = std::uint64_t(options_.repeat_interval_ms) * 1000000;
+  if (!first && message.timestamp < repeat->second.written_at + interval_ns)
+  {
+    ++repeat->second.count;
+    repeat_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (!takeLine())
+  {
+    ++held_back_;
+    rate_limited_.fetch_add(1, std::memory_order_relaxed);
+    // Never written, so the next one like it is not a repeat
+    if (first)
+    {
+      repeats_.erase(repeat);
+    }
+    return;
+  }
+  if (held_back_)
+  {
+    out_ << "[WARNING] GL debug output: " << held_back_ << " message(s) held back by the line limit.\n";
+    held_back_ = 0;
+  }
+  write(message, repeat->second.count);
+  repeat->second.written_at = message.timestamp;
+  repeat->second.count = 0;
+}
+
+bool GLDebugLog::takeLine()
+{
+  if (options_.lines_per_second == 0)
+  {
+    return true;
+  }
+  // Refilled continuously, up to a second's worth of lines
+  std::uint64_t const now = Profiler::steadyNanoseconds();
+  double const rate = double(options_.lines_per_second);
+  line_budget_ = std::min(rate, line_budget_ + double(now - budget_time_) * 1e-9 * rate);
+  budget_time_ = now;
+  if (line_budget_ < 1.0)
+  {
+    return false;
+  }
+  line_budget_ -= 1.0;
+  return true;
+}
+
+void GLDebugLog::write(GLDebugMessage const& message, std::uint64_t repeats)
+{
+  out_ << severityLabel(severityOf(message.severity)) << " GL " << sourceName(message.source) << ' '
+    << typeName(message.type) << ' ' << message.id << ": " << message.text;
+  if (message.length >= GLDebugMessage::max_text)
+  {
+    out_ << "...";
+  }
+  if (repeats)
+  {
+    out_ << " (" << repeats << " more since last shown)";
+  }
+  out_ << '\n';
+  written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void GLDebugLog::writeRepeatSummary()
+{
+  for (auto const& [key, repeat] : repeats_)
+  {
+    if (repeat.count)
+    {
+      out_ << "[INFO] GL debug message " << repeat.id << " repeated " << repeat.count << " more time(s).\n";
+    }
+  }
+  if (held_back_)
+  {
+    out_ << "[WARNING] GL debug output: " << held_back_ << " message(s) held back by the line limit.\n";
+  }
+  out_.flush();
+}
+
+}
@@ -0,0 +1,349 @@
+#include <VNgine/gl_intercept.h>
+
+#ifdef VNGINE_GL_INTERCEPT
+
+#include <atomic>
+#include <iostream>
+
+#include <GL/glew.h>
+
+namespace VNgine
+{
+
+namespace
+{
+
+// Relaxed atomics, as the render thread and the main thread take turns owning the context
+struct Counters
+{
+  std::atomic<std::uint64_t> draw_calls{ 0 };
+  std::atomic<std::uint64_t> primitives{ 0 };
+  std::atomic<std::uint64_t> binds{ 0 };
+  std::atomic<std::uint64_t> state_changes{ 0 };
+  std::atomic<std::uint64_t> uniform_calls{ 0 };
+  std::atomic<std::uint64_t> buffer_bytes{ 0 };
+};
+
+Counters counters;
+GLIntercept::Counts last_frame_counts{};
+GLIntercept::Counts total_counts{};
+GLIntercept::Counts summary_counts{};
+std::uint64_t frame_count = 0;
+std::size_t summary_interval = 0;
+bool installed = false;
+
+void tally(std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1)
+{
+  counter.fetch_add(amount, std::memory_order_relaxed);
+}
+
+void countDraw(GLenum mode, GLsizei count, GLsizei instances)
+{
+  std::uint64_t per_instance = 0;
+  std::uint64_t const vertices = count > 0 ? static_cast<std::uint64_t>(count) : 0;
+  switch (mode)
+  {
+  case GL_TRIANGLES:
+    per_instance = vertices / 3;
+    break;
+  case GL_TRIANGLE_STRIP:
+  case GL_TRIANGLE_FAN:
+    per_instance = vertices >= 3 ? vertices - 2 : 0;
+    break;
+  case GL_LINES:
+    per_instance = vertices / 2;
+    break;
+  case GL_LINE_STRIP:
+    per_instance = vertices >= 2 ? vertices - 1 : 0;
+    break;
+  case GL_LINE_LOOP:
+  case GL_POINTS:
+    per_instance = vertices;
+    break;
+  default:
+    break;
+  }
+  tally(counters.draw_calls);
+  tally(counters.primitives, per_instance * static_cast<std::uint64_t>(instances > 0 ? instances : 0));
+}
+
+void add(GLIntercept::Counts& sum, GLIntercept::Counts const& counts)
+{
+  sum.draw_calls += counts.draw_calls;
+  sum.primitives += counts.primitives;
+  sum.binds += counts.binds;
+  sum.state_changes += counts.state_changes;
+  sum.uniform_calls += counts.uniform_calls;
+  sum.buffer_bytes += counts.buffer_bytes;
+}
+
+// Keeps the driver's entry point and defines a wrapper that counts, then forwards to it
+#define VNGINE_GL_HOOK(name, parameters, arguments, counting) \
+  decltype(__glew##name) original_##name = nullptr;           \
+  void GLAPIENTRY hook##name parameters                       \
+  {                                                           \
+    counting;                                                 \
+    original_##name arguments;                                \
+  }
+
+VNGINE_GL_HOOK(DrawArraysInstanced, (GLenum mode, GLint first, GLsizei count, GLsizei instances),
+  (mode, first, count, instances), countDraw(mode, count, instances))
+VNGINE_GL_HOOK(DrawElementsInstanced, (GLenum mode, GLsizei count, GLenum type, void const* indices, GLsizei instances),
+  (mode, count, type, indices, instances), countDraw(mode, count, instances))
+VNGINE_GL_HOOK(DrawArraysInstancedBaseInstance,
+  (GLenum mode, GLint first, GLsizei count, GLsizei instances, GLuint base_instance),
+  (mode, first, count, instances, base_instance), countDraw(mode, count, instances))
+VNGINE_GL_HOOK(DrawElementsInstancedBaseInstance,
+  (GLenum mode, GLsizei count, GLenum type, void const* indices, GLsizei instances, GLuint base_instance),
+  (mode, count, type, indices, instances, base_instance), countDraw(mode, count, instances))
+VNGINE_GL_HOOK(DrawElementsBaseVertex, (GLenum mode, GLsizei count, GLenum type, void const* indices, GLint base_vertex),
+  (mode, count, type, indices, base_vertex), countDraw(mode, count, 1))
+VNGINE_GL_HOOK(DrawRangeElements,
+  (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, void const* indices),
+  (mode, start, end, count, type, indices), countDraw(mode, count, 1))
+VNGINE_GL_HOOK(MultiDrawArraysIndirect, (GLenum mode, void const* indirect, GLsizei draws, GLsizei stride),
+  (mode, indirect, draws, stride), tally(counters.draw_calls, static_cast<std::uint64_t>(draws)))
+VNGINE_GL_HOOK(MultiDrawElementsIndirect,
+  (GLenum mode, GLenum type, void const* indirect, GLsizei draws, GLsizei stride),
+  (mode, type, indirect, draws, stride), tally(counters.draw_calls, static_cast<std::uint64_t>(draws)))
+
+VNGINE_GL_HOOK(BindBuffer, (GLenum target, GLuint buffer), (target, buffer), tally(counters.binds))
+VNGINE_GL_HOOK(BindBufferBase, (GLenum target, GLuint index, GLuint buffer), (target, index, buffer),
+  tally(counters.binds))
+VNGINE_GL_HOOK(BindBufferRange, (GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size),
+  (target, index, buffer, offset, size), tally(counters.binds))
+VNGINE_GL_HOOK(BindVertexArray, (GLuint vertex_array), (vertex_array), tally(counters.binds))
+VNGINE_GL_HOOK(BindFramebuffer, (GLenum target, GLuint framebuffer), (target, framebuffer), tally(counters.binds))
+VNGINE_GL_HOOK(BindRenderbuffer, (GLenum target, GLuint renderbuffer), (target, renderbuffer), tally(counters.binds))
+VNGINE_GL_HOOK(BindSampler, (GLuint unit, GLuint sampler), (unit, sampler), tally(counters.binds))
+VNGINE_GL_HOOK(UseProgram, (GLuint program), (program), tally(counters.binds))
+
+VNGINE_GL_HOOK(ActiveTexture, (GLenum unit), (unit), tally(counters.state_changes))
+VNGINE_GL_HOOK(BlendFuncSeparate, (GLenum source_rgb, GLenum destination_rgb, GLenum source_alpha, GLenum destination_alpha),
+  (source_rgb, destination_rgb, source_alpha, destination_alpha), tally(counters.state_changes))
+VNGINE_GL_HOOK(BlendEquation, (GLenum mode), (mode), tally(counters.state_changes))
+VNGINE_GL_HOOK(VertexAttribPointer,
+  (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, void const* pointer),
+  (index, size, type, normalized, stride, pointer), tally(counters.state_changes))
+VNGINE_GL_HOOK(VertexAttribIPointer, (GLuint index, GLint size, GLenum type, GLsizei stride, void const* pointer),
+  (index, size, type, stride, pointer), tally(counters.state_changes))
+VNGINE_GL_HOOK(EnableVertexAttribArray, (GLuint index), (index), tally(counters.state_changes))
+VNGINE_GL_HOOK(DisableVertexAttribArray, (GLuint index), (index), tally(counters.state_changes))
+VNGINE_GL_HOOK(VertexAttribDivisor, (GLuint index, GLuint divisor), (index, divisor), tally(counters.state_changes))
+
+VNGINE_GL_HOOK(Uniform1i, (GLint location, GLint value), (location, value), tally(counters.uniform_calls))
+VNGINE_GL_HOOK(Uniform1f, (GLint location, GLfloat value), (location, value), tally(counters.uniform_calls))
+#define VNGINE_GL_UNIFORM_HOOK(name, type)                                                                   \
+  VNGINE_GL_HOOK(name, (GLint location, GLsizei count, type const* values), (location, count, values),       \
+    tally(counters.uniform_calls))
+VNGINE_GL_UNIFORM_HOOK(Uniform1fv, GLfloat)
+VNGINE_GL_UNIFORM_HOOK(Uniform2fv, GLfloat)
+VNGINE_GL_UNIFORM_HOOK(Uniform3fv, GLfloat)
+VNGINE_GL_UNIFORM_HOOK(Uniform4fv, GLfloat)
+VNGINE_GL_UNIFORM_HOOK(Uniform1iv, GLint)
+VNGINE_GL_UNIFORM_HOOK(Uniform2iv, GLint)
+VNGINE_GL_UNIFORM_HOOK(Uniform3iv, GLint)
+VNGINE_GL_UNIFORM_HOOK(Uniform4iv, GLint)
+VNGINE_GL_UNIFORM_HOOK(Uniform1uiv, GLuint)
+VNGINE_GL_UNIFORM_HOOK(Uniform2uiv, GLuint)
+VNGINE_GL_UNIFORM_HOOK(Uniform3uiv, GLuint)
+VNGINE_GL_UNIFORM_HOOK(Uniform4uiv, GLuint)
+VNGINE_GL_UNIFORM_HOOK(Uniform1dv, GLdouble)
+VNGINE_GL_UNIFORM_HOOK(Uniform2dv, GLdouble)
+VNGINE_GL_UNIFORM_HOOK(Uniform3dv, GLdouble)
+VNGINE_GL_UNIFORM_HOOK(Uniform4dv, GLdouble)
+#define VNGINE_GL_MATRIX_HOOK(name, type)                                                                    \
+  VNGINE_GL_HOOK(name, (GLint location, GLsizei count, GLboolean transpose, type const* values),              \
+    (location, count, transpose, values), tally(counters.uniform_calls))
+VNGINE_GL_MATRIX_HOOK(UniformMatrix2fv, GLfloat)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix3fv, GLfloat)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix4fv, GLfloat)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix2x3fv, GLfloat)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix3x2fv, GLfloat)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix2x4fv, GLfloat)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix4x2fv, GLfloat)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix3x4fv, GLfloat)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix4x3fv, GLfloat)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix2dv, GLdouble)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix3dv, GLdouble)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix4dv, GLdouble)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix2x3dv, GLdouble)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix3x2dv, GLdouble)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix2x4dv, GLdouble)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix4x2dv, GLdouble)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix3x4dv, GLdouble)
+VNGINE_GL_MATRIX_HOOK(UniformMatrix4x3dv, GLdouble)
+VNGINE_GL_HOOK(UniformBlockBinding, (GLuint program, GLuint block, GLuint binding), (program, block, binding),
+  tally(counters.uniform_calls))
+
+// Allocating without data uploads nothing
+VNGINE_GL_HOOK(BufferData, (GLenum target, GLsizeiptr size, void const* data, GLenum usage),
+  (target, size, data, usage), tally(counters.buffer_bytes, data ? static_cast<std::uint64_t>(size) : 0))
+VNGINE_GL_HOOK(BufferSubData, (GLenum target, GLintptr offset, GLsizeiptr size, void const* data),
+  (target, offset, size, data), tally(counters.buffer_bytes, static_cast<std::uint64_t>(size)))
+VNGINE_GL_HOOK(BufferStorage, (GLenum target, GLsizeiptr size, void const* data, GLbitfield flags),
+  (target, size, data, flags), tally(counters.buffer_bytes, data ? static_cast<std::uint64_t>(size) : 0))
+VNGINE_GL_HOOK(FlushMappedBufferRange, (GLenum target, GLintptr offset, GLsizeiptr length),
+  (target, offset, length), tally(counters.buffer_bytes, static_cast<std::uint64_t>(length)))
+
+#undef VNGINE_GL_MATRIX_HOOK
+#undef VNGINE_GL_UNIFORM_HOOK
+#undef VNGINE_GL_HOOK
+
+GLIntercept::Counts read(Counters const& source)
+{
+  return {
+    source.draw_calls.load(std::memory_order_relaxed),
+    source.primitives.load(std::memory_order_relaxed),
+    source.binds.load(std::memory_order_relaxed),
+    source.state_changes.load(std::memory_order_relaxed),
+    source.uniform_calls.load(std::memory_order_relaxed),
+    source.buffer_bytes.load(std::memory_order_relaxed),
+  };
+}
+
+}
+
+void GLIntercept::install()
+{
+  // Skips entry points the driver lacks, and any already wrapped
+#define VNGINE_GL_INSTALL(name)                    \
+  if (__glew##name && __glew##name != &hook##name) \
+  {                                                \
+    original_##name = __glew##name;                \
+    __glew##name = &hook##name;                    \
+  }
+  VNGINE_GL_INSTALL(DrawArraysInstanced)
+  VNGINE_GL_INSTALL(DrawElementsInstanced)
+  VNGINE_GL_INSTALL(DrawArraysInstancedBaseInstance)
+  VNGINE_GL_INSTALL(DrawElementsInstancedBaseInstance)
+  VNGINE_GL_INSTALL(DrawElementsBaseVertex)
+  VNGINE_GL_INSTALL(DrawRangeElements)
+  VNGINE_GL_INSTALL(MultiDrawArraysIndirect)
+  VNGINE_GL_INSTALL(MultiDrawElementsIndirect)
+  VNGINE_GL_INSTALL(BindBuffer)
+  VNGINE_GL_INSTALL(BindBufferBase)
+  VNGINE_GL_INSTALL(BindBufferRange)
+  VNGINE_GL_INSTALL(BindVertexArray)
+  VNGINE_GL_INSTALL(BindFramebuffer)
+  VNGINE_GL_INSTALL(BindRenderbuffer)
+  VNGINE_GL_INSTALL(BindSampler)
+  VNGINE_GL_INSTALL(UseProgram)
+  VNGINE_GL_INSTALL(ActiveTexture)
+  VNGINE_GL_INSTALL(BlendFuncSeparate)
+  VNGINE_GL_INSTALL(BlendEquation)
+  VNGINE_GL_INSTALL(VertexAttribPointer)
+  VNGINE_GL_INSTALL(VertexAttribIPointer)
+  VNGINE_GL_INSTALL(EnableVertexAttribArray)
+  VNGINE_GL_INSTALL(DisableVertexAttribArray)
+  VNGINE_GL_INSTALL(VertexAttribDivisor)
+  VNGINE_GL_INSTALL(Uniform1i)
+  VNGINE_GL_INSTALL(Uniform1f)
+  VNGINE_GL_INSTALL(Uniform1fv)
+  VNGINE_GL_INSTALL(Uniform2fv)
+  VNGINE_GL_INSTALL(Uniform3fv)
+  VNGINE_GL_INSTALL(Uniform4fv)
+  VNGINE_GL_INSTALL(Uniform1iv)
+  VNGINE_GL_INSTALL(Uniform2iv)
+  VNGINE_GL_INSTALL(Uniform3iv)
+  VNGINE_GL_INSTALL(Uniform4iv)
+  VNGINE_GL_INSTALL(Uniform1uiv)
+  VNGINE_GL_INSTALL(Uniform2uiv)
+  VNGINE_GL_INSTALL(Uniform3uiv)
+  VNGINE_GL_INSTALL(Uniform4uiv)
+  VNGINE_GL_INSTALL(Uniform1dv)
+  VNGINE_GL_INSTALL(Uniform2dv)
+  VNGINE_GL_INSTALL(Uniform3dv)
+  VNGINE_GL_INSTALL(Uniform4dv)
+  VNGINE_GL_INSTALL(UniformMatrix2fv)
+  VNGINE_GL_INSTALL(UniformMatrix3fv)
+  VNGINE_GL_INSTALL(UniformMatrix4fv)
+  VNGINE_GL_INSTALL(UniformMatrix2x3fv)
+  VNGINE_GL_INSTALL(UniformMatrix3x2fv)
+  VNGINE_GL_INSTALL(UniformMatrix2x4fv)
+  VNGINE_GL_INSTALL(UniformMatrix4x2fv)
+  VNGINE_GL_INSTALL(UniformMatrix3x4fv)
+  VNGINE_GL_INSTALL(UniformMatrix4x3fv)
+  VNGINE_GL_INSTALL(UniformMatrix2dv)
+  VNGINE_GL_INSTALL(UniformMatrix3dv)
+  VNGINE_GL_INSTALL(UniformMatrix4dv)
+  VNGINE_GL_INSTALL(UniformMatrix2x3dv)
+  VNGINE_GL_INSTALL(UniformMatrix3x2dv)
+  VNGINE_GL_INSTALL(UniformMatrix2x4dv)
+  VNGINE_GL_INSTALL(UniformMatrix4x2dv)
+  VNGINE_GL_INSTALL(UniformMatrix3x4dv)
+  VNGINE_GL_INSTALL(UniformMatrix4x3dv)
+  VNGINE_GL_INSTALL(UniformBlockBinding)
+  VNGINE_GL_INSTALL(BufferData)
+  VNGINE_GL_INSTALL(BufferSubData)
+  VNGINE_GL_INSTALL(BufferStorage)
+  VNGINE_GL_INSTALL(FlushMappedBufferRange)
+#undef VNGINE_GL_INSTALL
+  installed = true;
+}
+
+bool GLIntercept::isInstalled()
+{
+  return installed;
+}
+
+GLIntercept::Counts GLIntercept::frame()
+{
+  return read(counters);
+}
+
+void GLIntercept::countMappedWrite(std::size_t bytes)
+{
+  tally(counters.buffer_bytes, bytes);
+}
+
+GLIntercept::Counts const& GLIntercept::lastFrame()
+{
+  return last_frame_counts;
+}
+
+GLIntercept::Counts const& GLIntercept::total()
+{
+  return total_counts;
+}
+
+std::uint64_t GLIntercept::frameCount()
+{
+  return frame_count;
+}
+
+void GLIntercept::endFrame()
+{
+  last_frame_counts = read(counters);
+  counters.draw_calls.store(0, std::memory_order_relaxed);
+  counters.primitives.store(0, std::memory_order_relaxed);
+  counters.binds.store(0, std::memory_order_relaxed);
+  counters.state_changes.store(0, std::memory_order_relaxed);
+  counters.uniform_calls.store(0, std::memory_order_relaxed);
+  counters.buffer_bytes.store(0, std::memory_order_relaxed);
+  add(total_counts, last_frame_counts);
+  add(summary_counts, last_frame_counts);
+  ++frame_count;
+
+  if (summary_interval && frame_count % summary_interval == 0)
+  {
+    double const n = static_cast<double>(summary_interval);
+    std::cout << "[INFO] GL calls per frame over " << summary_interval << " frames: "
+      << summary_counts.draw_calls / n << " draws, "
+      << summary_counts.primitives / n << " primitives, "
+      << summary_counts.binds / n << " binds, "
+      << summary_counts.state_changes / n << " state changes, "
+      << summary_counts.uniform_calls / n << " uniform calls, "
+      << summary_counts.buffer_bytes / n / 1024.0 << " KiB uploaded.\n";
+    summary_counts = {};
+  }
+}
+
+void GLIntercept::setSummaryInterval(std::size_t frames)
+{
+  summary_interval = frames;
+}
+
+}
+
+#endif
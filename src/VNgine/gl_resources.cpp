@@ -0,0 +1,293 @@
+#include <VNgine/gl_resources.h>
+#include <VNgine/gl_state.h>
+
+#include <cassert>
+#include <iostream>
+
+namespace VNgine
+{
+
+namespace
+{
+
+thread_local GLResources* current_resources = nullptr;
+
+// Long enough for any frame the GPU is still working on
+constexpr GLuint64 reset_timeout_ns = 1'000'000'000;
+
+}
+
+GLResources::~GLResources()
+{
+  if (current_resources == this)
+  {
+    current_resources = nullptr;
+  }
+  std::size_t owned = 0;
+  for (Table const& table : tables_)
+  {
+    owned += table.names.size();
+  }
+  assert(owned == 0 && stats().pending == 0 && "GLResources destroyed without reset().");
+  (void)owned;
+}
+
+void GLResources::makeCurrent()
+{
+  current_resources = this;
+}
+
+GLResources* GLResources::current()
+{
+  return current_resources;
+}
+
+void GLResources::clearCurrent()
+{
+  current_resources = nullptr;
+}
+
+GLShaderHandle GLResources::createShader(GLenum kind)
+{
+  return adopt<GLResourceType::SHADER>(glCreateShader(kind));
+}
+
+array_view<GLuint const> GLResources::names(GLResourceType type) const
+{
+  std::vector<GLuint> const& names = tables_[to_integral(type)].names;
+  return { names.data(), names.size() };
+}
+
+void GLResources::retire(GLResourceType type, GLuint name)
+{
+  if (name == 0)
+  {
+    return;
+  }
+  if (current_resources)
+  {
+    current_resources->queue(type, name);
+    return;
+  }
+  std::vector<GLuint> const names{ name };
+  destroy(type, names);
+}
+
+void GLResources::endFrame()
+{
+  bool retired = false;
+  for (std::vector<GLuint> const& names : current_frame_.names)
+  {
+    retired = retired || !names.empty();
+  }
+  if (retired)
+  {
+    current_frame_.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    in_flight_.push_back(std::move(current_frame_));
+    if (spare_frames_.empty())
+    {
+      current_frame_ = RetiredFrame{};
+    }
+    else
+    {
+      current_frame_ = std::move(spare_frames_.back());
+      spare_frames_.pop_back();
+    }
+  }
+
+  // Fences signal in order, so the first one still pending ends the search
+  while (!in_flight_.empty())
+  {
+    GLenum const status = glClientWaitSync(in_flight_.front().fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED)
+    {
+      break;
+    }
+    if (status == GL_WAIT_FAILED)
+    {
+      std::cerr << "[ERROR] Waiting on a deletion fence failed; deleting its objects anyway.\n";
+    }
+    destroy(in_flight_.front());
+    spare_frames_.push_back(std::move(in_flight_.front()));
+    in_flight_.pop_front();
+  }
+}
+
+void GLResources::reset()
+{
+  for (std::size_t type = 0; type < type_count; ++type)
+  {
+    Table& table = tables_[type];
+    std::vector<GLuint>& retired = current_frame_.names[type];
+    retired.insert(retired.end(), table.names.begin(), table.names.end());
+    stats_.retired += table.names.size();
+    table = Table{};
+  }
+  for (RetiredFrame& frame : in_flight_)
+  {
+    glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, reset_timeout_ns);
+    destroy(frame);
+  }
+  in_flight_.clear();
+  // Owned until now, or retired this frame: nothing was drawn with them since
+  destroy(current_frame_);
+  spare_frames_.clear();
+}
+
+GLResources::Stats GLResources::stats() const
+{
+  Stats stats = stats_;
+  for (std::size_t type = 0; type < type_count; ++type)
+  {
+    stats.live[type] = tables_[type].names.size();
+  }
+  stats.pending = stats.retired - stats.deleted;
+  stats.stale_lookups = stale_lookups_;
+  return stats;
+}
+
+std::uint32_t GLResources::insert(GLResourceType type, GLuint name)
+{
+  Table& table = tables_[to_integral(type)];
+  std::uint32_t slot = table.free_slot;
+  if (slot == none)
+  {
+    slot = static_cast<std::uint32_t>(table.generations.size());
+    assert(slot <= GLBufferHandle::index_mask && "Out of GL handle slots.");
+    table.generations.push_back(1);
+    table.positions.push_back(0);
+  }
+  else
+  {
+    table.free_slot = table.positions[slot];
+  }
+  table.positions[slot] = static_cast<std::uint32_t>(table.names.size());
+  table.names.push_back(name);
+  table.slots.push_back(slot);
+  ++stats_.created;
+  return (std::uint32_t(table.generations[slot]) << GLBufferHandle::index_bits) | slot;
+}
+
+void GLResources::remove(GLResourceType type, std::uint32_t value)
+{
+  GLuint const name = lookup(type, value);
+  assert(name != 0 && "Released a stale GL handle.");
+  if (name == 0)
+  {
+    return;
+  }
+  Table& table = tables_[to_integral(type)];
+  std::uint32_t const slot = value & GLBufferHandle::index_mask;
+  // The last live object fills the hole, keeping the names packed
+  std::uint32_t const position = table.positions[slot];
+  std::uint32_t const last = table.slots.back();
+  table.names[position] = table.names.back();
+  table.slots[position] = last;
+  table.positions[last] = position;
+  table.names.pop_back();
+  table.slots.pop_back();
+
+  // Generation 0 is skipped, so no handle is ever 0
+  std::uint16_t& generation = table.generations[slot];
+  generation = static_cast<std::uint16_t>((generation & generation_mask) == generation_mask ? 1 : generation + 1);
+  table.positions[slot] = table.free_slot;
+  table.free_slot = slot;
+  queue(type, name);
+}
+
+void GLResources::queue(GLResourceType type, GLuint name)
+{
+  current_frame_.names[to_integral(type)].push_back(name);
+  ++stats_.retired;
+}
+
+void GLResources::destroy(RetiredFrame& frame)
+{
+  for (std::size_t type = 0; type < type_count; ++type)
+  {
+    std::vector<GLuint>& names = frame.names[type];
+    if (names.empty())
+    {
+      continue;
+    }
+    destroy(GLResourceType(type), names);
+    stats_.deleted += names.size();
+    ++stats_.delete_calls;
+    names.clear();
+  }
+  if (frame.fence)
+  {
+    glDeleteSync(frame.fence);
+    frame.fence = nullptr;
+  }
+}
+
+void GLResources::destroy(GLResourceType type, std::vector<GLuint> const& names)
+{
+  GLState& gl = GLState::current();
+  GLsizei const count = static_cast<GLsizei>(names.size());
+  switch (type)
+  {
+  case GLResourceType::BUFFER:
+    gl.deleteBuffers(count, names.data());
+    break;
+  case GLResourceType::VERTEX_ARRAY:
+    gl.deleteVertexArrays(count, names.data());
+    break;
+  case GLResourceType::TEXTURE:
+    gl.deleteTextures(count, names.data());
+    break;
+  case GLResourceType::FRAMEBUFFER:
+    gl.deleteFramebuffers(count, names.data());
+    break;
+  case GLResourceType::RENDERBUFFER:
+    glDeleteRenderbuffers(count, names.data());
+    break;
+  // No batched form for these two
+  case GLResourceType::SHADER:
+    for (GLuint const name : names)
+    {
+      glDeleteShader(name);
+    }
+    break;
+  case GLResourceType::PROGRAM:
+    for (GLuint const name : names)
+    {
+      gl.deleteProgram(name);
+    }
+    break;
+  default:
+    assert(!"Unknown GL resource type");
+  }
+}
+
+GLuint GLResources::generate(GLResourceType type)
+{
+  GLuint name = 0;
+  switch (type)
+  {
+  case GLResourceType::BUFFER:
+    glGenBuffers(1, &name);
+    break;
+  case GLResourceType::VERTEX_ARRAY:
+    glGenVertexArrays(1, &name);
+    break;
+  case GLResourceType::TEXTURE:
+    glGenTextures(1, &name);
+    break;
+  case GLResourceType::FRAMEBUFFER:
+    glGenFramebuffers(1, &name);
+    break;
+  case GLResourceType::RENDERBUFFER:
+    glGenRenderbuffers(1, &name);
+    break;
+  case GLResourceType::PROGRAM:
+    name = glCreateProgram();
+    break;
+  default:
+    assert(!"Shaders are created with createShader()");
+  }
+  return name;
+}
+
+}
@@ -0,0 +1,386 @@
+#include <VNgine/gl_state.h>
+
+namespace VNgine
+{
+
+namespace
+{
+
+thread_local GLState* current_state = nullptr;
+
+constexpr GLenum buffer_target_table[] = {
+  GL_ARRAY_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER,
+  GL_TEXTURE_BUFFER, GL_UNIFORM_BUFFER, GL_DRAW_INDIRECT_BUFFER, GL_TRANSFORM_FEEDBACK_BUFFER
+};
+
+constexpr GLenum texture_target_table[] = {
+  GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_3D, GL_TEXTURE_1D,
+  GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_RECTANGLE, GL_TEXTURE_BUFFER
+};
+
+constexpr GLenum capability_table[] = {
+  GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_SCISSOR_TEST, GL_STENCIL_TEST, GL_POLYGON_OFFSET_FILL,
+  GL_RASTERIZER_DISCARD, GL_PROGRAM_POINT_SIZE, GL_FRAMEBUFFER_SRGB, GL_MULTISAMPLE,
+  GL_SAMPLE_ALPHA_TO_COVERAGE, GL_DEPTH_CLAMP, GL_PRIMITIVE_RESTART
+};
+
+// Position of `value` in `table`, or the table size if it is not there
+template <std::size_t N>
+constexpr std::size_t indexOf(GLenum const (&table)[N], GLenum value)
+{
+  std::size_t i = 0;
+  while (i < N && table[i] != value)
+  {
+    ++i;
+  }
+  return i;
+}
+
+}
+
+GLState::GLState()
+  : GLState{ true }
+{}
+
+GLState::GLState(bool tracking)
+  : tracking_{ tracking }
+{
+  static_assert(sizeof(buffer_target_table) / sizeof(GLenum) == buffer_targets);
+  static_assert(sizeof(texture_target_table) / sizeof(GLenum) == texture_targets);
+  static_assert(sizeof(capability_table) / sizeof(GLenum) == capabilities);
+  invalidate();
+}
+
+GLState::~GLState()
+{
+  if (current_state == this)
+  {
+    current_state = nullptr;
+  }
+}
+
+void GLState::makeCurrent()
+{
+  current_state = this;
+}
+
+void GLState::clearCurrent()
+{
+  current_state = nullptr;
+}
+
+GLState& GLState::current()
+{
+  if (current_state)
+  {
+    return *current_state;
+  }
+  thread_local GLState pass_through{ false };
+  return pass_through;
+}
+
+void GLState::invalidate()
+{
+  program_ = unknown;
+  vertex_array_ = unknown;
+  active_texture_ = unknown;
+  draw_framebuffer_ = unknown;
+  read_framebuffer_ = unknown;
+  buffers_.fill(unknown);
+  uniform_buffers_.fill(unknown);
+  for (auto& unit : textures_)
+  {
+    unit.fill(unknown);
+  }
+  viewport_ = { -1, -1, -1, -1 };
+  blend_func_.fill(unknown);
+  capabilities_known_ = 0;
+}
+
+bool GLState::change(GLuint& cached, GLuint value)
+{
+  if (tracking_ && cached == value)
+  {
+    ++stats_.skipped;
+    return false;
+  }
+  cached = value;
+  ++stats_.issued;
+  return true;
+}
+
+void GLState::useProgram(GLuint program)
+{
+  if (change(program_, program))
+  {
+    glUseProgram(program);
+  }
+}
+
+void GLState::bindVertexArray(GLuint vertex_array)
+{
+  if (change(vertex_array_, vertex_array))
+  {
+    glBindVertexArray(vertex_array);
+  }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer)
+{
+  std::size_t const slot = indexOf(buffer_target_table, target);
+  // Element array bindings belong to the vertex array, so they are not tracked here
+  GLuint untracked = unknown;
+  if (change((slot < buffer_targets) ? buffers_[slot] : untracked, buffer))
+  {
+    glBindBuffer(target, buffer);
+  }
+}
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+  GLuint untracked = unknown;
+  GLuint& cached = (target == GL_UNIFORM_BUFFER && index < uniform_buffer_bindings) ? uniform_buffers_[index] : untracked;
+  if (change(cached, buffer))
+  {
+    glBindBufferBase(target, index, buffer);
+    // Also binds the generic binding point
+    std::size_t const slot = indexOf(buffer_target_table, target);
+    if (slot < buffer_targets)
+    {
+      buffers_[slot] = buffer;
+    }
+  }
+}
+
+void GLState::activeTexture(GLuint unit)
+{
+  if (change(active_texture_, unit))
+  {
+    glActiveTexture(GL_TEXTURE0 + unit);
+  }
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture)
+{
+  std::size_t const slot = indexOf(texture_target_table, target);
+  GLuint untracked = unknown;
+  GLuint& cached = (active_texture_ < texture_units && slot < texture_targets) ? textures_[active_texture_][slot] : untracked;
+  if (change(cached, texture))
+  {
+    glBindTexture(target, texture);
+  }
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+  std::size_t const slot = indexOf(texture_target_table, target);
+  // Skip the unit switch too when the texture is already there
+  if (tracking_ && unit < texture_units && slot < texture_targets && textures_[unit][slot] == texture)
+  {
+    ++stats_.skipped;
+    return;
+  }
+  activeTexture(unit);
+  bindTexture(target, texture);
+}
+
+void GLState::bindFramebuffer(GLenum target, GLuint framebuffer)
+{
+  if (target != GL_FRAMEBUFFER)
+  {
+    if (change((target == GL_READ_FRAMEBUFFER) ? read_framebuffer_ : draw_framebuffer_, framebuffer))
+    {
+      glBindFramebuffer(target, framebuffer);
+    }
+    return;
+  }
+  // GL_FRAMEBUFFER binds both the draw and the read framebuffer
+  if (tracking_ && draw_framebuffer_ == framebuffer && read_framebuffer_ == framebuffer)
+  {
+    ++stats_.skipped;
+    return;
+  }
+  draw_framebuffer_ = framebuffer;
+  read_framebuffer_ = framebuffer;
+  ++stats_.issued;
+  glBindFramebuffer(target, framebuffer);
+}
+
+void GLState::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+  std::array<GLint, 4> const viewport{ x, y, width, height };
+  if (tracking_ && viewport_ == viewport)
+  {
+    ++stats_.skipped;
+    return;
+  }
+  viewport_ = viewport;
+  ++stats_.issued;
+  glViewport(x, y, width, height);
+}
+
+void GLState::blendFunc(GLenum source, GLenum destination)
+{
+  std::array<GLuint, 2> const blend_func{ source, destination };
+  if (tracking_ && blend_func_ == blend_func)
+  {
+    ++stats_.skipped;
+    return;
+  }
+  blend_func_ = blend_func;
+  ++stats_.issued;
+  glBlendFunc(source, destination);
+}
+
+void GLState::enable(GLenum capability)
+{
+  std::size_t const slot = indexOf(capability_table, capability);
+  if (!tracking_ || slot == capabilities)
+  {
+    ++stats_.issued;
+    glEnable(capability);
+    return;
+  }
+  capabilities_wanted_ |= 1u << slot;
+  capabilities_touched_ |= 1u << slot;
+}
+
+void GLState::disable(GLenum capability)
+{
+  std::size_t const slot = indexOf(capability_table, capability);
+  if (!tracking_ || slot == capabilities)
+  {
+    ++stats_.issued;
+    glDisable(capability);
+    return;
+  }
+  capabilities_wanted_ &= ~(1u << slot);
+  capabilities_touched_ |= 1u << slot;
+}
+
+void GLState::flush()
+{
+  std::uint32_t const stale = ((capabilities_wanted_ ^ capabilities_applied_) | ~capabilities_known_) & capabilities_touched_;
+  for (std::size_t slot = 0; slot < capabilities; ++slot)
+  {
+    std::uint32_t const bit = 1u << slot;
+    if (!(capabilities_touched_ & bit))
+    {
+      continue;
+    }
+    if (!(stale & bit))
+    {
+      ++stats_.skipped;
+      continue;
+    }
+    if (capabilities_wanted_ & bit)
+    {
+      glEnable(capability_table[slot]);
+    }
+    else
+    {
+      glDisable(capability_table[slot]);
+    }
+    ++stats_.issued;
+  }
+  capabilities_applied_ = (capabilities_applied_ & ~capabilities_touched_) | (capabilities_wanted_ & capabilities_touched_);
+  capabilities_known_ |= capabilities_touched_;
+  capabilities_touched_ = 0;
+}
+
+void GLState::deleteProgram(GLuint program)
+{
+  // A program in use stays current, and keeps its name, until another is bound
+  glDeleteProgram(program);
+}
+
+void GLState::deleteVertexArray(GLuint vertex_array)
+{
+  deleteVertexArrays(1, &vertex_array);
+}
+
+void GLState::deleteBuffer(GLuint buffer)
+{
+  deleteBuffers(1, &buffer);
+}
+
+void GLState::deleteTexture(GLuint texture)
+{
+  deleteTextures(1, &texture);
+}
+
+void GLState::deleteFramebuffer(GLuint framebuffer)
+{
+  deleteFramebuffers(1, &framebuffer);
+}
+
+void GLState::deleteVertexArrays(GLsizei count, GLuint const* vertex_arrays)
+{
+  glDeleteVertexArrays(count, vertex_arrays);
+  for (GLsizei i = 0; i < count; ++i)
+  {
+    if (vertex_array_ == vertex_arrays[i])
+    {
+      vertex_array_ = 0;
+    }
+  }
+}
+
+void GLState::deleteBuffers(GLsizei count, GLuint const* buffers)
+{
+  glDeleteBuffers(count, buffers);
+  for (GLsizei i = 0; i < count; ++i)
+  {
+    for (GLuint& bound : buffers_)
+    {
+      bound = (bound == buffers[i]) ? 0 : bound;
+    }
+    for (GLuint& bound : uniform_buffers_)
+    {
+      bound = (bound == buffers[i]) ? 0 : bound;
+    }
+  }
+}
+
+void GLState::deleteTextures(GLsizei count, GLuint const* textures)
+{
+  glDeleteTextures(count, textures);
+  for (GLsizei i = 0; i < count; ++i)
+  {
+    for (auto& unit : textures_)
+    {
+      for (GLuint& bound : unit)
+      {
+        bound = (bound == textures[i]) ? 0 : bound;
+      }
+    }
+  }
+}
+
+void GLState::deleteFramebuffers(GLsizei count, GLuint const* framebuffers)
+{
+  glDeleteFramebuffers(count, framebuffers);
+  for (GLsizei i = 0; i < count; ++i)
+  {
+    draw_framebuffer_ = (draw_framebuffer_ == framebuffers[i]) ? 0 : draw_framebuffer_;
+    read_framebuffer_ = (read_framebuffer_ == framebuffers[i]) ? 0 : read_framebuffer_;
+  }
+}
+
+GLState::Stats const& GLState::stats() const
+{
+  return stats_;
+}
+
+GLState::Stats const& GLState::lastFrame() const
+{
+  return last_frame_;
+}
+
+void GLState::endFrame()
+{
+  last_frame_ = stats_;
+  stats_ = {};
+}
+
+}
@@ -1,42 +1,53 @@
 #include <VNgine/input.h>
 
-#include <iostream>
-
 namespace VNgine
 {
 
-void g_keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+Input::Input(Window const& window)
+  : window_{ window.getHandle() },
+    key_callback_thunk_{ &queue_, &InputQueue::keyCallback },
+    char_callback_thunk_{ &queue_, &InputQueue::charCallback },
+    cursor_pos_callback_thunk_{ &queue_, &InputQueue::cursorPosCallback },
+    scroll_callback_thunk_{ &queue_, &InputQueue::scrollCallback },
+    mouse_button_callback_thunk_{ &queue_, &InputQueue::mouseButtonCallback }
 {
-  std::cout << "Key: " << (char)key << "\n";
+  // The thunk callbacks can be called from a C library like GLFW
+  glfwSetKeyCallback(window_, key_callback_thunk_.getCallback());
+  glfwSetCharCallback(window_, char_callback_thunk_.getCallback());
+  glfwSetCursorPosCallback(window_, cursor_pos_callback_thunk_.getCallback());
+  glfwSetScrollCallback(window_, scroll_callback_thunk_.getCallback());
+  glfwSetMouseButtonCallback(window_, mouse_button_callback_thunk_.getCallback());
 }
 
-Input::Input(Window const& window)
-  : member_{ 0x69 },
-    key_callback_thunk_{ this, &Input::keyCallback }
+Input::~Input()
 {
-  // The thunk callback can be called from a C library like GLFW
-  glfwSetKeyCallback(window.getHandle(), key_callback_thunk_.getCallback());
+  // The thunks die with us, so GLFW must stop calling them
+  glfwSetKeyCallback(window_, nullptr);
+  glfwSetCharCallback(window_, nullptr);
+  glfwSetCursorPosCallback(window_, nullptr);
+  glfwSetScrollCallback(window_, nullptr);
+  glfwSetMouseButtonCallback(window_, nullptr);
 }
 
+array_view<InputEvent const> Input::drain()
+{
+  array_view<InputEvent const> const events = queue_.drain();
+  state_.beginFrame();
+  for (InputEvent const& event : events)
+  {
+    state_.apply(event);
+  }
+  return events;
+}
 
-  /* Press G without pushing any other buttons. This should print:
-
-Window: 0x000002CACB024AA0 [Not this exact pointer, some pointer]
-Key: G
-Scancode: 0x22
-Action: 1
-Mods: 0
-Member is: 105
+std::size_t Input::droppedEvents() const
+{
+  return queue_.droppedEvents();
+}
 
-   */
-void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+InputState const& Input::state() const
 {
-  std::cout << "Window: 0x" << window << "\n";
-  std::cout << "Key: " << (char)key << "\n";
-  std::cout << "Scancode: 0x" << std::hex << scancode << std::dec << "\n";
-  std::cout << "Action: " << action << "\n";
-  std::cout << "Mods: " << mods << "\n";
-  std::cout << "Member is: " << member_ << "\n";
+  return state_;
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,82 @@
+#include <VNgine/input_queue.h>
+
+#include <chrono>
+
+namespace VNgine
+{
+
+namespace
+{
+
+std::uint64_t now()
+{
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+}
+
+InputQueue::InputQueue()
+{
+  frame_events_.reserve(capacity);
+}
+
+array_view<InputEvent const> InputQueue::drain()
+{
+  frame_events_.clear();
+  events_.consume([this](InputEvent const& event)
+  {
+    if (event.type == InputEvent::Type::CursorPos
+        && !frame_events_.empty() && frame_events_.back().type == InputEvent::Type::CursorPos)
+    {
+      frame_events_.back() = event;
+    }
+    else
+    {
+      frame_events_.push_back(event);
+    }
+  });
+  return { frame_events_.data(), frame_events_.size() };
+}
+
+std::size_t InputQueue::droppedEvents() const
+{
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+void InputQueue::keyCallback(GLFWwindow*, int key, int scancode, int action, int mods)
+{
+  push({ InputEvent::Type::Key, static_cast<std::uint8_t>(action), static_cast<std::uint16_t>(mods),
+         key, scancode, 0.0f, 0.0f, now() });
+}
+
+void InputQueue::charCallback(GLFWwindow*, unsigned int codepoint)
+{
+  push({ InputEvent::Type::Char, 0, 0, static_cast<std::int32_t>(codepoint), 0, 0.0f, 0.0f, now() });
+}
+
+void InputQueue::cursorPosCallback(GLFWwindow*, double x, double y)
+{
+  push({ InputEvent::Type::CursorPos, 0, 0, 0, 0, static_cast<float>(x), static_cast<float>(y), now() });
+}
+
+void InputQueue::scrollCallback(GLFWwindow*, double x_offset, double y_offset)
+{
+  push({ InputEvent::Type::Scroll, 0, 0, 0, 0, static_cast<float>(x_offset), static_cast<float>(y_offset), now() });
+}
+
+void InputQueue::mouseButtonCallback(GLFWwindow*, int button, int action, int mods)
+{
+  push({ InputEvent::Type::MouseButton, static_cast<std::uint8_t>(action), static_cast<std::uint16_t>(mods),
+         button, 0, 0.0f, 0.0f, now() });
+}
+
+void InputQueue::push(InputEvent const& event)
+{
+  if (!events_.push(event))
+  {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}
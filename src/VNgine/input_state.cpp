@@ -0,0 +1,68 @@
+#include <VNgine/input_state.h>
+
+#include <cstdlib>
+#include <iostream>
+
+namespace VNgine
+{
+
+void bindingOverflow()
+{
+  std::cerr << "[ERROR] Too many bindings for one action.\n";
+  std::abort();
+}
+
+void InputState::beginFrame()
+{
+  pressed_.clear();
+  released_.clear();
+  scroll_x_ = 0.0f;
+  scroll_y_ = 0.0f;
+}
+
+void InputState::apply(InputEvent const& event)
+{
+  switch (event.type)
+  {
+  case InputEvent::Type::Key:
+    // GLFW_KEY_UNKNOWN is -1 and has no slot
+    if (event.code >= 0 && static_cast<std::size_t>(event.code) < key_count)
+    {
+      setButton(key(event.code), event.action);
+    }
+    break;
+  case InputEvent::Type::MouseButton:
+    if (event.code >= 0 && static_cast<std::size_t>(event.code) < mouse_button_count)
+    {
+      setButton(mouseButton(event.code), event.action);
+    }
+    break;
+  case InputEvent::Type::CursorPos:
+    cursor_x_ = event.x;
+    cursor_y_ = event.y;
+    break;
+  case InputEvent::Type::Scroll:
+    scroll_x_ += event.x;
+    scroll_y_ += event.y;
+    break;
+  case InputEvent::Type::Char:
+    break;
+  }
+}
+
+void InputState::setButton(std::size_t button, int action)
+{
+  if (action == GLFW_PRESS)
+  {
+    down_.set(button);
+    pressed_.set(button);
+  }
+  else if (action == GLFW_RELEASE)
+  {
+    down_.reset(button);
+    released_.set(button);
+  }
+  // GLFW_REPEAT leaves the button held without a new press
+}
+
+}
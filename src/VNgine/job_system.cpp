@@ -0,0 +1,283 @@
+#include <VNgine/job_system.h>
+
+#ifdef _WIN64
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <cassert>
+#include <cstring>
+#include <string>
+
+#include <VNgine/profiler.h>
+#include <VNgine/work_stealing_deque.h>
+
+namespace VNgine
+{
+
+namespace
+{
+
+// Rounds of looking for work, yielding in between, before an idle worker goes to sleep
+constexpr std::size_t spin_rounds = 32;
+
+void pinThread(std::size_t core)
+{
+  core %= std::max(std::thread::hardware_concurrency(), 1u);
+#ifdef _WIN64
+  SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{ 1 } << (core % 64));
+#elif defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core % CPU_SETSIZE, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)core;
+#endif
+}
+
+}
+
+struct alignas(64) JobSystem::Job
+{
+  Invoke invoke;
+  JobCounter* counter;
+  // Set while the job sits in a deque; the slot is reused once it is cleared
+  std::atomic<bool> queued{ false };
+  alignas(void*) std::byte data[job_data_bytes];
+};
+
+struct JobSystem::Worker
+{
+  explicit Worker(JobSystem& system, std::size_t index)
+    : system{ system },
+      random{ static_cast<std::uint32_t>(index + 1) * 0x9E3779B9u }
+  {}
+
+  static_assert(sizeof(Job) == 64, "Jobs are meant to fill one cache line.");
+
+  JobSystem& system;
+  WorkStealingDeque<Job*, queue_capacity> deque;
+  // Jobs this worker starts, used round robin
+  std::unique_ptr<Job[]> jobs{ new Job[queue_capacity] };
+  std::size_t next_job = 0;
+  std::uint32_t random;
+  // Of the job running on this worker, for runChild()
+  JobCounter* counter = nullptr;
+
+  std::atomic<std::uint64_t> jobs_run{ 0 };
+  std::atomic<std::uint64_t> steals{ 0 };
+  std::atomic<std::uint64_t> sleeps{ 0 };
+};
+
+thread_local JobSystem::Worker* JobSystem::current_worker_ = nullptr;
+
+JobCounter::~JobCounter()
+{
+  assert(isDone() && "JobCounter destroyed while its jobs are still running.");
+}
+
+JobSystem::JobSystem()
+  : JobSystem{ Options{} }
+{}
+
+JobSystem::JobSystem(Options const& options)
+  : previous_worker_{ current_worker_ }
+{
+  workers_.reserve(options.worker_count + 1);
+  for (std::size_t i = 0; i <= options.worker_count; ++i)
+  {
+    workers_.push_back(std::make_unique<Worker>(*this, i));
+  }
+  current_worker_ = workers_[0].get();
+  threads_.reserve(options.worker_count);
+  for (std::size_t i = 1; i <= options.worker_count; ++i)
+  {
+    threads_.emplace_back(&JobSystem::workerMain, this, i, options.pin_threads);
+  }
+}
+
+JobSystem::~JobSystem()
+{
+  assert(current_worker_ == workers_[0].get() && "JobSystem destroyed on another thread than it was created on.");
+  {
+    std::lock_guard<std::mutex> const lock{ sleep_mutex_ };
+    stopping_ = true;
+  }
+  wake_signal_.notify_all();
+  for (std::thread& thread : threads_)
+  {
+    thread.join();
+  }
+  assert(queued_.load() == 0 && "JobSystem destroyed with jobs queued.");
+  current_worker_ = previous_worker_;
+}
+
+void JobSystem::wait(JobCounter const& counter)
+{
+  Worker& worker = currentWorker();
+  while (!counter.isDone())
+  {
+    if (Job* const job = findJob(worker))
+    {
+      execute(worker, job);
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+std::size_t JobSystem::threadCount() const
+{
+  return workers_.size();
+}
+
+JobSystem::Stats JobSystem::stats() const
+{
+  Stats stats{};
+  for (std::unique_ptr<Worker> const& worker : workers_)
+  {
+    stats.jobs += worker->jobs_run.load(std::memory_order_relaxed);
+    stats.steals += worker->steals.load(std::memory_order_relaxed);
+    stats.sleeps += worker->sleeps.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void JobSystem::submit(JobCounter& counter, Invoke invoke, void const* data, std::size_t size)
+{
+  Worker& worker = currentWorker();
+  Job* const job = &worker.jobs[worker.next_job++ & (queue_capacity - 1)];
+  // Only a thief that has just taken the job and not yet copied it out can still hold the
+  // slot, or a full deque; either way, running queued jobs frees it
+  while (job->queued.load(std::memory_order_acquire))
+  {
+    if (Job* const other = findJob(worker))
+    {
+      execute(worker, other);
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+  job->invoke = invoke;
+  job->counter = &counter;
+  std::memcpy(job->data, data, size);
+  job->queued.store(true, std::memory_order_relaxed);
+  counter.pending_.fetch_add(1, std::memory_order_relaxed);
+
+  // Every job in the deque holds a slot, so there is always room for one more
+  bool const pushed = worker.deque.push(job);
+  assert(pushed && "Job deque full.");
+  (void)pushed;
+  queued_.fetch_add(1, std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_seq_cst) > 0)
+  {
+    std::lock_guard<std::mutex> const lock{ sleep_mutex_ };
+    wake_signal_.notify_one();
+  }
+}
+
+JobCounter& JobSystem::currentCounter() const
+{
+  Worker const& worker = currentWorker();
+  assert(worker.counter && "runChild() called outside a job.");
+  return *worker.counter;
+}
+
+JobSystem::Worker& JobSystem::currentWorker() const
+{
+  assert(current_worker_ && &current_worker_->system == this && "Jobs can only be started and waited for on worker threads.");
+  return *current_worker_;
+}
+
+JobSystem::Job* JobSystem::findJob(Worker& worker)
+{
+  Job* job;
+  if (worker.deque.pop(job))
+  {
+    return job;
+  }
+  std::size_t const count = workers_.size();
+  // xorshift32: a different victim each time, so thieves do not pile onto one worker
+  worker.random ^= worker.random << 13;
+  worker.random ^= worker.random >> 17;
+  worker.random ^= worker.random << 5;
+  std::size_t const start = worker.random % count;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    Worker& victim = *workers_[(start + i) % count];
+    if (&victim != &worker && victim.deque.steal(job))
+    {
+      worker.steals.fetch_add(1, std::memory_order_relaxed);
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+void JobSystem::execute(Worker& worker, Job* job)
+{
+  queued_.fetch_sub(1, std::memory_order_relaxed);
+  // Copied out so the slot can be reused while the job runs
+  Invoke const invoke = job->invoke;
+  JobCounter* const counter = job->counter;
+  alignas(void*) std::byte data[job_data_bytes];
+  std::memcpy(data, job->data, job_data_bytes);
+  job->queued.store(false, std::memory_order_release);
+
+  // Jobs run while waiting nest, so the counter of the interrupted job is put back after
+  JobCounter* const outer = worker.counter;
+  worker.counter = counter;
+  invoke(data);
+  worker.counter = outer;
+  worker.jobs_run.fetch_add(1, std::memory_order_relaxed);
+  counter->pending_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::workerMain(std::size_t index, bool pin)
+{
+  Worker& worker = *workers_[index];
+  current_worker_ = &worker;
+  Profiler::setThreadName("Job worker " + std::to_string(index));
+  if (pin)
+  {
+    pinThread(index);
+  }
+  std::size_t idle_rounds = 0;
+  for (;;)
+  {
+    if (Job* const job = findJob(worker))
+    {
+      execute(worker, job);
+      idle_rounds = 0;
+      continue;
+    }
+    if (++idle_rounds < spin_rounds)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock{ sleep_mutex_ };
+    // Pairs with submit(): either it sees this worker sleeping, or this worker sees its job
+    sleeping_.fetch_add(1, std::memory_order_seq_cst);
+    worker.sleeps.fetch_add(1, std::memory_order_relaxed);
+    wake_signal_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_seq_cst) > 0; });
+    sleeping_.fetch_sub(1, std::memory_order_relaxed);
+    if (stopping_)
+    {
+      break;
+    }
+    idle_rounds = 0;
+  }
+  current_worker_ = nullptr;
+}
+
+}
@@ -0,0 +1,120 @@
+#include <VNgine/memory_tracker.h>
+
+#include <array>
+#include <cstdio>
+
+namespace VNgine
+{
+
+namespace
+{
+
+struct Counters
+{
+  std::atomic<std::size_t> current{ 0 };
+  std::atomic<std::size_t> peak{ 0 };
+  std::atomic<std::size_t> allocations{ 0 };
+};
+
+std::array<Counters, to_integral(MemoryTag::COUNT)> tag_counters;
+Counters total_counters;
+
+void add(Counters& counters, std::size_t bytes)
+{
+  std::size_t const current = counters.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  counters.allocations.fetch_add(1, std::memory_order_relaxed);
+  std::size_t peak = counters.peak.load(std::memory_order_relaxed);
+  while (current > peak && !counters.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+  {}
+}
+
+MemoryTracker::Stats read(Counters const& counters)
+{
+  return {
+    counters.current.load(std::memory_order_relaxed),
+    counters.peak.load(std::memory_order_relaxed),
+    counters.allocations.load(std::memory_order_relaxed)
+  };
+}
+
+}
+
+void MemoryTracker::allocated(MemoryTag tag, std::size_t bytes)
+{
+  add(tag_counters[to_integral(tag)], bytes);
+  add(total_counters, bytes);
+}
+
+void MemoryTracker::released(MemoryTag tag, std::size_t bytes)
+{
+  tag_counters[to_integral(tag)].current.fetch_sub(bytes, std::memory_order_relaxed);
+  total_counters.current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryTracker::Stats MemoryTracker::stats(MemoryTag tag)
+{
+  return read(tag_counters[to_integral(tag)]);
+}
+
+MemoryTracker::Stats MemoryTracker::total()
+{
+  return read(total_counters);
+}
+
+char const* MemoryTracker::name(MemoryTag tag)
+{
+  switch (tag)
+  {
+  case MemoryTag::GENERAL: return "general";
+  case MemoryTag::FRAME: return "frame";
+  case MemoryTag::RENDERING: return "rendering";
+  case MemoryTag::SHADERS: return "shaders";
+  case MemoryTag::ENTITIES: return "entities";
+  default: return "?";
+  }
+}
+
+void MemoryTracker::report(std::ostream& out)
+{
+  auto const line = [&out](char const* name, Stats const& stats)
+  {
+    char text[128];
+    std::snprintf(text, sizeof(text), "  %-10s %10.1f KiB now %10.1f KiB peak %8zu blocks\n", name,
+                  double(stats.current) / 1024.0, double(stats.peak) / 1024.0, stats.allocations);
+    out << text;
+  };
+  for (std::size_t i = 0; i < tag_counters.size(); ++i)
+  {
+    Stats const stats = read(tag_counters[i]);
+    if (stats.allocations)
+    {
+      line(name(MemoryTag(i)), stats);
+    }
+  }
+  line("total", total());
+}
+
+TrackedResource::TrackedResource(MemoryTag tag, std::pmr::memory_resource* upstream)
+  : tag_{ tag },
+    upstream_{ upstream }
+{}
+
+void* TrackedResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+  void* const pointer = upstream_->allocate(bytes, alignment);
+  MemoryTracker::allocated(tag_, bytes);
+  return pointer;
+}
+
+void TrackedResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+{
+  MemoryTracker::released(tag_, bytes);
+  upstream_->deallocate(pointer, bytes, alignment);
+}
+
+bool TrackedResource::do_is_equal(std::pmr::memory_resource const& other) const noexcept
+{
+  return this == &other;
+}
+
+}
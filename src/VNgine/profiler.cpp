@@ -0,0 +1,338 @@
+#include <VNgine/profiler.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+namespace VNgine
+{
+
+namespace
+{
+
+struct Event
+{
+  char const* name;
+  std::uint64_t begin;
+  std::uint64_t end;
+};
+
+struct ThreadTrace
+{
+  std::uint32_t id;
+  std::string name;
+  std::unique_ptr<Event[]> events{ new Event[Profiler::events_per_thread] };
+  // Events ever recorded; the last events_per_thread of them are in the ring
+  std::atomic<std::uint64_t> count{ 0 };
+};
+
+// A tick count and the steady_clock time it was read at
+struct ClockSample
+{
+  std::uint64_t ticks;
+  std::uint64_t ns;
+};
+
+ClockSample sampleClocks()
+{
+  return { Profiler::now(), Profiler::steadyNanoseconds() };
+}
+
+std::mutex trace_mutex;
+// Shared with the owning thread, so a trace outlives the thread that wrote it
+std::vector<std::shared_ptr<ThreadTrace>> thread_traces;
+// GPU scopes from every context, capped like a thread's CPU scopes
+std::unique_ptr<Event[]> const gpu_events{ new Event[Profiler::events_per_thread] };
+std::uint64_t gpu_count = 0;
+std::uint32_t next_thread_id = 1;
+ClockSample const startup = sampleClocks();
+
+thread_local GpuProfiler* current_gpu_profiler = nullptr;
+
+ThreadTrace& threadTrace()
+{
+  thread_local std::shared_ptr<ThreadTrace> const trace = []
+  {
+    auto trace = std::make_shared<ThreadTrace>();
+    std::lock_guard<std::mutex> const lock{ trace_mutex };
+    trace->id = next_thread_id++;
+    trace->name = "Thread " + std::to_string(trace->id);
+    thread_traces.push_back(trace);
+    return trace;
+  }();
+  return *trace;
+}
+
+void writeEscaped(std::ostream& out, char const* text)
+{
+  for (; *text; ++text)
+  {
+    if (*text == '"' || *text == '\\')
+    {
+      out << '\\' << *text;
+    }
+    else if (static_cast<unsigned char>(*text) < 0x20)
+    {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", *text);
+      out << escaped;
+    }
+    else
+    {
+      out << *text;
+    }
+  }
+}
+
+void writeMicroseconds(std::ostream& out, double ns)
+{
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.3f", ns / 1000.0);
+  out << text;
+}
+
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+std::uint64_t Profiler::steadyNanoseconds()
+{
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::recordCpu(char const* name, std::uint64_t begin, std::uint64_t end)
+{
+  ThreadTrace& trace = threadTrace();
+  std::uint64_t const count = trace.count.load(std::memory_order_relaxed);
+  trace.events[count & (events_per_thread - 1)] = { name, begin, end };
+  trace.count.store(count + 1, std::memory_order_release);
+}
+
+void Profiler::recordGpu(char const* name, std::uint64_t begin_ns, std::uint64_t end_ns)
+{
+  std::lock_guard<std::mutex> const lock{ trace_mutex };
+  gpu_events[gpu_count & (events_per_thread - 1)] = { name, begin_ns, end_ns };
+  ++gpu_count;
+}
+
+void Profiler::setThreadName(std::string name)
+{
+  ThreadTrace& trace = threadTrace();
+  std::lock_guard<std::mutex> const lock{ trace_mutex };
+  trace.name = std::move(name);
+}
+
+void Profiler::writeChromeTrace(std::ostream& out)
+{
+  static_assert((events_per_thread & (events_per_thread - 1)) == 0, "Ring size must be a power of two.");
+  // Ticks to steady_clock nanoseconds, by the rate over everything since startup
+  ClockSample const export_time = sampleClocks();
+  double const ns_per_tick = export_time.ticks > startup.ticks
+    ? static_cast<double>(export_time.ns - startup.ns) / static_cast<double>(export_time.ticks - startup.ticks)
+    : 1.0;
+  auto const toNs = [&](std::uint64_t ticks)
+  {
+    return (static_cast<double>(ticks) - static_cast<double>(startup.ticks)) * ns_per_tick;
+  };
+
+  std::lock_guard<std::mutex> const lock{ trace_mutex };
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"VNgine\"}},\n";
+  out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+  for (std::shared_ptr<ThreadTrace> const& trace : thread_traces)
+  {
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << trace->id << ",\"args\":{\"name\":\"";
+    writeEscaped(out, trace->name.c_str());
+    out << "\"}}";
+  }
+
+  auto const writeEvent = [&](Event const& event, std::uint32_t thread, double begin_ns, double end_ns)
+  {
+    out << ",\n{\"name\":\"";
+    writeEscaped(out, event.name);
+    out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread << ",\"ts\":";
+    writeMicroseconds(out, begin_ns);
+    out << ",\"dur\":";
+    writeMicroseconds(out, end_ns - begin_ns);
+    out << '}';
+  };
+  for (std::shared_ptr<ThreadTrace> const& trace : thread_traces)
+  {
+    std::uint64_t const count = trace->count.load(std::memory_order_acquire);
+    std::uint64_t const first = count > events_per_thread ? count - events_per_thread : 0;
+    for (std::uint64_t i = first; i < count; ++i)
+    {
+      Event const& event = trace->events[i & (events_per_thread - 1)];
+      writeEvent(event, trace->id, toNs(event.begin), toNs(event.end));
+    }
+  }
+  double const startup_ns = static_cast<double>(startup.ns);
+  std::uint64_t const first_gpu = gpu_count > events_per_thread ? gpu_count - events_per_thread : 0;
+  for (std::uint64_t i = first_gpu; i < gpu_count; ++i)
+  {
+    Event const& event = gpu_events[i & (events_per_thread - 1)];
+    writeEvent(event, 0, static_cast<double>(event.begin) - startup_ns, static_cast<double>(event.end) - startup_ns);
+  }
+  out << "\n]}\n";
+}
+
+bool Profiler::writeChromeTrace(std::string const& path)
+{
+  std::ofstream file{ path, std::ios::binary };
+  if (!file)
+  {
+    std::cerr << "[ERROR] Could not open trace file " << path << ".\n";
+    return false;
+  }
+  writeChromeTrace(file);
+  return static_cast<bool>(file);
+}
+
+void Profiler::clear()
+{
+  std::lock_guard<std::mutex> const lock{ trace_mutex };
+  for (std::size_t i = 0; i < thread_traces.size();)
+  {
+    // The list holds the last reference of a thread that has exited
+    if (thread_traces[i].use_count() == 1)
+    {
+      thread_traces.erase(thread_traces.begin() + static_cast<std::ptrdiff_t>(i));
+      continue;
+    }
+    thread_traces[i]->count.store(0, std::memory_order_relaxed);
+    ++i;
+  }
+  gpu_count = 0;
+}
+
+GpuProfiler::~GpuProfiler()
+{
+  if (current_gpu_profiler == this)
+  {
+    current_gpu_profiler = nullptr;
+  }
+}
+
+void GpuProfiler::makeCurrent()
+{
+  current_gpu_profiler = this;
+}
+
+GpuProfiler* GpuProfiler::current()
+{
+  return current_gpu_profiler;
+}
+
+void GpuProfiler::clearCurrent()
+{
+  current_gpu_profiler = nullptr;
+}
+
+void GpuProfiler::reset()
+{
+  for (Frame& frame : frames_)
+  {
+    if (!frame.queries.empty())
+    {
+      glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+    }
+    frame = Frame{};
+  }
+  calibrated_ = false;
+}
+
+std::size_t GpuProfiler::begin(char const* name)
+{
+  if (!calibrated_)
+  {
+    GLint64 gpu_ns;
+    glGetInteger64v(GL_TIMESTAMP, &gpu_ns);
+    gpu_to_steady_ns_ = static_cast<std::int64_t>(Profiler::steadyNanoseconds()) - gpu_ns;
+    calibrated_ = true;
+  }
+  Frame& frame = frames_[frame_];
+  std::size_t const scope = frame.scopes.size();
+  frame.scopes.push_back({ name, query(frame, 2 * scope), query(frame, 2 * scope + 1) });
+  frame.last_query = frame.scopes.back().begin_query;
+  glQueryCounter(frame.last_query, GL_TIMESTAMP);
+  return scope;
+}
+
+void GpuProfiler::end(std::size_t scope)
+{
+  Frame& frame = frames_[frame_];
+  assert(scope < frame.scopes.size() && "GPU scope ended in another frame than it began.");
+  frame.last_query = frame.scopes[scope].end_query;
+  glQueryCounter(frame.last_query, GL_TIMESTAMP);
+}
+
+void GpuProfiler::endFrame()
+{
+  frames_[frame_].pending = !frames_[frame_].scopes.empty();
+  frame_ = (frame_ + 1) % frames_in_flight;
+  // Oldest first; frames finish in order, so the first one not ready ends the search
+  for (std::size_t i = 0; i < frames_in_flight; ++i)
+  {
+    Frame& frame = frames_[(frame_ + i) % frames_in_flight];
+    if (frame.pending && !read(frame))
+    {
+      break;
+    }
+  }
+  Frame& next = frames_[frame_];
+  if (next.pending)
+  {
+    ++stats_.frames_dropped;
+    next.pending = false;
+  }
+  next.scopes.clear();
+}
+
+GpuProfiler::Stats const& GpuProfiler::stats() const
+{
+  return stats_;
+}
+
+GLuint GpuProfiler::query(Frame& frame, std::size_t index)
+{
+  if (index >= frame.queries.size())
+  {
+    std::size_t const old_size = frame.queries.size();
+    frame.queries.resize(old_size + 64);
+    glGenQueries(64, frame.queries.data() + old_size);
+  }
+  return frame.queries[index];
+}
+
+bool GpuProfiler::read(Frame& frame)
+{
+  GLint available;
+  glGetQueryObjectiv(frame.last_query, GL_QUERY_RESULT_AVAILABLE, &available);
+  if (!available)
+  {
+    return false;
+  }
+  for (Scope const& scope : frame.scopes)
+  {
+    GLuint64 begin;
+    GLuint64 end;
+    glGetQueryObjectui64v(scope.begin_query, GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(scope.end_query, GL_QUERY_RESULT, &end);
+    Profiler::recordGpu(scope.name, static_cast<std::uint64_t>(static_cast<std::int64_t>(begin) + gpu_to_steady_ns_),
+                        static_cast<std::uint64_t>(static_cast<std::int64_t>(end) + gpu_to_steady_ns_));
+  }
+  stats_.scopes += frame.scopes.size();
+  ++stats_.frames_read;
+  frame.pending = false;
+  return true;
+}
+
+}
@@ -0,0 +1,187 @@
+#include <VNgine/program_cache.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace VNgine
+{
+
+namespace
+{
+
+constexpr std::uint32_t file_magic = 0x50434E56; // "VNCP"
+constexpr std::uint32_t file_version = 1;
+// Far beyond any real program binary; a larger length field means the file is corrupt
+constexpr std::uint32_t max_binary_length = 64 << 20;
+
+struct FileHeader
+{
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint64_t key;
+  std::uint64_t checksum;     // FNV-1a of the binary
+  std::uint32_t format;       // binary format enum reported by the driver
+  std::uint32_t length;
+};
+
+std::string_view bytesOf(void const* data, std::size_t size)
+{
+  return { static_cast<char const*>(data), size };
+}
+
+std::string_view glString(GLenum name)
+{
+  char const* const string = reinterpret_cast<char const*>(glGetString(name));
+  return string ? string : "";
+}
+
+}
+
+ProgramCache::ProgramCache(std::string_view directory)
+  : directory_{ directory }
+{
+  GLint format_count = 0;
+  if (GLEW_ARB_get_program_binary)
+  {
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+  }
+  std::error_code error;
+  fs::create_directories(directory_, error);
+  enabled_ = (format_count > 0) && !error;
+
+  std::string driver{ glString(GL_VENDOR) };
+  driver += '\n';
+  driver += glString(GL_RENDERER);
+  driver += '\n';
+  driver += glString(GL_VERSION);
+  driver_hash_ = fnv1a_hash(driver);
+}
+
+std::uint64_t ProgramCache::key(std::uint64_t vs_hash, std::uint64_t fs_hash, std::string_view defines) const
+{
+  std::uint64_t const parts[] = { driver_hash_, vs_hash, fs_hash, fnv1a_hash(defines) };
+  return fnv1a_hash(bytesOf(parts, sizeof(parts)));
+}
+
+bool ProgramCache::load(GLuint program, std::uint64_t key)
+{
+  if (!enabled_)
+  {
+    return false;
+  }
+  fs::path const path = pathFor(key);
+  std::ifstream file{ path, std::ios::binary };
+  if (!file)
+  {
+    ++stats_.misses;
+    return false;
+  }
+
+  FileHeader header{};
+  std::vector<char> binary;
+  std::error_code size_error;
+  std::uintmax_t const file_size = fs::file_size(path, size_error);
+  bool valid = static_cast<bool>(file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    && header.magic == file_magic && header.version == file_version && header.key == key;
+  // Checked before allocating: the length comes from the file and may be garbage
+  valid = valid && !size_error && header.length <= max_binary_length
+    && file_size == sizeof(header) + std::uintmax_t(header.length);
+  if (valid)
+  {
+    binary.resize(header.length);
+    valid = file.read(binary.data(), static_cast<std::streamsize>(binary.size()))
+      && file.peek() == std::ifstream::traits_type::eof()
+      && fnv1a_hash(bytesOf(binary.data(), binary.size())) == header.checksum;
+  }
+
+  GLint linked = GL_FALSE;
+  if (valid)
+  {
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  }
+  if (!linked)
+  {
+    // Corrupt, truncated, or from a driver build that no longer accepts it; recompile
+    ++stats_.rejected;
+    ++stats_.misses;
+    file.close();
+    std::error_code error;
+    fs::remove(path, error);
+    return false;
+  }
+
+  ++stats_.hits;
+  stats_.bytes_read += sizeof(header) + binary.size();
+  return true;
+}
+
+void ProgramCache::store(GLuint program, std::uint64_t key)
+{
+  if (!enabled_)
+  {
+    return;
+  }
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0)
+  {
+    return;
+  }
+
+  std::vector<char> binary(static_cast<std::size_t>(length));
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &length, &format, binary.data());
+  binary.resize(static_cast<std::size_t>(length));
+
+  FileHeader const header{ file_magic, file_version, key,
+    fnv1a_hash(bytesOf(binary.data(), binary.size())), format, static_cast<std::uint32_t>(binary.size()) };
+
+  // Written beside the final name and renamed over it, so readers never see half a file
+  fs::path const path = pathFor(key);
+  fs::path temporary = path;
+  temporary += ".tmp";
+  {
+    std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    file.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!file)
+    {
+      return;
+    }
+  }
+  std::error_code error;
+  fs::rename(temporary, path, error);
+  if (error)
+  {
+    fs::remove(temporary, error);
+    return;
+  }
+  ++stats_.stores;
+  stats_.bytes_written += sizeof(header) + binary.size();
+}
+
+bool ProgramCache::isEnabled() const
+{
+  return enabled_;
+}
+
+ProgramCache::Stats const& ProgramCache::stats() const
+{
+  return stats_;
+}
+
+fs::path ProgramCache::pathFor(std::uint64_t key) const
+{
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+  return directory_ / name;
+}
+
+}
@@ -0,0 +1,173 @@
+#include <VNgine/render_queue.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#include <VNgine/gl_state.h>
+#include <VNgine/profiler.h>
+#include <VNgine/shader.h>
+
+namespace VNgine
+{
+
+namespace
+{
+
+// Below this, counting eight byte histograms costs more than it saves
+constexpr std::size_t radix_threshold = 256;
+
+void* indexOffset(std::size_t offset)
+{
+  return reinterpret_cast<void*>(offset);
+}
+
+}
+
+std::uint32_t RenderKey::depth(float distance, float far, bool back_to_front)
+{
+  float const scaled = std::clamp(distance / far, 0.0f, 1.0f) * static_cast<float>(mask(depth_bits));
+  std::uint32_t const quantized = static_cast<std::uint32_t>(scaled);
+  return back_to_front ? mask(depth_bits) - quantized : quantized;
+}
+
+RenderQueue::RenderQueue(std::size_t capacity, std::size_t payload_bytes)
+  : memory_{ payload_bytes + capacity * sizeof(DrawCommand), MemoryTag::RENDERING }
+{
+  packets_.reserve(capacity);
+  scratch_.reserve(capacity);
+}
+
+void RenderQueue::sort()
+{
+  if (sorted_)
+  {
+    return;
+  }
+  sorted_ = true;
+  std::size_t const count = packets_.size();
+  if (count < radix_threshold)
+  {
+    std::stable_sort(packets_.begin(), packets_.end(),
+      [](Packet const& a, Packet const& b) { return a.key < b.key; });
+    return;
+  }
+
+  // All eight histograms in one pass over the keys
+  std::array<std::array<std::uint32_t, 256>, 8> histograms{};
+  for (Packet const& packet : packets_)
+  {
+    for (unsigned byte = 0; byte < 8; ++byte)
+    {
+      ++histograms[byte][(packet.key >> (byte * 8)) & 0xFF];
+    }
+  }
+
+  scratch_.resize(count);
+  Packet* source = packets_.data();
+  Packet* destination = scratch_.data();
+  for (unsigned byte = 0; byte < 8; ++byte)
+  {
+    std::array<std::uint32_t, 256>& offsets = histograms[byte];
+    unsigned const shift = byte * 8;
+    // A byte every key shares would not move anything
+    if (offsets[(source[0].key >> shift) & 0xFF] == count)
+    {
+      continue;
+    }
+    std::uint32_t total = 0;
+    for (std::uint32_t& offset : offsets)
+    {
+      std::uint32_t const bucket = offset;
+      offset = total;
+      total += bucket;
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      destination[offsets[(source[i].key >> shift) & 0xFF]++] = source[i];
+    }
+    std::swap(source, destination);
+  }
+  if (source != packets_.data())
+  {
+    packets_.swap(scratch_);
+  }
+}
+
+void RenderQueue::execute()
+{
+  VNGINE_PROFILE_SCOPE("RenderQueue::execute");
+  VNGINE_GPU_SCOPE("RenderQueue");
+  assert(sorted_ && "RenderQueue executed without sorting.");
+  stats_ = {};
+  GLState& gl = GLState::current();
+  gl.flush();
+
+  ShaderProgram const* program = nullptr;
+  GLuint vertex_array = 0;
+  GLuint texture = 0;
+  bool first = true;
+  for (Packet const& packet : packets_)
+  {
+    DrawCommand const& command = *packet.command;
+    assert(command.program && "Draw command without a program.");
+    if (command.program != program)
+    {
+      command.program->use();
+      program = command.program;
+      ++stats_.program_changes;
+    }
+    if (first || command.vertex_array != vertex_array)
+    {
+      gl.bindVertexArray(command.vertex_array);
+      vertex_array = command.vertex_array;
+      ++stats_.vertex_array_changes;
+    }
+    if (command.texture && command.texture != texture)
+    {
+      gl.bindTexture(0, GL_TEXTURE_2D, command.texture);
+      texture = command.texture;
+      ++stats_.texture_changes;
+    }
+    first = false;
+    if (command.prepare)
+    {
+      command.prepare(*program, command.payload);
+    }
+
+    if (command.index_type == GL_NONE)
+    {
+      glDrawArraysInstanced(command.mode, static_cast<GLint>(command.first), command.count, command.instance_count);
+    }
+    else
+    {
+      glDrawElementsInstanced(command.mode, command.count, command.index_type, indexOffset(command.first),
+        command.instance_count);
+    }
+    ++stats_.draw_calls;
+  }
+}
+
+void RenderQueue::clear()
+{
+  packets_.clear();
+  memory_.reset();
+  sorted_ = true;
+}
+
+array_view<RenderQueue::Packet const> RenderQueue::getPackets() const
+{
+  return { packets_.data(), packets_.size() };
+}
+
+FrameAllocator const& RenderQueue::getAllocator() const
+{
+  return memory_;
+}
+
+RenderQueue::Stats const& RenderQueue::stats() const
+{
+  return stats_;
+}
+
+}
@@ -0,0 +1,138 @@
+#include <VNgine/render_thread.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <VNgine/profiler.h>
+
+namespace VNgine
+{
+
+namespace
+{
+
+std::uint64_t nanoseconds(std::chrono::steady_clock::duration duration)
+{
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+}
+
+RenderThreadBase::RenderThreadBase(Window& window, std::size_t frames_in_flight)
+  : window_{ window },
+    slots_{ std::max<std::size_t>(frames_in_flight, 1) },
+    frame_starts_(slots_)
+{}
+
+RenderThreadBase::~RenderThreadBase()
+{
+  assert(!thread_.joinable() && "RenderThread destroyed without stop().");
+}
+
+void RenderThreadBase::start()
+{
+  // A context can only be current on one thread at a time
+  window_.releaseContext();
+  thread_ = std::thread{ &RenderThreadBase::run, this };
+}
+
+void RenderThreadBase::stop()
+{
+  if (!thread_.joinable())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> const lock{ mutex_ };
+    stopping_ = true;
+  }
+  submitted_signal_.notify_one();
+  thread_.join();
+  window_.makeContextCurrent();
+}
+
+std::size_t RenderThreadBase::acquireSlot()
+{
+  Clock::time_point const start = Clock::now();
+  std::unique_lock<std::mutex> lock{ mutex_ };
+  if (submitted_ - presented_ == slots_)
+  {
+    presented_signal_.wait(lock, [this] { return submitted_ - presented_ < slots_; });
+    stats_.main_wait_ns += nanoseconds(Clock::now() - start);
+  }
+  std::size_t const slot = submitted_ % slots_;
+  // Latency counts from when the frame can start simulating
+  frame_starts_[slot] = Clock::now();
+  return slot;
+}
+
+void RenderThreadBase::submitSlot()
+{
+  {
+    std::lock_guard<std::mutex> const lock{ mutex_ };
+    ++submitted_;
+  }
+  submitted_signal_.notify_one();
+}
+
+void RenderThreadBase::finish()
+{
+  std::unique_lock<std::mutex> lock{ mutex_ };
+  presented_signal_.wait(lock, [this] { return presented_ == submitted_; });
+}
+
+std::uint64_t RenderThreadBase::overlapNs(Stats const& stats)
+{
+  return stats.render_ns > stats.main_wait_ns ? stats.render_ns - stats.main_wait_ns : 0;
+}
+
+RenderThreadBase::Stats RenderThreadBase::stats() const
+{
+  std::lock_guard<std::mutex> const lock{ mutex_ };
+  return stats_;
+}
+
+void RenderThreadBase::run()
+{
+  window_.makeContextCurrent();
+  Profiler::setThreadName("Render");
+
+  std::unique_lock<std::mutex> lock{ mutex_ };
+  for (;;)
+  {
+    Clock::time_point const idle = Clock::now();
+    submitted_signal_.wait(lock, [this] { return stopping_ || presented_ != submitted_; });
+    stats_.render_wait_ns += nanoseconds(Clock::now() - idle);
+    // Frames already submitted are still presented when stopping
+    if (presented_ == submitted_)
+    {
+      break;
+    }
+    std::size_t const slot = presented_ % slots_;
+    Clock::time_point const frame_start = frame_starts_[slot];
+    lock.unlock();
+
+    Clock::time_point const start = Clock::now();
+    {
+      VNGINE_PROFILE_SCOPE("RenderThread::render");
+      render(slot);
+    }
+    window_.present();
+    Clock::time_point const end = Clock::now();
+
+    lock.lock();
+    ++presented_;
+    ++stats_.frames;
+    stats_.render_ns += nanoseconds(end - start);
+    std::uint64_t const latency = nanoseconds(end - frame_start);
+    stats_.latency_ns += latency;
+    stats_.max_latency_ns = std::max(stats_.max_latency_ns, latency);
+    presented_signal_.notify_one();
+  }
+  lock.unlock();
+
+  glFinish();
+  window_.releaseContext();
+}
+
+}
@@ -1,49 +1,110 @@
 #include <VNgine/shader.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <filesystem>
+#include <memory_resource>
+#include <thread>
+#include <utility>
 
-#include <glm/gtc/type_ptr.hpp>
-
+#include <VNgine/frame_allocator.h>
+#include <VNgine/gl_resources.h>
+#include <VNgine/gl_state.h>
 #include <VNgine/helper.h>
+#include <VNgine/profiler.h>
 
 namespace fs = std::filesystem;
 
 namespace VNgine
 {
 
-Shader Shader::CreateVS(std::string_view name, std::string_view source)
+namespace
+{
+
+bool parallelCompileSupported()
 {
-  return Shader{ name, Type::VERTEX , source.data() };
+  return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
 }
-Shader Shader::CreateFS(std::string_view name, std::string_view source)
+
+void enableParallelCompile()
 {
-  return Shader{ name, Type::FRAGMENT , source.data() };
+  // Let the driver pick its own number of compiler threads
+  if (GLEW_KHR_parallel_shader_compile)
+  {
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+  }
+  else if (GLEW_ARB_parallel_shader_compile)
+  {
+    glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+  }
 }
 
-Shader::Shader(std::string_view name, Type type, char const* source)
-  : name_{ name },
-  type_{ type }
+std::pmr::string readFile(fs::path const& path, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
 {
-  assert(type != Type::INVALID);
+  std::ifstream file{ path, std::ios::binary | std::ios::ate };
+  std::pmr::string contents(static_cast<std::size_t>(std::max<std::streamoff>(file.tellg(), 0)), '\0', memory);
+  file.seekg(0);
+  file.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+  return contents;
+}
 
-  id_ = glCreateShader(to_integral(type));
-  glShaderSource(id_, 1, &source, nullptr);
-  glCompileShader(id_);
+void reportCompileError(GLuint id, std::string_view name, Shader::Type type)
+{
+  char info_log[512];
+  glGetShaderInfoLog(id, 512, nullptr, info_log);
+  std::cerr << "[ERROR] Shader compilation failed: " <<
+    name << ((type == Shader::Type::VERTEX) ? ".vs" : ".fs") << "\n" <<
+    info_log << std::endl;
+}
 
-  int success;
-  glGetShaderiv(id_, GL_COMPILE_STATUS, &success);
-  if (!success)
+// Reads every file on a few worker threads; GL calls stay on the thread owning the context
+std::vector<std::pmr::string> readFiles(std::vector<fs::path> const& paths)
+{
+  std::vector<std::pmr::string> contents(paths.size());
+  std::atomic<std::size_t> next{ 0 };
+  auto const worker = [&]
+  {
+    for (std::size_t i = next++; i < paths.size(); i = next++)
+    {
+      contents[i] = readFile(paths[i]);
+    }
+  };
+
+  std::size_t const thread_count = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), paths.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i)
+  {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads)
   {
-    char info_log[512];
-    glGetShaderInfoLog(id_, 512, nullptr, info_log);
-    std::cerr << "[ERROR] Shader compilation failed: " <<
-      name << ((type == Type::VERTEX) ? ".vs" : ".fs") << "\n" <<
-      info_log << std::endl;
-    assert(!"Shader compilation failed.");
+    thread.join();
   }
+  return contents;
+}
+
+}
+
+Shader Shader::CreateVS(std::string_view name, std::string_view source)
+{
+  return Shader{ name, Type::VERTEX , source };
+}
+Shader Shader::CreateFS(std::string_view name, std::string_view source)
+{
+  return Shader{ name, Type::FRAGMENT , source };
+}
+
+Shader::Shader(std::string_view name, Type type, std::string_view source)
+  : name_{ name },
+  type_{ type },
+  source_{ source },
+  source_hash_{ fnv1a_hash(source) }
+{
+  assert(type != Type::INVALID);
 }
 
 Shader::Type Shader::getType() const
@@ -58,23 +119,158 @@ std::string_view Shader::getName() const
 
 GLuint Shader::getID() const
 {
+  if (!isCompileIssued())
+  {
+    VNGINE_PROFILE_SCOPE("Shader compile");
+    char const* const source = source_.c_str();
+    id_ = glCreateShader(to_integral(type_));
+    glShaderSource(id_, 1, &source, nullptr);
+    glCompileShader(id_);
+  }
   return id_;
 }
 
-GLint ShaderProgram::getUniformLocation(std::string_view name) const
+std::uint64_t Shader::getSourceHash() const
+{
+  return source_hash_;
+}
+
+std::uint32_t Shader::getVersion() const
+{
+  return version_;
+}
+
+bool Shader::isCompileIssued() const
 {
-  return glGetUniformLocation(id_, name.data());
+  return id_ != std::numeric_limits<GLuint>::max();
 }
 
-void ShaderProgram::setUniform(GLint location, glm::mat4 const& matrix) const
+bool Shader::isReady() const
 {
-  glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+  if (status_ == BuildStatus::PENDING && parallelCompileSupported())
+  {
+    GLint done;
+    glGetShaderiv(getID(), GL_COMPLETION_STATUS_KHR, &done);
+    if (!done)
+    {
+      return false;
+    }
+  }
+  isCompiled();
+  return true;
+}
+
+bool Shader::isCompiled() const
+{
+  if (status_ == BuildStatus::PENDING)
+  {
+    // Blocks until the driver is done compiling
+    VNGINE_PROFILE_SCOPE("Shader compile wait");
+    int success;
+    glGetShaderiv(getID(), GL_COMPILE_STATUS, &success);
+    status_ = success ? BuildStatus::SUCCEEDED : BuildStatus::FAILED;
+    if (!success)
+    {
+      reportCompileError(id_, name_, type_);
+      assert(!"Shader compilation failed.");
+    }
+  }
+  return status_ == BuildStatus::SUCCEEDED;
+}
+
+bool Shader::reload(std::string_view source)
+{
+  VNGINE_PROFILE_SCOPE("Shader reload");
+  char const* const text = source.data();
+  GLint const length = static_cast<GLint>(source.size());
+  GLuint const id = glCreateShader(to_integral(type_));
+  glShaderSource(id, 1, &text, &length);
+  glCompileShader(id);
+
+  // Edits are expected to break things now and then, so a failure is reported, not asserted
+  int success;
+  glGetShaderiv(id, GL_COMPILE_STATUS, &success);
+  if (!success)
+  {
+    reportCompileError(id, name_, type_);
+    glDeleteShader(id);
+    return false;
+  }
+
+  // Programs already linked against the old shader keep working until they are relinked
+  if (isCompileIssued())
+  {
+    GLResources::retire(GLResourceType::SHADER, id_);
+  }
+  id_ = id;
+  source_hash_ = fnv1a_hash(source);
+  source_.assign(source);
+  status_ = BuildStatus::SUCCEEDED;
+  ++version_;
+  return true;
+}
+
+GLint ShaderProgram::getUniformLocation(UniformName name) const
+{
+  // The table is filled once the link result is known
+  isLinked();
+  Uniform const* const uniform = uniforms_.find(name);
+  return uniform ? uniform->location : -1;
+}
+
+void ShaderProgram::setUniform(GLint location, bool value) const
+{
+  setUniform(location, GLint{ value });
+}
+
+void ShaderProgram::bindUniformBlock(UniformName block, UniformBufferBase const& buffer)
+{
+  BlockBinding binding{ std::string{ block.str() }, buffer.getBinding(), buffer.getSize() };
+  if (status_ == BuildStatus::SUCCEEDED)
+  {
+    applyBlockBinding(binding);
+  }
+  block_bindings_.push_back(std::move(binding));
 }
 
-ShaderPool::ShaderPool(std::string_view directory)
+UniformTable const& ShaderProgram::getUniforms() const
+{
+  return uniforms_;
+}
+
+void ShaderProgram::reflect() const
+{
+  uniforms_.reflect(id_);
+  for (BlockBinding const& binding : block_bindings_)
+  {
+    applyBlockBinding(binding);
+  }
+}
+
+void ShaderProgram::applyBlockBinding(BlockBinding const& binding) const
+{
+  // A block no shader stage reads is optimized out, and then there is nothing to bind
+  UniformBlock const* const block = uniforms_.findBlock(std::string_view{ binding.name });
+  if (!block)
+  {
+    return;
+  }
+  if (static_cast<std::size_t>(block->size) != binding.size)
+  {
+    std::cerr << "[ERROR] Uniform block " << binding.name << " in shader program [" << label_ << "] is " <<
+      block->size << " bytes but its buffer is " << binding.size << ".\n";
+    assert(!"Uniform block does not match its buffer.");
+  }
+  glUniformBlockBinding(id_, block->index, binding.binding);
+}
+
+ShaderPool::ShaderPool(std::string_view directory, ProgramCache* cache)
+  : directory_{ directory },
+    cache_{ cache }
 {
   fs::path const shader_path{ directory };
-  entries_.reserve(number_of_files_in_directory(shader_path));
+  std::vector<fs::path> paths;
+  paths.reserve(number_of_files_in_directory(shader_path));
 
   for (auto const& file : fs::directory_iterator{ shader_path })
   {
@@ -84,83 +280,286 @@ ShaderPool::ShaderPool(std::string_view directory)
     }
 
     fs::path const ext = file.path().extension();
-    std::string const filename = file.path().filename().replace_extension("").string();
     if (ext.compare(".vs") == 0 || ext.compare(".fs") == 0)
     {
-      std::stringstream source_stream;
-      source_stream << std::ifstream{ file }.rdbuf();
+      paths.push_back(file.path());
+    }
+  }
 
-      if (ext.c_str()[1] == 'v') // it's a .vs file
-      {
-        entries_.emplace_back(Shader::CreateVS(filename, source_stream.str()));
-      }
-      else // must be a .fs file
-      {
-        entries_.emplace_back(Shader::CreateFS(filename, source_stream.str()));
-      }
+  std::vector<std::pmr::string> const sources = readFiles(paths);
+
+  // Every compile is issued before any status is queried, so the driver can work on them
+  // all at once; errors are reported when a shader or program is first checked. With a
+  // cache, compiles wait until a program misses it.
+  enableParallelCompile();
+  entries_.reserve(paths.size());
+  table_.reserve(paths.size());
+  for (std::size_t i = 0; i < paths.size(); ++i)
+  {
+    std::string const filename = paths[i].filename().replace_extension("").string();
+    // .vs or .fs, as filtered above
+    Shader::Type const type = (paths[i].extension().c_str()[1] == 'v') ? Shader::Type::VERTEX : Shader::Type::FRAGMENT;
+    Shader const& shader = add(filename, type, sources[i]);
+    if (!cache_)
+    {
+      shader.getID();
     }
   }
 }
 
-Shader const& ShaderPool::getVS(std::string_view name) const
+Shader const& ShaderPool::add(std::string_view name, Shader::Type type, std::string_view source)
+{
+  entries_.emplace_back((type == Shader::Type::VERTEX) ? Shader::CreateVS(name, source) : Shader::CreateFS(name, source));
+  Shader const& shader = entries_.back();
+  table_.insert(shader.getName(), to_integral(type), ShaderHandle{ static_cast<std::uint32_t>(entries_.size() - 1) });
+  return shader;
+}
+
+std::optional<ShaderHandle> ShaderPool::find(ShaderName name, Shader::Type type) const
+{
+  return table_.find(name, to_integral(type));
+}
+
+Shader const& ShaderPool::get(ShaderHandle handle) const
+{
+  assert(handle.index < entries_.size());
+  return entries_[handle.index];
+}
+
+bool ShaderPool::isReady() const
+{
+  return std::all_of(entries_.begin(), entries_.end(),
+    [](Shader const& shader) { return !shader.isCompileIssued() || shader.isReady(); });
+}
+
+ProgramCache* ShaderPool::getProgramCache() const
 {
-  for (Shader const& shader : entries_)
+  return cache_;
+}
+
+bool ShaderPool::watch()
+{
+  if (!watcher_)
   {
-    if (shader.getType() == Shader::Type::VERTEX)
-    {
-      if (shader.getName() == name)
-      {
-        return shader;
-      }
-    }
+    watcher_ = std::make_unique<FileWatcher>(directory_);
   }
-  std::cerr << "Requested vertex shader: " << name << " not present.\n";
-  assert(!"Requested vertex shader not present.");
+  return watcher_->isWatching();
 }
 
-Shader const& ShaderPool::getFS(std::string_view name) const
+std::size_t ShaderPool::update()
 {
-  for (Shader const& shader : entries_)
+  if (!watcher_)
+  {
+    return 0;
+  }
+
+  std::size_t replaced = 0;
+  for (std::string const& file : watcher_->poll())
   {
-    if (shader.getType() == Shader::Type::FRAGMENT)
+    fs::path const path = fs::path{ directory_ } / file;
+    fs::path const ext = path.extension();
+    if (ext.compare(".vs") != 0 && ext.compare(".fs") != 0)
     {
-      if (shader.getName() == name)
+      continue;
+    }
+    Shader::Type const type = (ext.c_str()[1] == 'v') ? Shader::Type::VERTEX : Shader::Type::FRAGMENT;
+    std::string const name = path.filename().replace_extension("").string();
+    // Only needed until it is compiled or found unchanged
+    std::pmr::string const source = readFile(path, FrameMemory::resource());
+
+    if (std::optional<ShaderHandle> const handle = find(std::string_view{ name }, type))
+    {
+      Shader& shader = entries_[handle->index];
+      // Saving without changes still fires a notification
+      if (shader.getSourceHash() == fnv1a_hash(source) || !shader.reload(source))
       {
-        return shader;
+        continue;
       }
     }
+    else
+    {
+      add(name, type, source).getID();
+    }
+    std::cout << "[INFO] Reloaded shader " << file << "\n";
+    ++replaced;
+  }
+  if (replaced)
+  {
+    ++generation_;
   }
-  std::cerr << "Requested fragment shader: " << name << " not present.\n";
-  assert(!"Requested fragment shader not present.");
+  return replaced;
+}
+
+std::uint64_t ShaderPool::getGeneration() const
+{
+  return generation_;
 }
 
 
-ShaderProgram::ShaderProgram(ShaderPool const& pool, std::string_view vs_name, std::string_view fs_name)
+ShaderProgram::ShaderProgram(ShaderPool const& pool, ShaderName vs_name, ShaderName fs_name)
   : id_{ glCreateProgram() }
 {
-  glAttachShader(id_, pool.getVS(vs_name).getID());
-  glAttachShader(id_, pool.getFS(fs_name).getID());
+  std::optional<ShaderHandle> const vs = pool.find(vs_name, Shader::Type::VERTEX);
+  std::optional<ShaderHandle> const fs = pool.find(fs_name, Shader::Type::FRAGMENT);
+  if (!vs || !fs)
+  {
+    std::cerr << "[ERROR] Shader program [" << vs_name.str() << ".vs, " << fs_name.str() << ".fs] requested a "
+      << (vs ? "fragment" : "vertex") << " shader that is not present.\n";
+    assert(!"Requested shader not present.");
+    status_ = BuildStatus::FAILED;
+    return;
+  }
+  pool_ = &pool;
+  vs_ = *vs;
+  fs_ = *fs;
+  vs_version_ = pool.get(*vs).getVersion();
+  fs_version_ = pool.get(*fs).getVersion();
+  pool_generation_ = pool.getGeneration();
+  link(pool.get(*vs), pool.get(*fs), pool.getProgramCache());
+}
+
+ShaderProgram::ShaderProgram(ShaderPool const& pool, ShaderHandle vs, ShaderHandle fs)
+  : id_{ glCreateProgram() },
+    pool_{ &pool },
+    vs_{ vs },
+    fs_{ fs },
+    vs_version_{ pool.get(vs).getVersion() },
+    fs_version_{ pool.get(fs).getVersion() },
+    pool_generation_{ pool.getGeneration() }
+{
+  link(pool.get(vs), pool.get(fs), pool.getProgramCache());
+}
+
+void ShaderProgram::link(Shader const& vs, Shader const& fs, ProgramCache* cache)
+{
+  VNGINE_PROFILE_SCOPE("Program link");
+  label_ = std::string{ vs.getName() } + ".vs, " + std::string{ fs.getName() } + ".fs";
+  if (cache)
+  {
+    cache_key_ = cache->key(vs.getSourceHash(), fs.getSourceHash());
+    if (cache->load(id_, cache_key_))
+    {
+      status_ = BuildStatus::SUCCEEDED;
+      reflect();
+      return;
+    }
+    glProgramParameteri(id_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    pending_store_ = cache;
+  }
+  glAttachShader(id_, vs.getID());
+  glAttachShader(id_, fs.getID());
   glLinkProgram(id_);
+}
 
-  int success;
-  glGetProgramiv(id_, GL_LINK_STATUS, &success);
-  if (!success)
+bool ShaderProgram::isReady() const
+{
+  if (status_ == BuildStatus::PENDING && parallelCompileSupported())
+  {
+    GLint done;
+    glGetProgramiv(id_, GL_COMPLETION_STATUS_KHR, &done);
+    if (!done)
+    {
+      return false;
+    }
+  }
+  isLinked();
+  return true;
+}
+
+bool ShaderProgram::isLinked() const
+{
+  if (status_ == BuildStatus::PENDING && !checkLink())
   {
-    char info_log[512];
-    glGetProgramInfoLog(id_, 512, nullptr, info_log);
-    std::cerr << "[ERROR] Shader program [" << vs_name << ".vs, " << fs_name << ".fs] linking failed.\n" << info_log << std::endl;
     assert(!"Shader program linking failed.");
   }
+  return status_ == BuildStatus::SUCCEEDED;
+}
+
+bool ShaderProgram::checkLink() const
+{
+  if (status_ == BuildStatus::PENDING)
+  {
+    // Blocks until the driver is done linking
+    VNGINE_PROFILE_SCOPE("Program link wait");
+    int success;
+    glGetProgramiv(id_, GL_LINK_STATUS, &success);
+    status_ = success ? BuildStatus::SUCCEEDED : BuildStatus::FAILED;
+    if (success && pending_store_)
+    {
+      pending_store_->store(id_, cache_key_);
+    }
+    pending_store_ = nullptr;
+    if (success)
+    {
+      reflect();
+    }
+    if (!success)
+    {
+      char info_log[512];
+      glGetProgramInfoLog(id_, 512, nullptr, info_log);
+      std::cerr << "[ERROR] Shader program [" << label_ << "] linking failed.\n" << info_log << std::endl;
+      // Compile errors are only fetched on demand, so this may be the first time they surface
+      GLuint shaders[2];
+      GLsizei shader_count = 0;
+      glGetAttachedShaders(id_, 2, &shader_count, shaders);
+      for (GLsizei i = 0; i < shader_count; ++i)
+      {
+        glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+          glGetShaderInfoLog(shaders[i], 512, nullptr, info_log);
+          std::cerr << info_log << std::endl;
+        }
+      }
+    }
+  }
+  return status_ == BuildStatus::SUCCEEDED;
+}
+
+bool ShaderProgram::update()
+{
+  if (!pool_ || pool_->getGeneration() == pool_generation_)
+  {
+    return false;
+  }
+  pool_generation_ = pool_->getGeneration();
+
+  Shader const& vs = pool_->get(vs_);
+  Shader const& fs = pool_->get(fs_);
+  if (vs.getVersion() == vs_version_ && fs.getVersion() == fs_version_)
+  {
+    return false;
+  }
+  vs_version_ = vs.getVersion();
+  fs_version_ = fs.getVersion();
+
+  // Link into a fresh program so the current one stays usable if the new one fails
+  GLuint const old_id = std::exchange(id_, glCreateProgram());
+  BuildStatus const old_status = std::exchange(status_, BuildStatus::PENDING);
+  link(vs, fs, pool_->getProgramCache());
+  if (!checkLink())
+  {
+    GLState::current().deleteProgram(id_);
+    id_ = old_id;
+    status_ = old_status;
+    return false;
+  }
+  // Draws queued this frame may still use the old program
+  GLResources::retire(GLResourceType::PROGRAM, old_id);
+  std::cout << "[INFO] Relinked shader program [" << label_ << "]\n";
+  return true;
 }
 
 ShaderProgram::~ShaderProgram()
 {
-  glDeleteProgram(id_);
+  GLResources::retire(GLResourceType::PROGRAM, id_);
 }
 
 void ShaderProgram::use() const
 {
-  glUseProgram(id_);
+  // Surfaces link errors the first time a program that was never checked is used
+  isLinked();
+  GLState::current().useProgram(id_);
 }
 
 }
@@ -0,0 +1,105 @@
+#include <VNgine/shader_table.h>
+
+#include <utility>
+
+namespace VNgine
+{
+
+namespace
+{
+
+constexpr std::size_t min_capacity = 16;
+
+std::size_t slotHash(std::uint64_t hash, int type)
+{
+  // Vertex and fragment shaders usually share a name, so the type must change the slot
+  return static_cast<std::size_t>(hash ^ (static_cast<std::uint64_t>(type) * 0x9E3779B97F4A7C15));
+}
+
+}
+
+void ShaderTable::reserve(std::size_t count)
+{
+  std::size_t capacity = min_capacity;
+  while (capacity < count * 2)
+  {
+    capacity *= 2;
+  }
+  if (capacity > slots_.size())
+  {
+    rehash(capacity);
+  }
+}
+
+bool ShaderTable::insert(ShaderName name, int type, ShaderHandle handle)
+{
+  if ((size_ + 1) * 2 > slots_.size())
+  {
+    rehash(slots_.empty() ? min_capacity : slots_.size() * 2);
+  }
+  Slot& slot = slots_[probe(name, type)];
+  if (slot.index != empty)
+  {
+    return false;
+  }
+  slot.hash = name.hash();
+  slot.type = type;
+  slot.index = handle.index;
+  slot.name = name.str();
+  ++size_;
+  return true;
+}
+
+std::optional<ShaderHandle> ShaderTable::find(ShaderName name, int type) const
+{
+  if (slots_.empty())
+  {
+    return std::nullopt;
+  }
+  Slot const& slot = slots_[probe(name, type)];
+  if (slot.index == empty)
+  {
+    return std::nullopt;
+  }
+  return ShaderHandle{ slot.index };
+}
+
+std::size_t ShaderTable::size() const
+{
+  return size_;
+}
+
+// Index of the slot holding the key, or of the empty slot where it would go
+std::size_t ShaderTable::probe(ShaderName name, int type) const
+{
+  std::size_t const mask = slots_.size() - 1;
+  for (std::size_t i = slotHash(name.hash(), type) & mask; ; i = (i + 1) & mask)
+  {
+    Slot const& slot = slots_[i];
+    if (slot.index == empty
+        || (slot.hash == name.hash() && slot.type == type && slot.name == name.str()))
+    {
+      return i;
+    }
+  }
+}
+
+void ShaderTable::rehash(std::size_t capacity)
+{
+  std::vector<Slot> old_slots = std::exchange(slots_, std::vector<Slot>(capacity));
+  for (Slot& old_slot : old_slots)
+  {
+    if (old_slot.index != empty)
+    {
+      std::size_t const mask = capacity - 1;
+      std::size_t i = slotHash(old_slot.hash, old_slot.type) & mask;
+      while (slots_[i].index != empty)
+      {
+        i = (i + 1) & mask;
+      }
+      slots_[i] = std::move(old_slot);
+    }
+  }
+}
+
+}
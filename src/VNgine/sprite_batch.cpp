@@ -0,0 +1,225 @@
+#include <VNgine/sprite_batch.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+#include <VNgine/gl_resources.h>
+#include <VNgine/gl_state.h>
+#include <VNgine/profiler.h>
+#include <VNgine/shader.h>
+
+namespace VNgine
+{
+
+namespace
+{
+
+struct QuadVertex
+{
+  float position[3];
+  float uv[2];
+};
+
+constexpr QuadVertex quad_vertices[] = {
+  { {  0.5f,  0.5f, 0.0f }, { 1.0f, 1.0f } },  // top right
+  { {  0.5f, -0.5f, 0.0f }, { 1.0f, 0.0f } },  // bottom right
+  { { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f } },  // bottom left
+  { { -0.5f,  0.5f, 0.0f }, { 0.0f, 1.0f } },  // top left
+};
+
+constexpr GLushort quad_indices[] = {
+  0, 1, 3,
+  1, 2, 3
+};
+
+void const* bufferOffset(std::size_t offset)
+{
+  return reinterpret_cast<void const*>(offset);
+}
+
+}
+
+SpriteBatch::SpriteBatch(std::size_t capacity)
+  : capacity_{ std::max<std::size_t>(capacity, 1) },
+    base_instance_{ GLEW_ARB_base_instance != 0 }
+{
+  glGenVertexArrays(1, &vao_);
+  glGenBuffers(1, &quad_vbo_);
+  glGenBuffers(1, &quad_ebo_);
+  GLState& gl = GLState::current();
+  gl.bindVertexArray(vao_);
+
+  gl.bindBuffer(GL_ARRAY_BUFFER, quad_vbo_);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(quad_vertices), quad_vertices, GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_ebo_);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quad_indices), quad_indices, GL_STATIC_DRAW);
+  glVertexAttribPointer(position_location, 3, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), bufferOffset(offsetof(QuadVertex, position)));
+  glVertexAttribPointer(uv_location, 2, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), bufferOffset(offsetof(QuadVertex, uv)));
+  glEnableVertexAttribArray(position_location);
+  glEnableVertexAttribArray(uv_location);
+
+  instance_stream_ = std::make_unique<StreamBuffer>(GL_ARRAY_BUFFER, capacity_ * sizeof(SpriteInstance));
+  for (GLuint location = transform_location; location <= uv_rect_location; ++location)
+  {
+    glEnableVertexAttribArray(location);
+    glVertexAttribDivisor(location, 1);
+  }
+  pointInstanceAttributes(0);
+
+  unsigned char const white[4] = { 255, 255, 255, 255 };
+  glGenTextures(1, &white_texture_);
+  gl.bindTexture(0, GL_TEXTURE_2D, white_texture_);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  instances_.reserve(capacity_);
+  keys_.reserve(capacity_);
+}
+
+SpriteBatch::~SpriteBatch()
+{
+  GLResources::retire(GLResourceType::TEXTURE, white_texture_);
+  GLResources::retire(GLResourceType::BUFFER, quad_ebo_);
+  GLResources::retire(GLResourceType::BUFFER, quad_vbo_);
+  GLResources::retire(GLResourceType::VERTEX_ARRAY, vao_);
+}
+
+void SpriteBatch::begin()
+{
+  instances_.clear();
+  keys_.clear();
+  programs_.clear();
+}
+
+void SpriteBatch::draw(ShaderProgram const& program, GLuint texture, glm::mat4 const& transform,
+                       glm::vec4 const& color, glm::vec4 const& uv_rect, std::uint8_t layer)
+{
+  assert(instances_.size() < (std::size_t{ 1 } << index_bits) && "Too many sprites in one batch.");
+  keys_.push_back(makeKey(program, texture, layer) | instances_.size());
+  instances_.push_back({ transform, color, uv_rect });
+}
+
+void SpriteBatch::end()
+{
+  VNGINE_PROFILE_SCOPE("SpriteBatch::end");
+  VNGINE_GPU_SCOPE("Sprites");
+  stats_ = { instances_.size(), 0 };
+  if (instances_.empty())
+  {
+    return;
+  }
+
+  // The submission index in the low bits keeps the sort stable within a run
+  std::sort(keys_.begin(), keys_.end());
+
+  GLState& gl = GLState::current();
+  gl.bindVertexArray(vao_);
+  if (capacity_ < instances_.size())
+  {
+    while (capacity_ < instances_.size())
+    {
+      capacity_ *= 2;
+    }
+    // Draws still reading the old buffer keep it alive until they finish
+    instance_stream_ = std::make_unique<StreamBuffer>(GL_ARRAY_BUFFER, capacity_ * sizeof(SpriteInstance));
+    pointInstanceAttributes(0);
+  }
+  StreamBuffer::Allocation const allocation =
+    instance_stream_->map(instances_.size() * sizeof(SpriteInstance), sizeof(SpriteInstance));
+  if (!allocation.data)
+  {
+    std::cerr << "[ERROR] Sprite instance buffer could not be mapped.\n";
+    return;
+  }
+  auto* const mapped = static_cast<SpriteInstance*>(allocation.data);
+  constexpr std::uint64_t index_mask = (std::uint64_t{ 1 } << index_bits) - 1;
+  for (std::size_t i = 0; i < keys_.size(); ++i)
+  {
+    std::memcpy(mapped + i, &instances_[keys_[i] & index_mask], sizeof(SpriteInstance));
+  }
+  instance_stream_->unmap();
+  std::size_t const base = allocation.offset / sizeof(SpriteInstance);
+
+  gl.flush();
+  for (std::size_t first = 0; first < keys_.size(); )
+  {
+    std::uint64_t const state = keys_[first] >> index_bits;
+    std::size_t last = first + 1;
+    while (last < keys_.size() && (keys_[last] >> index_bits) == state)
+    {
+      ++last;
+    }
+
+    ShaderProgram const* const program = programs_[(state >> texture_bits) & ((1u << program_bits) - 1)];
+    GLuint const texture = static_cast<GLuint>(state & ((1u << texture_bits) - 1));
+    // Runs sharing a program or texture with the previous one cost no driver call here
+    program->use();
+    gl.bindTexture(0, GL_TEXTURE_2D, texture ? texture : white_texture_);
+
+    GLsizei const count = static_cast<GLsizei>(last - first);
+    if (base_instance_)
+    {
+      glDrawElementsInstancedBaseInstance(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr, count, static_cast<GLuint>(base + first));
+    }
+    else
+    {
+      // Without base instances, slide the instance attributes along to the run instead
+      pointInstanceAttributes(base + first);
+      glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr, count);
+    }
+    ++stats_.draw_calls;
+    first = last;
+  }
+  if (!base_instance_)
+  {
+    pointInstanceAttributes(0);
+  }
+  instance_stream_->endFrame();
+}
+
+SpriteBatch::Stats const& SpriteBatch::stats() const
+{
+  return stats_;
+}
+
+StreamBuffer::Stats const& SpriteBatch::streamStats() const
+{
+  return instance_stream_->stats();
+}
+
+std::uint64_t SpriteBatch::makeKey(ShaderProgram const& program, GLuint texture, std::uint8_t layer)
+{
+  // A frame uses a handful of programs, so a linear search beats hashing
+  auto const found = std::find(programs_.begin(), programs_.end(), &program);
+  std::size_t const slot = static_cast<std::size_t>(found - programs_.begin());
+  if (found == programs_.end())
+  {
+    assert(programs_.size() < (std::size_t{ 1 } << program_bits) && "Too many programs in one batch.");
+    programs_.push_back(&program);
+  }
+  assert(texture < (GLuint{ 1 } << texture_bits) && "Texture name too large for the sort key.");
+
+  return (std::uint64_t{ layer } << (program_bits + texture_bits + index_bits))
+    | (std::uint64_t{ slot } << (texture_bits + index_bits))
+    | (std::uint64_t{ texture } << index_bits);
+}
+
+void SpriteBatch::pointInstanceAttributes(std::size_t first_instance) const
+{
+  std::size_t const base = first_instance * sizeof(SpriteInstance);
+  for (GLuint column = 0; column < 4; ++column)
+  {
+    glVertexAttribPointer(transform_location + column, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+      bufferOffset(base + offsetof(SpriteInstance, transform) + column * sizeof(glm::vec4)));
+  }
+  glVertexAttribPointer(color_location, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+    bufferOffset(base + offsetof(SpriteInstance, color)));
+  glVertexAttribPointer(uv_rect_location, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+    bufferOffset(base + offsetof(SpriteInstance, uv_rect)));
+}
+
+}
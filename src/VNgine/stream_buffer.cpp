@@ -0,0 +1,195 @@
+#include <VNgine/stream_buffer.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+
+#include <VNgine/gl_intercept.h>
+#include <VNgine/gl_resources.h>
+#include <VNgine/gl_state.h>
+
+namespace VNgine
+{
+
+namespace
+{
+
+constexpr GLbitfield persistent_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+}
+
+StreamBuffer::Strategy StreamBuffer::defaultStrategy()
+{
+  return GLEW_ARB_buffer_storage ? Strategy::PERSISTENT : Strategy::ORPHAN;
+}
+
+StreamBuffer::StreamBuffer(GLenum target, std::size_t region_size, std::size_t region_count, Strategy strategy)
+  : target_{ target },
+    region_size_{ region_size },
+    region_count_{ std::max<std::size_t>(region_count, 1) },
+    strategy_{ strategy }
+{
+  glGenBuffers(1, &id_);
+  GLState::current().bindBuffer(target_, id_);
+  if (strategy_ == Strategy::PERSISTENT)
+  {
+    GLsizeiptr const size = static_cast<GLsizeiptr>(region_size_ * region_count_);
+    glBufferStorage(target_, size, nullptr, persistent_flags);
+    persistent_ = static_cast<std::byte*>(glMapBufferRange(target_, 0, size, persistent_flags));
+    if (!persistent_)
+    {
+      std::cerr << "[WARNING] Persistent mapping failed, streaming by orphaning instead.\n";
+      // Immutable storage cannot be respecified, so start over with a fresh buffer
+      GLState::current().deleteBuffer(id_);
+      glGenBuffers(1, &id_);
+      GLState::current().bindBuffer(target_, id_);
+      strategy_ = Strategy::ORPHAN;
+    }
+  }
+  if (strategy_ == Strategy::ORPHAN)
+  {
+    // Orphaning hands every frame fresh storage, so one region is all the buffer needs
+    region_count_ = 1;
+    glBufferData(target_, static_cast<GLsizeiptr>(region_size_), nullptr, GL_STREAM_DRAW);
+  }
+  fences_.assign(region_count_, nullptr);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+  for (GLsync const fence : fences_)
+  {
+    if (fence)
+    {
+      glDeleteSync(fence);
+    }
+  }
+  // Deleting the buffer also releases a persistent mapping, so it waits for the GPU too
+  GLResources::retire(GLResourceType::BUFFER, id_);
+}
+
+StreamBuffer::Allocation StreamBuffer::map(std::size_t size, std::size_t alignment)
+{
+  assert(!mapped_ && "StreamBuffer mapped twice without unmap().");
+  assert(alignment > 0);
+  GLState::current().bindBuffer(target_, id_);
+  if (!acquired_)
+  {
+    acquireRegion();
+    acquired_ = true;
+  }
+
+  std::size_t const region_start = region_ * region_size_;
+  std::size_t const region_end = region_start + region_size_;
+  std::size_t const offset = (region_start + used_ + alignment - 1) / alignment * alignment;
+  if (offset + size > region_end)
+  {
+    ++stats_.overflows;
+    return { nullptr, 0 };
+  }
+  used_ = offset + size - region_start;
+  stats_.bytes_written += size;
+#ifdef VNGINE_GL_INTERCEPT
+  GLIntercept::countMappedWrite(size);
+#endif
+
+  if (strategy_ == Strategy::PERSISTENT)
+  {
+    return { persistent_ + offset, offset };
+  }
+  // The buffer was orphaned when the frame began and ranges never overlap within a frame,
+  // so there is nothing to synchronize with
+  void* const data = glMapBufferRange(target_, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size),
+    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  mapped_ = data != nullptr;
+  return { data, offset };
+}
+
+void StreamBuffer::unmap()
+{
+  if (mapped_)
+  {
+    GLState::current().bindBuffer(target_, id_);
+    glUnmapBuffer(target_);
+    mapped_ = false;
+  }
+}
+
+void StreamBuffer::endFrame()
+{
+  assert(!mapped_ && "StreamBuffer frame ended while still mapped.");
+  ++stats_.frames;
+  // A frame that wrote nothing leaves its region free for the next one
+  if (!acquired_)
+  {
+    return;
+  }
+  if (strategy_ == Strategy::PERSISTENT)
+  {
+    fences_[region_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+  region_ = (region_ + 1) % region_count_;
+  used_ = 0;
+  acquired_ = false;
+}
+
+GLuint StreamBuffer::getID() const
+{
+  return id_;
+}
+
+GLenum StreamBuffer::getTarget() const
+{
+  return target_;
+}
+
+std::size_t StreamBuffer::getRegionSize() const
+{
+  return region_size_;
+}
+
+StreamBuffer::Strategy StreamBuffer::getStrategy() const
+{
+  return strategy_;
+}
+
+StreamBuffer::Stats const& StreamBuffer::stats() const
+{
+  return stats_;
+}
+
+void StreamBuffer::acquireRegion()
+{
+  if (strategy_ == Strategy::ORPHAN)
+  {
+    glBufferData(target_, static_cast<GLsizeiptr>(region_size_), nullptr, GL_STREAM_DRAW);
+    return;
+  }
+
+  GLsync const fence = fences_[region_];
+  if (!fence)
+  {
+    return;
+  }
+  GLenum status = glClientWaitSync(fence, 0, 0);
+  if (status == GL_TIMEOUT_EXPIRED)
+  {
+    ++stats_.stalls;
+    auto const start = std::chrono::steady_clock::now();
+    do
+    {
+      status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    } while (status == GL_TIMEOUT_EXPIRED);
+    stats_.stall_ns += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count());
+  }
+  if (status == GL_WAIT_FAILED)
+  {
+    std::cerr << "[ERROR] Waiting on a stream buffer fence failed.\n";
+  }
+  glDeleteSync(fence);
+  fences_[region_] = nullptr;
+}
+
+}
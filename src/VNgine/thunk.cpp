@@ -1,56 +1,371 @@
 #include <VNgine/thunk.h>
 
+#ifdef _WIN64
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <mutex>
 
 
 namespace VNgine
 {
 
-void* volatile ThunkHeap::bytecode_heap = nullptr;
-std::mutex ThunkHeap::heap_mutex;
+namespace
+{
 
-ThunkHeap::ThunkHeap()
+/*
+ * Platform layer: reserve one block of shared memory as two views of the same pages, one
+ * read+write and one read+execute, and commit slabs in both at once. Protection never
+ * changes after that, so writing a thunk cannot fault one that is running.
+ */
+
+// Thunks run from here
+std::uint8_t* region = nullptr;
+// The same pages, for writing them
+std::uint8_t* writable_region = nullptr;
+
+#ifdef _WIN64
+
+bool reserve(std::size_t size)
+{
+  HANDLE const section = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_EXECUTE_READWRITE | SEC_RESERVE,
+    static_cast<DWORD>(std::uint64_t{ size } >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+  if (!section)
+  {
+    return false;
+  }
+  void* const writable = MapViewOfFile(section, FILE_MAP_WRITE, 0, 0, size);
+  void* const executable = MapViewOfFile(section, FILE_MAP_READ | FILE_MAP_EXECUTE, 0, 0, size);
+  // The views keep the section alive
+  CloseHandle(section);
+  if (!writable || !executable)
+  {
+    return false;
+  }
+  writable_region = static_cast<std::uint8_t*>(writable);
+  region = static_cast<std::uint8_t*>(executable);
+  return true;
+}
+
+bool commit(std::size_t offset, std::size_t size)
+{
+  // Committing a reserved section's pages through one view commits them for every view
+  return VirtualAlloc(writable_region + offset, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void flushInstructionCache(void* mem, std::size_t size)
+{
+  // Flush instruction cache. May be required on some architectures which
+  // don't feature strong cache coherency guarantees, though not on neither
+  // x86, x64 nor AMD64.
+  FlushInstructionCache(GetCurrentProcess(), mem, size);
+}
+
+std::size_t pageSize()
+{
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwPageSize;
+}
+
+#else
+
+int anonymousFile()
+{
+#ifdef __linux__
+  return memfd_create("VNgine thunks", MFD_CLOEXEC);
+#else
+  // Without memfd, a shared memory object unlinked straight away is just as anonymous
+  char name[64];
+  std::snprintf(name, sizeof(name), "/vngine-thunks-%ld", static_cast<long>(getpid()));
+  int const fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  shm_unlink(name);
+  return fd;
+#endif
+}
+
+bool reserve(std::size_t size)
+{
+  int const fd = anonymousFile();
+  if (fd < 0)
+  {
+    return false;
+  }
+  // Sparse: pages take memory only once a slab is written
+  bool const sized = ftruncate(fd, static_cast<off_t>(size)) == 0;
+  void* const writable = sized ? mmap(nullptr, size, PROT_NONE, MAP_SHARED | MAP_NORESERVE, fd, 0) : MAP_FAILED;
+  void* const executable = sized ? mmap(nullptr, size, PROT_NONE, MAP_SHARED | MAP_NORESERVE, fd, 0) : MAP_FAILED;
+  // The mappings keep the memory alive
+  close(fd);
+  if (writable == MAP_FAILED || executable == MAP_FAILED)
+  {
+    return false;
+  }
+  writable_region = static_cast<std::uint8_t*>(writable);
+  region = static_cast<std::uint8_t*>(executable);
+  return true;
+}
+
+bool commit(std::size_t offset, std::size_t size)
+{
+  return mprotect(writable_region + offset, size, PROT_READ | PROT_WRITE) == 0
+    && mprotect(region + offset, size, PROT_READ | PROT_EXEC) == 0;
+}
+
+void flushInstructionCache(void* mem, std::size_t size)
+{
+  char* const begin = static_cast<char*>(mem);
+  __builtin___clear_cache(begin, begin + size);
+}
+
+std::size_t pageSize()
+{
+  return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+#endif
+
+constexpr std::size_t slab_size = 4096;
+constexpr std::size_t size_classes[] = { 64, 128, 256 };
+constexpr std::size_t class_count = std::size(size_classes);
+constexpr std::size_t max_slots_per_slab = slab_size / size_classes[0];
+// Address space only; slabs are committed one at a time as they are needed
+constexpr std::size_t reserved_bytes = std::size_t{ 256 } << 20;
+constexpr std::size_t max_slabs = reserved_bytes / slab_size;
+
+struct Slab
+{
+  std::size_t size_class;
+  std::size_t slot_count;
+  std::atomic<std::uint32_t> next[max_slots_per_slab];  // free list links, kept out of executable memory
+};
+
+std::once_flag reserve_flag;
+std::atomic<Slab*> slabs[max_slabs];
+std::atomic<std::uint32_t> slab_count{ 0 };
+std::mutex grow_mutex;
+
+// Free list heads pack an ABA tag in the upper half and a slot id in the lower half.
+// Slot ids are 1-based global slot indices, with 0 meaning the list is empty.
+std::atomic<std::uint64_t> free_heads[class_count];
+
+std::atomic<std::size_t> live_thunks{ 0 };
+std::atomic<std::size_t> live_bytes{ 0 };
+
+thread_local ThunkHeap::Batch* current_batch = nullptr;
+
+constexpr std::uint64_t packHead(std::uint64_t previous, std::uint32_t id)
+{
+  return (((previous >> 32) + 1) << 32) | id;
+}
+
+std::size_t slabOffset(std::uint32_t slab_index)
 {
-	/* This code will only run once. It is a mechanism to create a heap in a thread-safe way. */
+  return slab_index * slab_size;
+}
+
+std::atomic<std::uint32_t>& link(std::uint32_t id)
+{
+  std::uint32_t const slot = id - 1;
+  return slabs[slot / max_slots_per_slab].load(std::memory_order_acquire)->next[slot % max_slots_per_slab];
+}
+
+// Pushes the chain first..last, already linked through `link`, in one step
+void pushChain(std::size_t size_class, std::uint32_t first, std::uint32_t last)
+{
+  std::atomic<std::uint64_t>& head = free_heads[size_class];
+  std::uint64_t previous = head.load(std::memory_order_relaxed);
+  do
+  {
+    link(last).store(static_cast<std::uint32_t>(previous), std::memory_order_relaxed);
+  } while (!head.compare_exchange_weak(previous, packHead(previous, first),
+                                       std::memory_order_release, std::memory_order_relaxed));
+}
+
+std::uint32_t pop(std::size_t size_class)
+{
+  std::atomic<std::uint64_t>& head = free_heads[size_class];
+  std::uint64_t previous = head.load(std::memory_order_acquire);
+  while (static_cast<std::uint32_t>(previous) != 0)
+  {
+    // The link may be stale if another thread wins the race, but then the tag has changed and the CAS fails
+    std::uint32_t const next = link(static_cast<std::uint32_t>(previous)).load(std::memory_order_relaxed);
+    if (head.compare_exchange_weak(previous, packHead(previous, next),
+                                   std::memory_order_acquire, std::memory_order_acquire))
+    {
+      return static_cast<std::uint32_t>(previous);
+    }
+  }
+  return 0;
+}
+
+// Commits a new slab for the size class, returning one of its slots and freeing the rest
+std::uint32_t grow(std::size_t size_class)
+{
+  std::scoped_lock lock{ grow_mutex };
+  // Another thread may have refilled the free list while this one waited
+  if (std::uint32_t const id = pop(size_class))
+  {
+    return id;
+  }
+
+  std::uint32_t const slab_index = slab_count.load(std::memory_order_relaxed);
+  if (slab_index == max_slabs)
+  {
+    return 0;
+  }
+  if (!commit(slabOffset(slab_index), slab_size))
+  {
+    return 0;
+  }
+  // Fill unused space with int3 so a stray jump into it traps
+  std::memset(writable_region + slabOffset(slab_index), 0xCC, slab_size);
 
-	// Double checked locking, guaranteed by Acquire/Release-semantics in Microsoft's
-	// volatile-implementation.
-	if (!bytecode_heap)
-	{
-		std::scoped_lock lock{ heap_mutex };
-		if (!bytecode_heap)
-		{
-			// Make a heap with execute permissions to store generated machine code in
-			bytecode_heap = HeapCreate(HEAP_CREATE_ENABLE_EXECUTE, 0, 0);
-			if (!bytecode_heap)
-			{
-				assert(!"Failed to create heap.");
-			}
+  Slab* const slab = new Slab{};
+  slab->size_class = size_class;
+  slab->slot_count = slab_size / size_classes[size_class];
+  slabs[slab_index].store(slab, std::memory_order_release);
+  slab_count.store(slab_index + 1, std::memory_order_release);
 
-			// Schedule the heap to be destroyed when the application terminates.
-			// Until then, it will manage its own size.
-			atexit(cleanup);
-		}
-	}
+  // Keep the first slot for the caller and free the rest as one chain
+  std::uint32_t const first = slab_index * max_slots_per_slab + 1;
+  auto const count = static_cast<std::uint32_t>(slab->slot_count);
+  if (count > 1)
+  {
+    for (std::uint32_t i = 1; i + 1 < count; ++i)
+    {
+      slab->next[i].store(first + i + 1, std::memory_order_relaxed);
+    }
+    pushChain(size_class, first + 1, first + count - 1);
+  }
+  return first;
 }
 
-void* ThunkHeap::alloc(std::size_t size)
+}
+
+ThunkHeap::ThunkHeap()
+{
+  // Address space is reserved once and never released: thunks with static storage duration
+  // may outlive any cleanup we could schedule, and the OS reclaims everything at exit anyway.
+  std::call_once(reserve_flag, []
+  {
+    assert(slab_size % pageSize() == 0);
+    if (!reserve(reserved_bytes))
+    {
+      assert(!"Failed to reserve address space for thunks.");
+    }
+  });
+}
+
+void* ThunkHeap::emplace(detail::BytecodeImage const& image, void* instance, void* function)
 {
-  return HeapAlloc(bytecode_heap, 0, size);
+  std::size_t const size = image.size;
+  auto const size_class = static_cast<std::size_t>(
+    std::find_if(std::begin(size_classes), std::end(size_classes),
+      [size](std::size_t slot_size) { return size <= slot_size; }) - std::begin(size_classes));
+  if (size_class == class_count)
+  {
+    assert(!"Thunk bytecode is larger than the largest size class.");
+    return nullptr;
+  }
+
+  std::uint32_t id = pop(size_class);
+  if (!id)
+  {
+    id = grow(size_class);
+    if (!id)
+    {
+      return nullptr;
+    }
+  }
+
+  std::uint32_t const slot = id - 1;
+  std::uint32_t const slab_index = slot / max_slots_per_slab;
+  std::size_t const offset = slabOffset(slab_index) + (slot % max_slots_per_slab) * size_classes[size_class];
+  // The slot is free, so nothing runs from it; other slots of the slab stay executable throughout
+  std::uint8_t* const writable = writable_region + offset;
+  std::memcpy(writable, image.bytes, size);
+  std::memcpy(writable + image.this_offset, &instance, sizeof(instance));
+  std::memcpy(writable + image.function_offset, &function, sizeof(function));
+
+  std::uint8_t* const mem = region + offset;
+  Batch* const batch = current_batch;
+  if (!batch)
+  {
+    flushInstructionCache(mem, size);
+  }
+  else if (std::find(batch->written_slabs_.begin(), batch->written_slabs_.end(), slab_index) == batch->written_slabs_.end())
+  {
+    batch->written_slabs_.push_back(slab_index);
+  }
+
+  live_thunks.fetch_add(1, std::memory_order_relaxed);
+  live_bytes.fetch_add(size_classes[size_class], std::memory_order_relaxed);
+  return mem;
 }
 
 void ThunkHeap::dealloc(void* mem)
 {
-  HeapFree(bytecode_heap, 0, mem);
+  if (!mem)
+  {
+    return;
+  }
+  auto const offset = static_cast<std::size_t>(static_cast<std::uint8_t*>(mem) - region);
+  auto const slab_index = static_cast<std::uint32_t>(offset / slab_size);
+  std::size_t const size_class = slabs[slab_index].load(std::memory_order_acquire)->size_class;
+  auto const slot_in_slab = static_cast<std::uint32_t>((offset % slab_size) / size_classes[size_class]);
+
+  // The slot is not scrubbed; it is overwritten when it is handed out again
+  std::uint32_t const id = slab_index * max_slots_per_slab + slot_in_slab + 1;
+  pushChain(size_class, id, id);
+
+  live_thunks.fetch_sub(1, std::memory_order_relaxed);
+  live_bytes.fetch_sub(size_classes[size_class], std::memory_order_relaxed);
+}
+
+ThunkHeap::Stats ThunkHeap::stats()
+{
+  Stats stats{};
+  stats.live_thunks = live_thunks.load(std::memory_order_relaxed);
+  stats.slabs = slab_count.load(std::memory_order_relaxed);
+  stats.committed_bytes = stats.slabs * slab_size;
+  stats.live_bytes = live_bytes.load(std::memory_order_relaxed);
+  stats.fragmentation = (stats.committed_bytes == 0) ? 0.0 :
+    1.0 - static_cast<double>(stats.live_bytes) / static_cast<double>(stats.committed_bytes);
+  return stats;
 }
 
-void ThunkHeap::cleanup()
+ThunkHeap::Batch::Batch()
+  : outer_{ current_batch }
 {
-	HeapDestroy(bytecode_heap);
+  // Nested batches defer to the outermost one
+  if (!outer_)
+  {
+    current_batch = this;
+  }
 }
 
-}
\ No newline at end of file
+ThunkHeap::Batch::~Batch()
+{
+  if (current_batch == this)
+  {
+    for (std::uint32_t const slab_index : written_slabs_)
+    {
+      flushInstructionCache(region + slabOffset(slab_index), slab_size);
+    }
+    current_batch = nullptr;
+  }
+}
+
+}
@@ -0,0 +1,15 @@
+#include <VNgine/trampoline.h>
+
+#include <cstdlib>
+#include <iostream>
+
+namespace VNgine
+{
+
+void trampolineOverflow()
+{
+  std::cerr << "[ERROR] Out of static trampoline slots for a callback signature; raise VNGINE_STATIC_THUNK_SLOTS.\n";
+  std::abort();
+}
+
+}
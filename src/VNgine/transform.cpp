@@ -0,0 +1,317 @@
+#include <VNgine/transform.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define VNGINE_TRANSFORM_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC emits any intrinsic regardless of the target architecture
+#define VNGINE_TARGET_AVX2
+#else
+#define VNGINE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace VNgine
+{
+
+namespace
+{
+
+struct Components
+{
+  float const* position_x;
+  float const* position_y;
+  float const* position_z;
+  float const* rotation_x;
+  float const* rotation_y;
+  float const* rotation_z;
+  float const* rotation_w;
+  float const* scale_x;
+  float const* scale_y;
+  float const* scale_z;
+};
+
+void computeScalar(Components const& in, std::size_t first, std::size_t count, std::byte* out, std::size_t stride)
+{
+  for (std::size_t i = first; i < count; ++i)
+  {
+    float const x = in.rotation_x[i];
+    float const y = in.rotation_y[i];
+    float const z = in.rotation_z[i];
+    float const w = in.rotation_w[i];
+    float const xx = 2.0f * x * x, yy = 2.0f * y * y, zz = 2.0f * z * z;
+    float const xy = 2.0f * x * y, xz = 2.0f * x * z, yz = 2.0f * y * z;
+    float const wx = 2.0f * w * x, wy = 2.0f * w * y, wz = 2.0f * w * z;
+    float const sx = in.scale_x[i], sy = in.scale_y[i], sz = in.scale_z[i];
+    float const matrix[16] = {
+      (1.0f - yy - zz) * sx, (xy + wz) * sx, (xz - wy) * sx, 0.0f,
+      (xy - wz) * sy, (1.0f - xx - zz) * sy, (yz + wx) * sy, 0.0f,
+      (xz + wy) * sz, (yz - wx) * sz, (1.0f - xx - yy) * sz, 0.0f,
+      in.position_x[i], in.position_y[i], in.position_z[i], 1.0f
+    };
+    std::memcpy(out + i * stride, matrix, sizeof(matrix));
+  }
+}
+
+#ifdef VNGINE_TRANSFORM_SIMD
+
+// Transposes one column, held as four registers of one row each across four objects, into
+// each object's matrix
+void storeColumn(__m128 row0, __m128 row1, __m128 row2, __m128 row3, std::byte* out, std::size_t stride)
+{
+  _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+  _mm_storeu_ps(reinterpret_cast<float*>(out), row0);
+  _mm_storeu_ps(reinterpret_cast<float*>(out + stride), row1);
+  _mm_storeu_ps(reinterpret_cast<float*>(out + 2 * stride), row2);
+  _mm_storeu_ps(reinterpret_cast<float*>(out + 3 * stride), row3);
+}
+
+std::size_t computeSse(Components const& in, std::size_t count, std::byte* out, std::size_t stride)
+{
+  __m128 const one = _mm_set1_ps(1.0f);
+  __m128 const two = _mm_set1_ps(2.0f);
+  __m128 const zero = _mm_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 const x = _mm_loadu_ps(in.rotation_x + i);
+    __m128 const y = _mm_loadu_ps(in.rotation_y + i);
+    __m128 const z = _mm_loadu_ps(in.rotation_z + i);
+    __m128 const w = _mm_loadu_ps(in.rotation_w + i);
+    __m128 const x2 = _mm_mul_ps(x, two), y2 = _mm_mul_ps(y, two), z2 = _mm_mul_ps(z, two);
+    __m128 const xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+    __m128 const xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+    __m128 const wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+    __m128 const sx = _mm_loadu_ps(in.scale_x + i);
+    __m128 const sy = _mm_loadu_ps(in.scale_y + i);
+    __m128 const sz = _mm_loadu_ps(in.scale_z + i);
+
+    std::byte* const base = out + i * stride;
+    storeColumn(_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx), _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+      _mm_mul_ps(_mm_sub_ps(xz, wy), sx), zero, base, stride);
+    storeColumn(_mm_mul_ps(_mm_sub_ps(xy, wz), sy), _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+      _mm_mul_ps(_mm_add_ps(yz, wx), sy), zero, base + 16, stride);
+    storeColumn(_mm_mul_ps(_mm_add_ps(xz, wy), sz), _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+      _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz), zero, base + 32, stride);
+    storeColumn(_mm_loadu_ps(in.position_x + i), _mm_loadu_ps(in.position_y + i), _mm_loadu_ps(in.position_z + i),
+      one, base + 48, stride);
+  }
+  return i;
+}
+
+// As storeColumn, for eight objects: the four low lanes of each result go to the first
+// four objects and the high lanes to the next four
+VNGINE_TARGET_AVX2
+void storeColumn8(__m256 row0, __m256 row1, __m256 row2, __m256 row3, std::byte* out, std::size_t stride)
+{
+  __m256 const t0 = _mm256_unpacklo_ps(row0, row1);
+  __m256 const t1 = _mm256_unpackhi_ps(row0, row1);
+  __m256 const t2 = _mm256_unpacklo_ps(row2, row3);
+  __m256 const t3 = _mm256_unpackhi_ps(row2, row3);
+  __m256 const object0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 const object1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 const object2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 const object3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  _mm_storeu_ps(reinterpret_cast<float*>(out), _mm256_castps256_ps128(object0));
+  _mm_storeu_ps(reinterpret_cast<float*>(out + stride), _mm256_castps256_ps128(object1));
+  _mm_storeu_ps(reinterpret_cast<float*>(out + 2 * stride), _mm256_castps256_ps128(object2));
+  _mm_storeu_ps(reinterpret_cast<float*>(out + 3 * stride), _mm256_castps256_ps128(object3));
+  _mm_storeu_ps(reinterpret_cast<float*>(out + 4 * stride), _mm256_extractf128_ps(object0, 1));
+  _mm_storeu_ps(reinterpret_cast<float*>(out + 5 * stride), _mm256_extractf128_ps(object1, 1));
+  _mm_storeu_ps(reinterpret_cast<float*>(out + 6 * stride), _mm256_extractf128_ps(object2, 1));
+  _mm_storeu_ps(reinterpret_cast<float*>(out + 7 * stride), _mm256_extractf128_ps(object3, 1));
+}
+
+VNGINE_TARGET_AVX2
+std::size_t computeAvx2(Components const& in, std::size_t count, std::byte* out, std::size_t stride)
+{
+  __m256 const one = _mm256_set1_ps(1.0f);
+  __m256 const two = _mm256_set1_ps(2.0f);
+  __m256 const zero = _mm256_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 const x = _mm256_loadu_ps(in.rotation_x + i);
+    __m256 const y = _mm256_loadu_ps(in.rotation_y + i);
+    __m256 const z = _mm256_loadu_ps(in.rotation_z + i);
+    __m256 const w = _mm256_loadu_ps(in.rotation_w + i);
+    __m256 const x2 = _mm256_mul_ps(x, two), y2 = _mm256_mul_ps(y, two), z2 = _mm256_mul_ps(z, two);
+    __m256 const xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+    __m256 const xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+    __m256 const wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+    __m256 const sx = _mm256_loadu_ps(in.scale_x + i);
+    __m256 const sy = _mm256_loadu_ps(in.scale_y + i);
+    __m256 const sz = _mm256_loadu_ps(in.scale_z + i);
+
+    std::byte* const base = out + i * stride;
+    storeColumn8(_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx), _mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+      _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx), zero, base, stride);
+    storeColumn8(_mm256_mul_ps(_mm256_sub_ps(xy, wz), sy), _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+      _mm256_mul_ps(_mm256_add_ps(yz, wx), sy), zero, base + 16, stride);
+    storeColumn8(_mm256_mul_ps(_mm256_add_ps(xz, wy), sz), _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+      _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz), zero, base + 32, stride);
+    storeColumn8(_mm256_loadu_ps(in.position_x + i), _mm256_loadu_ps(in.position_y + i),
+      _mm256_loadu_ps(in.position_z + i), one, base + 48, stride);
+  }
+  return i;
+}
+
+bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+  {
+    return false;
+  }
+  __cpuid(info, 1);
+  // The OS must also save the upper halves of the YMM registers
+  bool const os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+  __cpuidex(info, 7, 0);
+  return os_saves_ymm && (info[1] & (1 << 5));
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+}
+
+bool TransformArray::isSupported(Kernel kernel)
+{
+  switch (kernel)
+  {
+  case Kernel::SCALAR:
+    return true;
+#ifdef VNGINE_TRANSFORM_SIMD
+  case Kernel::SSE:
+    return true;
+  case Kernel::AVX2:
+  {
+    static bool const avx2 = cpuHasAvx2();
+    return avx2;
+  }
+#endif
+  default:
+    return false;
+  }
+}
+
+TransformArray::Kernel TransformArray::bestKernel()
+{
+  static Kernel const best = isSupported(Kernel::AVX2) ? Kernel::AVX2
+    : isSupported(Kernel::SSE) ? Kernel::SSE : Kernel::SCALAR;
+  return best;
+}
+
+std::size_t TransformArray::add(glm::vec3 const& position, float angle, glm::vec3 const& axis, glm::vec3 const& scale)
+{
+  std::size_t const index = size();
+  position_x_.push_back(0.0f);
+  position_y_.push_back(0.0f);
+  position_z_.push_back(0.0f);
+  rotation_x_.push_back(0.0f);
+  rotation_y_.push_back(0.0f);
+  rotation_z_.push_back(0.0f);
+  rotation_w_.push_back(1.0f);
+  scale_x_.push_back(0.0f);
+  scale_y_.push_back(0.0f);
+  scale_z_.push_back(0.0f);
+  setPosition(index, position);
+  setRotation(index, angle, axis);
+  setScale(index, scale);
+  return index;
+}
+
+void TransformArray::setPosition(std::size_t index, glm::vec3 const& position)
+{
+  position_x_[index] = position.x;
+  position_y_[index] = position.y;
+  position_z_[index] = position.z;
+}
+
+void TransformArray::setRotation(std::size_t index, float angle, glm::vec3 const& axis)
+{
+  float const length = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+  assert(length > 0.0f && "Rotation axis of zero length.");
+  float const s = std::sin(angle * 0.5f) / length;
+  rotation_x_[index] = axis.x * s;
+  rotation_y_[index] = axis.y * s;
+  rotation_z_[index] = axis.z * s;
+  rotation_w_[index] = std::cos(angle * 0.5f);
+}
+
+void TransformArray::setScale(std::size_t index, glm::vec3 const& scale)
+{
+  scale_x_[index] = scale.x;
+  scale_y_[index] = scale.y;
+  scale_z_[index] = scale.z;
+}
+
+glm::vec3 TransformArray::getPosition(std::size_t index) const
+{
+  return { position_x_[index], position_y_[index], position_z_[index] };
+}
+
+std::size_t TransformArray::size() const
+{
+  return position_x_.size();
+}
+
+void TransformArray::reserve(std::size_t count)
+{
+  for (std::vector<float>* component : { &position_x_, &position_y_, &position_z_, &rotation_x_, &rotation_y_,
+                                         &rotation_z_, &rotation_w_, &scale_x_, &scale_y_, &scale_z_ })
+  {
+    component->reserve(count);
+  }
+}
+
+void TransformArray::clear()
+{
+  for (std::vector<float>* component : { &position_x_, &position_y_, &position_z_, &rotation_x_, &rotation_y_,
+                                         &rotation_z_, &rotation_w_, &scale_x_, &scale_y_, &scale_z_ })
+  {
+    component->clear();
+  }
+}
+
+void TransformArray::computeMatrices(void* out, std::size_t stride) const
+{
+  computeMatrices(out, stride, bestKernel());
+}
+
+void TransformArray::computeMatrices(void* out, std::size_t stride, Kernel kernel) const
+{
+  assert(isSupported(kernel) && "Transform kernel not supported on this CPU.");
+  assert(stride >= sizeof(glm::mat4));
+  Components const in{
+    position_x_.data(), position_y_.data(), position_z_.data(),
+    rotation_x_.data(), rotation_y_.data(), rotation_z_.data(), rotation_w_.data(),
+    scale_x_.data(), scale_y_.data(), scale_z_.data()
+  };
+  std::byte* const bytes = static_cast<std::byte*>(out);
+  std::size_t done = 0;
+#ifdef VNGINE_TRANSFORM_SIMD
+  if (kernel == Kernel::AVX2)
+  {
+    done = computeAvx2(in, size(), bytes, stride);
+  }
+  else if (kernel == Kernel::SSE)
+  {
+    done = computeSse(in, size(), bytes, stride);
+  }
+#endif
+  // The scalar kernel also finishes what does not fill a whole SIMD step
+  computeScalar(in, done, size(), bytes, stride);
+}
+
+}
@@ -0,0 +1,242 @@
+#include <VNgine/uniform.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+
+namespace VNgine
+{
+
+namespace
+{
+
+// Bytes one element of a uniform of this type takes in the shadow buffer
+std::uint32_t shadowSize(GLenum type)
+{
+  switch (type)
+  {
+  case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL:
+    return 4;
+  case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2:
+    return 8;
+  case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3:
+    return 12;
+  case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: case GL_FLOAT_MAT2:
+    return 16;
+  case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2:
+    return 24;
+  case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2:
+    return 32;
+  case GL_FLOAT_MAT3:
+    return 36;
+  case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3:
+    return 48;
+  case GL_FLOAT_MAT4: case GL_DOUBLE_MAT2x4: case GL_DOUBLE_MAT4x2:
+    return 64;
+  case GL_DOUBLE:
+    return 8;
+  case GL_DOUBLE_VEC2:
+    return 16;
+  case GL_DOUBLE_VEC3:
+    return 24;
+  case GL_DOUBLE_VEC4: case GL_DOUBLE_MAT2:
+    return 32;
+  case GL_DOUBLE_MAT2x3: case GL_DOUBLE_MAT3x2:
+    return 48;
+  case GL_DOUBLE_MAT3:
+    return 72;
+  case GL_DOUBLE_MAT3x4: case GL_DOUBLE_MAT4x3:
+    return 96;
+  case GL_DOUBLE_MAT4:
+    return 128;
+  default:
+    return isSamplerType(type) ? 4 : 0;
+  }
+}
+
+bool isUnsignedType(GLenum type)
+{
+  return type == GL_UNSIGNED_INT || type == GL_UNSIGNED_INT_VEC2
+    || type == GL_UNSIGNED_INT_VEC3 || type == GL_UNSIGNED_INT_VEC4;
+}
+
+bool isDoubleType(GLenum type)
+{
+  switch (type)
+  {
+  case GL_DOUBLE: case GL_DOUBLE_VEC2: case GL_DOUBLE_VEC3: case GL_DOUBLE_VEC4:
+  case GL_DOUBLE_MAT2: case GL_DOUBLE_MAT3: case GL_DOUBLE_MAT4:
+  case GL_DOUBLE_MAT2x3: case GL_DOUBLE_MAT2x4: case GL_DOUBLE_MAT3x2:
+  case GL_DOUBLE_MAT3x4: case GL_DOUBLE_MAT4x2: case GL_DOUBLE_MAT4x3:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool isIntegerType(GLenum type)
+{
+  switch (type)
+  {
+  case GL_INT: case GL_INT_VEC2: case GL_INT_VEC3: case GL_INT_VEC4:
+  case GL_BOOL: case GL_BOOL_VEC2: case GL_BOOL_VEC3: case GL_BOOL_VEC4:
+    return true;
+  default:
+    return isSamplerType(type);
+  }
+}
+
+template <typename Entry>
+Entry const* findByHash(std::vector<Entry> const& entries, UniformName name)
+{
+  auto it = std::lower_bound(entries.begin(), entries.end(), name.hash(),
+    [](Entry const& entry, std::uint64_t hash) { return entry.hash < hash; });
+  for (; it != entries.end() && it->hash == name.hash(); ++it)
+  {
+    if (it->name == name.str())
+    {
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
+template <typename Entry>
+void sortByHash(std::vector<Entry>& entries)
+{
+  std::sort(entries.begin(), entries.end(), [](Entry const& a, Entry const& b) { return a.hash < b.hash; });
+}
+
+}
+
+bool isSamplerType(GLenum type)
+{
+  switch (type)
+  {
+  case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+  case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_CUBE_SHADOW:
+  case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_1D_ARRAY_SHADOW: case GL_SAMPLER_2D_ARRAY_SHADOW:
+  case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_SAMPLER_BUFFER: case GL_SAMPLER_2D_RECT:
+  case GL_SAMPLER_2D_RECT_SHADOW:
+  case GL_INT_SAMPLER_1D: case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE:
+  case GL_INT_SAMPLER_1D_ARRAY: case GL_INT_SAMPLER_2D_ARRAY: case GL_INT_SAMPLER_2D_MULTISAMPLE:
+  case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_INT_SAMPLER_BUFFER: case GL_INT_SAMPLER_2D_RECT:
+  case GL_UNSIGNED_INT_SAMPLER_1D: case GL_UNSIGNED_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_3D:
+  case GL_UNSIGNED_INT_SAMPLER_CUBE: case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+  case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE: case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+  case GL_UNSIGNED_INT_SAMPLER_BUFFER: case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void UniformTable::reflect(GLuint program)
+{
+  uniforms_.clear();
+  blocks_.clear();
+  slots_.clear();
+  shadow_.clear();
+
+  GLint uniform_count = 0;
+  GLint max_name_length = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniform_count);
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+  std::string name(static_cast<std::size_t>(std::max(max_name_length, 1)), '\0');
+
+  for (GLint i = 0; i < uniform_count; ++i)
+  {
+    GLsizei length = 0;
+    GLint count = 0;
+    GLenum type = 0;
+    glGetActiveUniform(program, static_cast<GLuint>(i), max_name_length, &length, &count, &type, name.data());
+    std::string_view base_name{ name.data(), static_cast<std::size_t>(length) };
+    if (base_name.size() > 3 && base_name.substr(base_name.size() - 3) == "[0]")
+    {
+      base_name.remove_suffix(3);
+    }
+
+    // Members of uniform blocks and built-ins have no location and are not set one at a time
+    GLint const location = glGetUniformLocation(program, name.c_str());
+    if (location < 0)
+    {
+      continue;
+    }
+    std::uint32_t const stride = shadowSize(type);
+    if (stride == 0)
+    {
+      // Images, for one, have no typed setter
+      std::cerr << "[WARNING] Uniform " << base_name << " has unsupported type 0x" << std::hex << type << std::dec
+        << " and cannot be set through ShaderProgram::setUniform.\n";
+      continue;
+    }
+    uniforms_.push_back({ std::string{ base_name }, fnv1a_hash(base_name), location, type, count });
+
+    std::uint32_t const offset = static_cast<std::uint32_t>(shadow_.size());
+    std::uint32_t const end = offset + stride * static_cast<std::uint32_t>(count);
+    shadow_.resize(end);
+    for (GLint element = 0; element < count; ++element)
+    {
+      GLint const element_location = (element == 0) ? location
+        : glGetUniformLocation(program, (std::string{ base_name } + '[' + std::to_string(element) + ']').c_str());
+      if (element_location < 0)
+      {
+        continue;
+      }
+      if (static_cast<std::size_t>(element_location) >= slots_.size())
+      {
+        slots_.resize(static_cast<std::size_t>(element_location) + 1);
+      }
+      std::uint32_t const element_offset = offset + stride * static_cast<std::uint32_t>(element);
+      slots_[element_location] = { type, stride, element_offset, end };
+
+      // Start from what the program holds, which is zero unless the shader gave an initializer
+      void* const shadow = shadow_.data() + element_offset;
+      if (isUnsignedType(type))
+      {
+        glGetUniformuiv(program, element_location, static_cast<GLuint*>(shadow));
+      }
+      else if (isDoubleType(type))
+      {
+        glGetUniformdv(program, element_location, static_cast<GLdouble*>(shadow));
+      }
+      else if (isIntegerType(type))
+      {
+        glGetUniformiv(program, element_location, static_cast<GLint*>(shadow));
+      }
+      else
+      {
+        glGetUniformfv(program, element_location, static_cast<GLfloat*>(shadow));
+      }
+    }
+  }
+
+  GLint block_count = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &block_count);
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &max_name_length);
+  name.assign(static_cast<std::size_t>(std::max(max_name_length, 1)), '\0');
+  for (GLint i = 0; i < block_count; ++i)
+  {
+    GLsizei length = 0;
+    GLint size = 0;
+    glGetActiveUniformBlockName(program, static_cast<GLuint>(i), max_name_length, &length, name.data());
+    glGetActiveUniformBlockiv(program, static_cast<GLuint>(i), GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+    std::string_view const block_name{ name.data(), static_cast<std::size_t>(length) };
+    blocks_.push_back({ std::string{ block_name }, fnv1a_hash(block_name), static_cast<GLuint>(i), size });
+  }
+
+  sortByHash(uniforms_);
+  sortByHash(blocks_);
+}
+
+Uniform const* UniformTable::find(UniformName name) const
+{
+  return findByHash(uniforms_, name);
+}
+
+UniformBlock const* UniformTable::findBlock(UniformName name) const
+{
+  return findByHash(blocks_, name);
+}
+
+}
@@ -0,0 +1,59 @@
+#include <VNgine/uniform_buffer.h>
+
+#include <cstring>
+
+#include <VNgine/gl_resources.h>
+#include <VNgine/gl_state.h>
+
+namespace VNgine
+{
+
+UniformBufferBase::UniformBufferBase(GLuint binding, std::size_t size)
+  : binding_{ binding },
+    shadow_(size)
+{
+  glGenBuffers(1, &id_);
+  GLState::current().bindBuffer(GL_UNIFORM_BUFFER, id_);
+  glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW);
+  GLState::current().bindBufferBase(GL_UNIFORM_BUFFER, binding_, id_);
+}
+
+UniformBufferBase::~UniformBufferBase()
+{
+  GLResources::retire(GLResourceType::BUFFER, id_);
+}
+
+GLuint UniformBufferBase::getID() const
+{
+  return id_;
+}
+
+GLuint UniformBufferBase::getBinding() const
+{
+  return binding_;
+}
+
+std::size_t UniformBufferBase::getSize() const
+{
+  return shadow_.size();
+}
+
+std::size_t UniformBufferBase::getUploads() const
+{
+  return uploads_;
+}
+
+void UniformBufferBase::upload(void const* data)
+{
+  if (uploaded_ && std::memcmp(shadow_.data(), data, shadow_.size()) == 0)
+  {
+    return;
+  }
+  std::memcpy(shadow_.data(), data, shadow_.size());
+  uploaded_ = true;
+  ++uploads_;
+  GLState::current().bindBuffer(GL_UNIFORM_BUFFER, id_);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(shadow_.size()), data);
+}
+
+}
@@ -0,0 +1,373 @@
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <VNgine/engine.h>
+#include <VNgine/entity_store.h>
+#include <VNgine/gl_state.h>
+#include <VNgine/shader.h>
+#include <VNgine/sprite_batch.h>
+#include <VNgine/transform.h>
+#include <VNgine/uniform_buffer.h>
+
+/*
+ * Renders a scripted scene in a headless window for a fixed number of frames and reports
+ * frame time percentiles and main thread CPU time per frame.
+ *
+ *   frame_bench --scene sprites --frames 600 --hash
+ *
+ * Scenes are driven by the frame index rather than the clock, so every run draws the same
+ * frames; with --hash the measured frames are read back and hashed after their time is
+ * taken, and two runs on the same driver should print the same hash. Run it from the
+ * repository root so data/shaders is found.
+ */
+
+namespace
+{
+
+// Matches the Camera block in sprite.vs
+struct CameraBlock
+{
+  glm::mat4 view;
+  glm::mat4 projection;
+};
+constexpr GLuint camera_binding = 0;
+
+struct Options
+{
+  std::string scene = "sprites";
+  std::size_t frames = 600;
+  std::size_t warmup = 60;
+  std::size_t count = 0;  // of the scene's objects; 0 picks the scene's default
+  int width = 1280;
+  int height = 720;
+  bool hash = false;
+};
+
+// What every scene draws with
+struct Renderer
+{
+  VNgine::ShaderPool pool{ "data/shaders" };
+  VNgine::ShaderProgram program{ pool, "sprite", "sprite" };
+  VNgine::UniformBuffer<CameraBlock> camera{ camera_binding };
+  VNgine::SpriteBatch sprites;
+};
+
+// Screen-space quads on four layers, each circling its own grid cell
+class SpriteScene
+{
+public:
+  static constexpr std::size_t default_count = 20000;
+
+  SpriteScene(Renderer& renderer, std::size_t count, int width, int height)
+    : renderer_{ renderer },
+      width_{ float(width) },
+      height_{ float(height) }
+  {
+    std::size_t const columns = std::size_t(std::ceil(std::sqrt(double(count) * width_ / height_)));
+    cell_ = width_ / float(columns);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      float const hue = float(i % 97) / 97.0f;
+      sprites_.push_back({ glm::vec2{ (float(i % columns) + 0.5f) * cell_, (float(i / columns) + 0.5f) * cell_ },
+                           glm::vec4{ hue, 1.0f - hue, 0.5f, 0.75f }, float(i % 13) * 0.4f,
+                           std::uint8_t(i % 4) });
+    }
+  }
+
+  void render(std::size_t frame)
+  {
+    renderer_.camera.update({ glm::mat4{ 1.0f }, glm::ortho(0.0f, width_, 0.0f, height_, -1.0f, 1.0f) });
+    float const time = float(frame) / 60.0f;
+    float const radius = cell_ * 0.25f;
+    renderer_.sprites.begin();
+    for (Sprite const& sprite : sprites_)
+    {
+      float const angle = sprite.phase + time * 2.0f;
+      glm::vec3 const position{ sprite.centre.x + std::cos(angle) * radius, sprite.centre.y + std::sin(angle) * radius,
+                                0.0f };
+      glm::mat4 transform = glm::translate(glm::mat4{ 1.0f }, position);
+      transform = glm::scale(transform, glm::vec3{ cell_ * 0.8f, cell_ * 0.8f, 1.0f });
+      renderer_.sprites.draw(renderer_.program, 0, transform, sprite.color, { 0.0f, 0.0f, 1.0f, 1.0f }, sprite.layer);
+    }
+    renderer_.sprites.end();
+  }
+
+private:
+  struct Sprite
+  {
+    glm::vec2 centre;
+    glm::vec4 color;
+    float phase;
+    std::uint8_t layer;
+  };
+
+  Renderer& renderer_;
+  float width_;
+  float height_;
+  float cell_;
+  std::vector<Sprite> sprites_;
+};
+
+// The game's props, scaled up: spinning entities in a box, seen by an orbiting camera
+class PropScene
+{
+public:
+  static constexpr std::size_t default_count = 5000;
+
+  PropScene(Renderer& renderer, std::size_t count, int width, int height)
+    : renderer_{ renderer },
+      aspect_{ float(width) / float(height) }
+  {
+    VNgine::GLState::current().enable(GL_DEPTH_TEST);
+    std::uint32_t random = 1;
+    auto const next = [&random]
+    {
+      // Fixed LCG, so every run places the props the same
+      random = random * 1664525u + 1013904223u;
+      return float(random >> 8) / float(1u << 24);
+    };
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      glm::vec3 const position{ next() * 20.0f - 10.0f, next() * 20.0f - 10.0f, next() * 20.0f - 10.0f };
+      Prop const prop{ transforms_.add(position), glm::normalize(glm::vec3{ next(), next(), next() } + glm::vec3{ 0.1f }),
+                       next() * 3.0f };
+      entities_.create(prop, Tint{ { next(), next(), next(), 1.0f } });
+    }
+    draws_.resize(count);
+  }
+
+  void render(std::size_t frame)
+  {
+    float const time = float(frame) / 60.0f;
+    glm::vec3 const eye{ std::sin(time * 0.5f) * 30.0f, 6.0f, std::cos(time * 0.5f) * 30.0f };
+    renderer_.camera.update({ glm::lookAt(eye, glm::vec3{ 0.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f }),
+                              glm::perspective(glm::radians(45.0f), aspect_, 0.1f, 100.0f) });
+
+    std::size_t i = 0;
+    entities_.each<Prop const, Tint const>([&](Prop const& prop, Tint const& tint)
+    {
+      transforms_.setRotation(prop.transform, prop.speed * time, prop.axis);
+      draws_[i++].tint = tint.value;
+    });
+    transforms_.computeMatrices(&draws_[0].transform, sizeof(Draw));
+
+    renderer_.sprites.begin();
+    for (Draw const& draw : draws_)
+    {
+      renderer_.sprites.draw(renderer_.program, 0, draw.transform, draw.tint);
+    }
+    renderer_.sprites.end();
+  }
+
+private:
+  struct Prop
+  {
+    std::size_t transform;
+    glm::vec3 axis;
+    float speed;
+  };
+
+  struct Tint
+  {
+    glm::vec4 value;
+  };
+
+  struct Draw
+  {
+    glm::mat4 transform;
+    glm::vec4 tint;
+  };
+
+  Renderer& renderer_;
+  float aspect_;
+  VNgine::EntityStore entities_;
+  VNgine::TransformArray transforms_;
+  std::vector<Draw> draws_;
+};
+
+// CPU time the calling thread has used, in nanoseconds
+std::uint64_t threadCpuNanoseconds()
+{
+#ifdef _WIN32
+  FILETIME creation, exit, kernel, user;
+  GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+  auto const ticks = [](FILETIME const& time)
+  {
+    return (std::uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+  };
+  // FILETIME counts 100 ns intervals
+  return (ticks(kernel) + ticks(user)) * 100;
+#else
+  timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return std::uint64_t(time.tv_sec) * 1000000000u + std::uint64_t(time.tv_nsec);
+#endif
+}
+
+// Nearest-rank percentile of sorted samples
+double percentile(std::vector<double> const& sorted, double fraction)
+{
+  std::size_t const rank = std::size_t(std::ceil(fraction * double(sorted.size())));
+  return sorted[std::min(sorted.size(), std::max<std::size_t>(rank, 1)) - 1];
+}
+
+template <typename Scene>
+int run(Options const& options)
+{
+  VNgine::Window window{ options.width, options.height, "frame bench", VNgine::Window::Mode::HEADLESS };
+  window.getGLState().enable(GL_BLEND);
+  window.getGLState().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+
+  Renderer renderer;
+  if (!renderer.program.isLinked())
+  {
+    std::fprintf(stderr, "[ERROR] The sprite program did not link; run from the repository root.\n");
+    return 1;
+  }
+  renderer.program.bindUniformBlock("Camera", renderer.camera);
+  std::size_t const count = options.count ? options.count : Scene::default_count;
+  Scene scene{ renderer, count, options.width, options.height };
+
+  std::vector<double> frame_ms;
+  std::vector<double> cpu_ms;
+  frame_ms.reserve(options.frames);
+  cpu_ms.reserve(options.frames);
+  std::uint64_t hash = 0;
+  for (std::size_t frame = 0; frame < options.warmup + options.frames; ++frame)
+  {
+    auto const begin = std::chrono::steady_clock::now();
+    std::uint64_t const cpu_begin = threadCpuNanoseconds();
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    scene.render(frame);
+    window.present();
+
+    std::uint64_t const cpu_end = threadCpuNanoseconds();
+    auto const end = std::chrono::steady_clock::now();
+    if (frame < options.warmup)
+    {
+      continue;
+    }
+    frame_ms.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+    cpu_ms.push_back(double(cpu_end - cpu_begin) / 1e6);
+    if (options.hash)
+    {
+      // The offscreen framebuffer still holds the frame after present()
+      hash = (hash ^ window.hashFrame()) * 0x100000001B3;
+    }
+  }
+
+  std::vector<double> sorted = frame_ms;
+  std::sort(sorted.begin(), sorted.end());
+  double total_ms = 0.0;
+  for (double const ms : frame_ms)
+  {
+    total_ms += ms;
+  }
+  double total_cpu_ms = 0.0;
+  for (double const ms : cpu_ms)
+  {
+    total_cpu_ms += ms;
+  }
+  double const frames = double(frame_ms.size());
+  std::printf("scene %s, %zu objects, %dx%d, %zu frames after %zu warmup\n", options.scene.c_str(), count,
+              options.width, options.height, frame_ms.size(), options.warmup);
+  std::printf("  frame ms   mean %8.3f  p50 %8.3f  p90 %8.3f  p99 %8.3f  max %8.3f\n", total_ms / frames,
+              percentile(sorted, 0.50), percentile(sorted, 0.90), percentile(sorted, 0.99), sorted.back());
+  std::printf("  cpu ms     mean %8.3f  (main thread, %.0f%% of frame time)\n", total_cpu_ms / frames,
+              total_ms > 0.0 ? 100.0 * total_cpu_ms / total_ms : 0.0);
+  std::printf("  fps        %8.1f\n", total_ms > 0.0 ? 1000.0 * frames / total_ms : 0.0);
+  if (options.hash)
+  {
+    std::printf("  hash       %016" PRIx64 "\n", hash);
+  }
+  return 0;
+}
+
+void printUsage()
+{
+  std::printf(
+    "usage: frame_bench [--scene sprites|props] [--frames N] [--warmup N] [--count N]\n"
+    "                   [--width W] [--height H] [--hash]\n");
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string_view const argument{ argv[i] };
+    bool const has_value = i + 1 < argc;
+    if (argument == "--scene" && has_value)
+    {
+      options.scene = argv[++i];
+    }
+    else if (argument == "--frames" && has_value)
+    {
+      options.frames = std::strtoull(argv[++i], nullptr, 10);
+    }
+    else if (argument == "--warmup" && has_value)
+    {
+      options.warmup = std::strtoull(argv[++i], nullptr, 10);
+    }
+    else if (argument == "--count" && has_value)
+    {
+      options.count = std::strtoull(argv[++i], nullptr, 10);
+    }
+    else if (argument == "--width" && has_value)
+    {
+      options.width = std::atoi(argv[++i]);
+    }
+    else if (argument == "--height" && has_value)
+    {
+      options.height = std::atoi(argv[++i]);
+    }
+    else if (argument == "--hash")
+    {
+      options.hash = true;
+    }
+    else
+    {
+      printUsage();
+      return argument == "--help" ? 0 : 1;
+    }
+  }
+  if (options.frames == 0 || options.width <= 0 || options.height <= 0)
+  {
+    printUsage();
+    return 1;
+  }
+
+  if (options.scene == "sprites")
+  {
+    return run<SpriteScene>(options);
+  }
+  if (options.scene == "props")
+  {
+    return run<PropScene>(options);
+  }
+  std::fprintf(stderr, "[ERROR] Unknown scene %s.\n", options.scene.c_str());
+  printUsage();
+  return 1;
+}
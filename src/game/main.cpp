@@ -1,8 +1,8 @@
+#include <optional>
 #include <string>
 #include <string_view>
 #include <iostream>
-
-#include <Windows.h>
+#include <vector>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -10,25 +10,69 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <VNgine/engine.h>
+#include <VNgine/entity_store.h>
+#include <VNgine/gl_debug_log.h>
+#include <VNgine/gl_intercept.h>
 #include <VNgine/shader.h>
+#include <VNgine/sprite_batch.h>
 #include <VNgine/input.h>
+#include <VNgine/profiler.h>
+#include <VNgine/render_thread.h>
+#include <VNgine/transform.h>
 
 namespace
 {
 
-glm::vec4 clear_color = { 0.5f, 0.5f, 0.5f, 1.0f };
+enum class Action
+{
+  Quit,
+  Count
+};
+
+constexpr VNgine::ActionMap<Action> actions{ {
+  { Action::Quit, VNgine::key(GLFW_KEY_ESCAPE) },
+} };
+
+// Matches the Camera block in sprite.vs
+struct CameraBlock
+{
+  glm::mat4 view;
+  glm::mat4 projection;
+};
+constexpr GLuint camera_binding = 0;
 
-float vertices[] = {
-     0.5f,  0.5f, 0.0f,  // top right
-     0.5f, -0.5f, 0.0f,  // bottom right
-    -0.5f, -0.5f, 0.0f,  // bottom left
-    -0.5f,  0.5f, 0.0f   // top left 
+struct SpriteDraw
+{
+  glm::mat4 transform;
+  glm::vec4 tint;
 };
-unsigned int indices[] = {
-    0, 1, 3,   // first triangle
-    1, 2, 3    // second triangle
+
+// Components of the scene's props
+struct Position
+{
+  glm::vec3 value;
+};
+
+struct Orientation
+{
+  float angle;
+  glm::vec3 axis;
 };
 
+struct Tint
+{
+  glm::vec4 value;
+};
+
+// Handed from the simulation to the render thread once per frame
+struct FramePacket
+{
+  CameraBlock camera;
+  std::vector<SpriteDraw> sprites;
+};
+
+glm::vec4 clear_color = { 0.5f, 0.5f, 0.5f, 1.0f };
+
 glm::vec3 positions[] = {
   glm::vec3(0.0f,  0.0f,  0.0f),
   glm::vec3(2.0f,  5.0f, -15.0f),
@@ -48,16 +92,52 @@ glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 3.0f);
 glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
 glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
 
-int main()
+int main(int argc, char* argv[])
 {
   std::cout << "[INFO] Game started.\n";
 
+  bool threaded = false;
+  bool gl_debug_sync = false;
+  std::string trace_path;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string_view const argument{ argv[i] };
+    if (argument == "--threaded")
+    {
+      threaded = true;
+    }
+    else if (argument == "--gl-debug-sync")
+    {
+      gl_debug_sync = true;
+    }
+    else if (argument == "--trace" && i + 1 < argc)
+    {
+      trace_path = argv[++i];
+    }
+  }
+  // Records CPU and GPU scopes for a Chrome trace written on exit
+  if (!trace_path.empty())
+  {
+    VNgine::Profiler::setEnabled(true);
+    VNgine::Profiler::setThreadName("Main");
+  }
+
   VNgine::Window window = { 1184, 666, "Game" };
   window.show();
+  // GL debug messages arrive inside the call that raised them, for a breakpoint to catch
+  if (gl_debug_sync && window.getDebugLog())
+  {
+    window.getDebugLog()->setSynchronous(true);
+  }
 
   VNgine::Input input = { window };
+#ifdef VNGINE_GL_INTERCEPT
+  // About every ten seconds at 60 Hz
+  VNgine::GLIntercept::setSummaryInterval(600);
+#endif
 
-  glEnable(GL_DEPTH_TEST);
+  // Applied by the first draw that flushes the GL state
+  window.getGLState().enable(GL_DEPTH_TEST);
   glClearColor(clear_color.r, clear_color.g, clear_color.b, clear_color.a);
 
   positions[0] = { 0, 0, 0 };
@@ -67,58 +147,126 @@ int main()
 
   glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
 
-  VNgine::ShaderPool const shader_pool{ "data/shaders" };
-  VNgine::ShaderProgram const basic_shader{ shader_pool, "basic", "basic" };
+  VNgine::ProgramCache program_cache{ "cache/programs" };
+  VNgine::ShaderPool shader_pool{ "data/shaders", &program_cache };
+  VNgine::ShaderProgram sprite_shader{ shader_pool, "sprite", "sprite" };
+  VNgine::UniformBuffer<CameraBlock> camera{ camera_binding };
+  sprite_shader.bindUniformBlock("Camera", camera);
+  VNgine::SpriteBatch sprites;
+  // Saved edits under data/shaders show up on the next frame
+  shader_pool.watch();
 
   glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-  GLuint VBO, VAO, EBO;
-  glGenVertexArrays(1, &VAO);
-  glGenBuffers(1, &VBO);
-  glGenBuffers(1, &EBO);
+  VNgine::EntityStore entities;
+  for (int i = 0; i < 10; ++i)
+  {
+    float const angle = 20.0f * i;
+    entities.create(Position{ positions[i] }, Orientation{ glm::radians(angle), glm::vec3{ 1.0f, 0.3f, 0.5f } },
+                    Tint{ { 0.4f + 0.06f * i, 0.8f - 0.05f * i, 0.6f, 1.0f } });
+  }
 
-  glBindVertexArray(VAO);
+  // The props never move, so their transforms are built up front, in the order the tints
+  // are gathered
+  VNgine::TransformArray scene;
+  std::vector<glm::vec4> tints;
+  entities.each<Position const, Orientation const, Tint const>(
+    [&](Position const& position, Orientation const& orientation, Tint const& tint)
+  {
+    scene.add(position.value, orientation.angle, orientation.axis);
+    tints.push_back(tint.value);
+  });
 
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+  // Everything the render side needs from one frame of simulation
+  auto const render = [&](FramePacket const& frame)
+  {
+    if (shader_pool.update())
+    {
+      sprite_shader.update();
+    }
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    // Keep presenting frames while the program is still being compiled and linked
+    if (sprite_shader.isReady())
+    {
+      // Once per frame, however many programs read the camera
+      camera.update(frame.camera);
 
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), static_cast<void*>(0));
-  glEnableVertexAttribArray(0);
+      sprites.begin();
+      for (SpriteDraw const& sprite : frame.sprites)
+      {
+        sprites.draw(sprite_shader, 0, sprite.transform, sprite.tint);
+      }
+      sprites.end();
+    }
+  };
 
-  basic_shader.use();
-  GLint uModel, uView, uProjection;
-  uModel = basic_shader.getUniformLocation("model");
-  uView = basic_shader.getUniformLocation("view");
-  uProjection = basic_shader.getUniformLocation("projection");
+  // With --threaded, renders on a thread of its own so a swap blocked on vsync does not
+  // hold up the simulation
+  std::optional<VNgine::RenderThread<FramePacket>> render_thread;
+  if (threaded)
+  {
+    render_thread.emplace(window, render, 2);
+  }
+  FramePacket single_frame;
 
   while (!(window.shouldClose()))
   {   
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    window.poll();
 
-    const float radius = 10.0f;
-    float camX = sinf(glfwGetTime()) * radius;
-    float camZ = cosf(glfwGetTime()) * radius;
-    view = glm::lookAt(glm::vec3(camX, 0.0, camZ), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0));
+    input.drain();
+    if (actions.pressed(input.state(), Action::Quit))
+    {
+      glfwSetWindowShouldClose(window.getHandle(), GLFW_TRUE);
+    }
 
-    basic_shader.setUniform(uView, view);
-    basic_shader.setUniform(uProjection, projection);
+    FramePacket& frame = render_thread ? render_thread->beginFrame() : single_frame;
+    {
+      VNGINE_PROFILE_SCOPE("Simulate");
+      const float radius = 10.0f;
+      float camX = sinf(glfwGetTime()) * radius;
+      float camZ = cosf(glfwGetTime()) * radius;
+      view = glm::lookAt(glm::vec3(camX, 0.0, camZ), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0));
+      frame.camera = { view, projection };
 
-    glBindVertexArray(VAO);
-    for (int i = 0; i < 10; ++i)
+      frame.sprites.resize(scene.size());
+      scene.computeMatrices(&frame.sprites[0].transform, sizeof(SpriteDraw));
+      for (std::size_t i = 0; i < frame.sprites.size(); ++i)
+      {
+        frame.sprites[i].tint = tints[i];
+      }
+    }
+
+    if (render_thread)
     {
-      glm::mat4 local_model = glm::mat4(1.0f);
-      local_model = glm::translate(local_model, positions[i]);
-      float const angle = 20.0f * i;
-      local_model = glm::rotate(local_model, glm::radians(angle), glm::vec3{ 1.0f, 0.3f, 0.5f });
-      basic_shader.setUniform(uModel, local_model);
-      glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+      render_thread->submit();
     }
+    else
+    {
+      VNGINE_PROFILE_SCOPE("Render");
+      render(frame);
+      window.present();
+    }
+  }
 
-    window.present();
-    window.poll();
+  if (render_thread)
+  {
+    render_thread->finish();
+    VNgine::RenderThreadBase::Stats const stats = render_thread->stats();
+    if (stats.frames)
+    {
+      std::cout << "[INFO] Render thread: " << stats.frames << " frames, "
+        << VNgine::RenderThreadBase::overlapNs(stats) / 1e6 << " ms overlapped with simulation, "
+        << stats.main_wait_ns / 1e6 << " ms simulation waiting, "
+        << stats.latency_ns / stats.frames / 1e6 << " ms average latency ("
+        << stats.max_latency_ns / 1e6 << " ms worst).\n";
+    }
+    // Hands the context back before the GL objects above are destroyed
+    render_thread.reset();
+  }
+  if (!trace_path.empty() && VNgine::Profiler::writeChromeTrace(trace_path))
+  {
+    std::cout << "[INFO] Trace written to " << trace_path << ".\n";
   }
 
   return 0;
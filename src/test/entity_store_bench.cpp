@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <VNgine/entity_store.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+constexpr std::size_t entity_count = 1000000;
+
+struct Position
+{
+  glm::vec3 value;
+};
+
+struct Velocity
+{
+  glm::vec3 value;
+};
+
+struct Tint
+{
+  glm::vec4 value;
+};
+
+struct Lifetime
+{
+  float seconds;
+};
+
+// Everything an object might have in one struct, the layout the store replaces
+struct Object
+{
+  glm::vec3 position;
+  glm::vec3 velocity;
+  glm::vec4 tint;
+  float lifetime;
+  bool alive;
+};
+
+void integrate(std::size_t count, Position* positions, Velocity const* velocities)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    positions[i].value += velocities[i].value * 0.016f;
+  }
+}
+
+}
+
+BENCHMARK(entity_store_iteration_and_churn)
+{
+  VNgine::EntityStore store;
+  std::vector<VNgine::Entity> entities;
+  entities.reserve(entity_count);
+  std::vector<Object> objects;
+  objects.reserve(entity_count);
+  test::measure("create 1M entities, 3 archetypes", entity_count, [&]
+  {
+    for (std::size_t i = 0; i < entity_count; ++i)
+    {
+      glm::vec3 const position{ static_cast<float>(i), 0.0f, 0.0f };
+      switch (i % 3)
+      {
+      case 0:
+        entities.push_back(store.create(Position{ position }, Velocity{ { 1.0f, 0.0f, 0.0f } }));
+        break;
+      case 1:
+        entities.push_back(store.create(Position{ position }, Velocity{ { 1.0f, 0.0f, 0.0f } }, Tint{ glm::vec4{ 1.0f } }));
+        break;
+      default:
+        entities.push_back(store.create(Position{ position }, Tint{ glm::vec4{ 1.0f } }));
+        break;
+      }
+    }
+  });
+  for (std::size_t i = 0; i < entity_count; ++i)
+  {
+    objects.push_back({ { static_cast<float>(i), 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, glm::vec4{ 1.0f }, 0.0f, i % 3 != 2 });
+  }
+
+  constexpr std::size_t passes = 20;
+  test::measure("array of structs, position += velocity", entity_count * passes, [&]
+  {
+    for (std::size_t pass = 0; pass < passes; ++pass)
+    {
+      for (Object& object : objects)
+      {
+        if (object.alive)
+        {
+          object.position += object.velocity * 0.016f;
+        }
+      }
+    }
+  });
+  test::measure("store, each<Position, Velocity const>", entity_count * passes, [&]
+  {
+    for (std::size_t pass = 0; pass < passes; ++pass)
+    {
+      store.each<Position, Velocity const>([](Position& position, Velocity const& velocity)
+      {
+        position.value += velocity.value * 0.016f;
+      });
+    }
+  });
+  std::vector<std::size_t> thread_counts{ 1, 2, 4 };
+  if (std::thread::hardware_concurrency() > 4)
+  {
+    thread_counts.push_back(std::thread::hardware_concurrency());
+  }
+  for (std::size_t const threads : thread_counts)
+  {
+    VNgine::JobSystem jobs{ { threads - 1, false } };
+    char label[64];
+    std::snprintf(label, sizeof(label), "store, parallelEachChunk, %zu threads", threads);
+    test::measure(label, entity_count * passes, [&]
+    {
+      for (std::size_t pass = 0; pass < passes; ++pass)
+      {
+        store.parallelEachChunk<Position, Velocity const>(jobs, integrate);
+      }
+    });
+  }
+
+  // Structural churn: a third of the entities gain a component and lose it again, and a
+  // tenth are destroyed and recreated
+  test::measure("add + remove Lifetime, 333k entities", entity_count / 3 * 2, [&]
+  {
+    for (std::size_t i = 0; i < entity_count; i += 3)
+    {
+      store.add(entities[i], Lifetime{ 1.0f });
+    }
+    for (std::size_t i = 0; i < entity_count; i += 3)
+    {
+      store.remove<Lifetime>(entities[i]);
+    }
+  });
+  test::measure("destroy + create, 100k entities", entity_count / 10 * 2, [&]
+  {
+    for (std::size_t i = 0; i < entity_count; i += 10)
+    {
+      store.destroy(entities[i]);
+    }
+    for (std::size_t i = 0; i < entity_count; i += 10)
+    {
+      entities[i] = store.create(Position{ glm::vec3{ 0.0f } }, Velocity{ glm::vec3{ 1.0f } });
+    }
+  });
+  std::printf("  %zu entities, %zu archetypes, %zu chunks\n", store.size(), store.archetypeCount(), store.chunkCount());
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <VNgine/entity_store.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+struct Position
+{
+  glm::vec3 value;
+};
+
+struct Velocity
+{
+  glm::vec3 value;
+};
+
+struct Health
+{
+  int points;
+};
+
+}
+
+TEST_CASE(entity_store_moves_entities_between_archetypes)
+{
+  VNgine::EntityStore store;
+  VNgine::Entity const a = store.create(Position{ { 1.0f, 0.0f, 0.0f } }, Velocity{ { 1.0f, 1.0f, 1.0f } });
+  VNgine::Entity const b = store.create(Position{ { 2.0f, 0.0f, 0.0f } });
+  VNgine::Entity const c = store.create(Position{ { 3.0f, 0.0f, 0.0f } }, Velocity{ { 2.0f, 2.0f, 2.0f } });
+  CHECK(store.size() == 3);
+  CHECK(store.has<Velocity>(a) && !store.has<Velocity>(b));
+
+  // Gaining a component keeps the others, losing one drops only it
+  store.add(b, Health{ 10 });
+  store.add(b, Velocity{ { 3.0f, 3.0f, 3.0f } });
+  CHECK(store.get<Position>(b)->value.x == 2.0f && store.get<Health>(b)->points == 10);
+  store.remove<Velocity>(a);
+  CHECK(!store.has<Velocity>(a) && store.get<Position>(a)->value.x == 1.0f);
+  CHECK(store.get<Velocity>(a) == nullptr);
+  // c was moved into a's old row and must still be found
+  CHECK(store.get<Velocity>(c)->value.x == 2.0f && store.get<Position>(c)->value.x == 3.0f);
+
+  store.destroy(c);
+  CHECK(!store.isAlive(c) && store.isAlive(a) && store.isAlive(b));
+  VNgine::Entity const d = store.create(Health{ 5 });
+  // The index is recycled, the old handle is not revived
+  CHECK(d.index == c.index && !store.isAlive(c) && store.isAlive(d));
+
+  float sum = 0.0f;
+  std::size_t visited = 0;
+  store.each<Position, Velocity const>([&](Position& position, Velocity const& velocity)
+  {
+    position.value += velocity.value;
+    sum += position.value.x;
+    ++visited;
+  });
+  CHECK(visited == 1 && sum == 5.0f);
+  std::size_t healthy = 0;
+  store.each<Health const>([&](Health const& health) { healthy += static_cast<std::size_t>(health.points); });
+  CHECK(healthy == 15);
+}
+
+TEST_CASE(entity_store_iterates_chunks_in_parallel)
+{
+  VNgine::EntityStore store;
+  constexpr std::size_t count = 50000;
+  std::vector<VNgine::Entity> entities;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    float const f = static_cast<float>(i);
+    entities.push_back((i % 3) ? store.create(Position{ { f, 0.0f, 0.0f } }, Velocity{ { 1.0f, 0.0f, 0.0f } })
+                               : store.create(Position{ { f, 0.0f, 0.0f } }, Velocity{ { 1.0f, 0.0f, 0.0f } }, Health{ 1 }));
+  }
+  // Churn: every other entity leaves and rejoins its archetype
+  for (std::size_t i = 0; i < count; i += 2)
+  {
+    store.remove<Velocity>(entities[i]);
+    store.add(entities[i], Velocity{ { 1.0f, 0.0f, 0.0f } });
+  }
+  CHECK(store.size() == count && store.chunkCount() > 4);
+
+  VNgine::JobSystem jobs{ { 3, false } };
+  std::atomic<std::size_t> visited{ 0 };
+  store.parallelEachChunk<Position, Velocity const>(jobs, [&](std::size_t size, Position* positions, Velocity const* velocities)
+  {
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      positions[i].value += velocities[i].value;
+    }
+    visited += size;
+  });
+  CHECK(visited == count);
+  bool moved = true;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    moved = moved && store.get<Position>(entities[i])->value.x == static_cast<float>(i) + 1.0f;
+  }
+  CHECK(moved);
+}
@@ -0,0 +1,35 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include <VNgine/file_watcher.h>
+#include <test/test_framework.h>
+
+namespace fs = std::filesystem;
+
+TEST_CASE(file_watcher_reports_each_written_file_once)
+{
+  fs::path const directory = fs::temp_directory_path() / "vngine_file_watcher_test";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+
+  VNgine::FileWatcher watcher{ directory.string() };
+  if (!watcher.isWatching())
+  {
+    fs::remove_all(directory);
+    return;
+  }
+  CHECK(watcher.poll().empty());
+
+  std::ofstream{ directory / "a.fs" } << "first";
+  std::ofstream{ directory / "a.fs" } << "second";
+  // Write-then-rename, as many editors save
+  std::ofstream{ directory / "b.vs.tmp" } << "temporary";
+  fs::rename(directory / "b.vs.tmp", directory / "b.vs");
+
+  std::vector<std::string> const& changed = watcher.poll();
+  CHECK(std::count(changed.begin(), changed.end(), "a.fs") == 1);
+  CHECK(std::count(changed.begin(), changed.end(), "b.vs") == 1);
+  CHECK(watcher.poll().empty());
+  fs::remove_all(directory);
+}
@@ -0,0 +1,146 @@
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <VNgine/gl_debug_log.h>
+#include <VNgine/ring_buffer.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+void send(VNgine::GLDebugLog& log, GLuint id, GLenum severity = GL_DEBUG_SEVERITY_HIGH,
+          char const* text = "message")
+{
+  log.receive(GL_DEBUG_SOURCE_API, GL_DEBUG_TYPE_PERFORMANCE, id, severity, -1, text);
+}
+
+}
+
+TEST_CASE(mpsc_ring_buffer_keeps_each_producers_order)
+{
+  constexpr std::size_t producers = 4;
+  constexpr std::size_t per_producer = 20000;
+  VNgine::MpscRingBuffer<std::uint64_t, 64> buffer;
+
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p < producers; ++p)
+  {
+    threads.emplace_back([&buffer, p]
+    {
+      for (std::uint64_t i = 0; i < per_producer; ++i)
+      {
+        while (!buffer.push((std::uint64_t(p) << 32) | i))
+        {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  std::vector<std::uint64_t> next(producers, 0);
+  bool ordered = true;
+  for (std::size_t received = 0; received < producers * per_producer;)
+  {
+    std::uint64_t item;
+    if (!buffer.pop(item))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    std::size_t const p = std::size_t(item >> 32);
+    ordered = ordered && p < producers && (item & 0xFFFFFFFF) == next[p];
+    ++next[p];
+    ++received;
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  CHECK(ordered);
+  std::uint64_t item;
+  CHECK(!buffer.pop(item) && buffer.size() == 0);
+}
+
+TEST_CASE(gl_debug_log_folds_repeats_and_filters_by_severity)
+{
+  std::ostringstream out;
+  {
+    VNgine::GLDebugLog::Options options;
+    options.min_severity = VNgine::GLDebugLog::Severity::MEDIUM;
+    options.lines_per_second = 0;
+    options.out = &out;
+    VNgine::GLDebugLog log{ options };
+
+    for (int i = 0; i < 100; ++i)
+    {
+      send(log, 7);
+    }
+    send(log, 8, GL_DEBUG_SEVERITY_MEDIUM, "a different warning");
+    send(log, 9, GL_DEBUG_SEVERITY_LOW);
+    send(log, 10, GL_DEBUG_SEVERITY_NOTIFICATION);
+    log.setMinSeverity(VNgine::GLDebugLog::Severity::NOTIFICATION);
+    send(log, 11, GL_DEBUG_SEVERITY_NOTIFICATION, "now shown");
+    log.flush();
+
+    VNgine::GLDebugLog::Stats const stats = log.stats();
+    CHECK(stats.received == 104);
+    CHECK(stats.filtered == 2);
+    CHECK(stats.dropped == 0);
+    CHECK(stats.repeats == 99);
+    CHECK(stats.written == 3);
+    std::string const text = out.str();
+    CHECK(text.find("[ERROR] GL API performance 7: message\n") != std::string::npos);
+    CHECK(text.find("[WARNING] GL API performance 8: a different warning\n") != std::string::npos);
+    CHECK(text.find("now shown") != std::string::npos);
+    CHECK(text.find(" 9: ") == std::string::npos);
+  }
+  // Repeats not yet reported are summed up when the log goes away
+  CHECK(out.str().find("message 7 repeated 99 more time(s)") != std::string::npos);
+}
+
+TEST_CASE(gl_debug_log_limits_lines_per_second)
+{
+  std::ostringstream out;
+  VNgine::GLDebugLog::Options options;
+  options.lines_per_second = 5;
+  options.out = &out;
+  {
+    VNgine::GLDebugLog log{ options };
+    std::string const long_text(400, 'x');
+    for (GLuint id = 1; id <= 50; ++id)
+    {
+      send(log, id, GL_DEBUG_SEVERITY_HIGH, long_text.c_str());
+    }
+    log.flush();
+    VNgine::GLDebugLog::Stats const stats = log.stats();
+    // A second's worth up front, plus whatever refilled while the test ran
+    CHECK(stats.written >= 5 && stats.written < 10);
+    CHECK(stats.written + stats.rate_limited == 50);
+    // Truncated to fit the queue
+    CHECK(out.str().find(std::string(VNgine::GLDebugMessage::max_text - 1, 'x') + "...\n") != std::string::npos);
+  }
+  CHECK(out.str().find("held back by the line limit") != std::string::npos);
+}
+
+TEST_CASE(gl_debug_log_receives_driver_messages)
+{
+  test::GLContext const context;
+  if (!context || !GLEW_KHR_debug)
+  {
+    return;
+  }
+  std::ostringstream out;
+  VNgine::GLDebugLog::Options options;
+  options.out = &out;
+  VNgine::GLDebugLog log{ options };
+  log.install();
+  log.setSynchronous(true);
+  glDebugMessageInsert(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_MARKER, 42, GL_DEBUG_SEVERITY_HIGH, -1,
+                       "inserted by the test");
+  log.flush();
+  log.uninstall();
+  CHECK(log.stats().written == 1);
+  CHECK(out.str().find("GL application marker 42: inserted by the test") != std::string::npos);
+}
@@ -0,0 +1,74 @@
+#include <VNgine/gl_intercept.h>
+#include <VNgine/stream_buffer.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+#ifdef VNGINE_GL_INTERCEPT
+
+TEST_CASE(gl_intercept_counts_calls_per_frame)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+  // Twice, as a second window would; the wrappers must not wrap themselves
+  VNgine::GLIntercept::install();
+  VNgine::GLIntercept::install();
+  CHECK(VNgine::GLIntercept::isInstalled());
+  VNgine::GLIntercept::endFrame();
+  std::uint64_t const frames = VNgine::GLIntercept::frameCount();
+
+  GLuint vertex_array;
+  glGenVertexArrays(1, &vertex_array);
+  GLuint buffer;
+  glGenBuffers(1, &buffer);
+  glBindVertexArray(vertex_array);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+  float const vertices[12] = {};
+  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, 16, vertices);
+  glBufferData(GL_ARRAY_BUFFER, 4096, nullptr, GL_STREAM_DRAW);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+  glEnableVertexAttribArray(0);
+  glUniform1i(-1, 0);
+  float const matrix[16] = {};
+  glUniformMatrix4fv(-1, 1, GL_FALSE, matrix);
+  glUniformMatrix2x3fv(-1, 1, GL_FALSE, matrix);
+  GLdouble const value = 1.0;
+  glUniform1dv(-1, 1, &value);
+  // Counted whether or not the driver accepts the draw
+  glDrawArraysInstanced(GL_TRIANGLES, 0, 6, 10);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, 1);
+
+  VNgine::GLIntercept::Counts const counts = VNgine::GLIntercept::frame();
+  CHECK(counts.draw_calls == 2 && counts.primitives == 22);
+  CHECK(counts.binds == 2);
+  CHECK(counts.state_changes == 2);
+  CHECK(counts.uniform_calls == 4);
+  CHECK(counts.buffer_bytes == sizeof(vertices) + 16);
+
+  VNgine::GLIntercept::endFrame();
+  CHECK(VNgine::GLIntercept::lastFrame().draw_calls == 2);
+  CHECK(VNgine::GLIntercept::frame().draw_calls == 0);
+  CHECK(VNgine::GLIntercept::frameCount() == frames + 1);
+
+  // Writes into a mapping make no GL call, so StreamBuffer reports them itself
+  {
+    VNgine::StreamBuffer stream{ GL_ARRAY_BUFFER, 1024 };
+    VNgine::GLIntercept::endFrame();
+    VNgine::StreamBuffer::Allocation const allocation = stream.map(64);
+    CHECK(allocation.data != nullptr);
+    stream.unmap();
+    CHECK(VNgine::GLIntercept::frame().buffer_bytes == 64);
+  }
+
+  glBindVertexArray(0);
+  glDeleteBuffers(1, &buffer);
+  glDeleteVertexArrays(1, &vertex_array);
+  while (glGetError() != GL_NO_ERROR)
+  {
+  }
+}
+
+#endif
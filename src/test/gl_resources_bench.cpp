@@ -0,0 +1,134 @@
+#include <cstdio>
+#include <vector>
+
+#include <VNgine/gl_resources.h>
+#include <VNgine/gl_state.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+constexpr std::size_t frames = 500;
+// Live set of small buffers, a quarter of which is replaced each frame
+constexpr std::size_t live = 2048;
+constexpr std::size_t replaced = live / 4;
+constexpr GLsizeiptr buffer_bytes = 256;
+
+std::size_t slotOf(std::size_t frame, std::size_t i)
+{
+  return (frame * 2654435761u + i * 7) % live;
+}
+
+}
+
+BENCHMARK(gl_resources_churn)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    test::GLContext::skip("GL resource churn");
+    return;
+  }
+  VNgine::GLState& gl = VNgine::GLState::current();
+  std::vector<unsigned char> const data(buffer_bytes, 0x5A);
+  std::size_t const operations = frames * replaced;
+  std::printf("  %zu live buffers, %zu replaced per frame, %zu frames\n", live, replaced, frames);
+
+  {
+    std::vector<GLuint> names(live);
+    glGenBuffers(GLsizei(live), names.data());
+    test::measure("glGenBuffers and glDeleteBuffers, per object", operations, [&]
+    {
+      for (std::size_t frame = 0; frame < frames; ++frame)
+      {
+        for (std::size_t i = 0; i < replaced; ++i)
+        {
+          GLuint& name = names[slotOf(frame, i)];
+          gl.deleteBuffer(name);
+          glGenBuffers(1, &name);
+          gl.bindBuffer(GL_ARRAY_BUFFER, name);
+          glBufferData(GL_ARRAY_BUFFER, buffer_bytes, data.data(), GL_STATIC_DRAW);
+        }
+        glFlush();
+      }
+      glFinish();
+    });
+    gl.deleteBuffers(GLsizei(live), names.data());
+  }
+
+  VNgine::GLResources resources;
+  {
+    std::vector<VNgine::GLBufferHandle> handles(live);
+    for (VNgine::GLBufferHandle& handle : handles)
+    {
+      handle = resources.create<VNgine::GLResourceType::BUFFER>();
+    }
+    test::measure("GLResources, deleted in batches behind a fence", operations, [&]
+    {
+      for (std::size_t frame = 0; frame < frames; ++frame)
+      {
+        for (std::size_t i = 0; i < replaced; ++i)
+        {
+          VNgine::GLBufferHandle& handle = handles[slotOf(frame, i)];
+          resources.release(handle);
+          handle = resources.create<VNgine::GLResourceType::BUFFER>();
+          gl.bindBuffer(GL_ARRAY_BUFFER, resources.get(handle));
+          glBufferData(GL_ARRAY_BUFFER, buffer_bytes, data.data(), GL_STATIC_DRAW);
+        }
+        glFlush();
+        resources.endFrame();
+      }
+      glFinish();
+    });
+    VNgine::GLResources::Stats const stats = resources.stats();
+    std::printf("  %zu deleted in %zu driver calls, %zu still pending\n", stats.deleted, stats.delete_calls,
+                stats.pending);
+
+    // What a handle costs over a bare name: the generation check and one indirection
+    constexpr std::size_t lookup_rounds = 2000;
+    std::vector<GLuint> names(live);
+    for (std::size_t i = 0; i < live; ++i)
+    {
+      names[i] = resources.get(handles[i]);
+    }
+    GLuint volatile sink = 0;
+    test::measure("GLuint from a vector", lookup_rounds * live, [&]
+    {
+      for (std::size_t round = 0; round < lookup_rounds; ++round)
+      {
+        GLuint sum = 0;
+        for (std::size_t i = 0; i < live; ++i)
+        {
+          sum += names[slotOf(round, i)];
+        }
+        sink = sink + sum;
+      }
+    });
+    test::measure("GLResources::get", lookup_rounds * live, [&]
+    {
+      for (std::size_t round = 0; round < lookup_rounds; ++round)
+      {
+        GLuint sum = 0;
+        for (std::size_t i = 0; i < live; ++i)
+        {
+          sum += resources.get(handles[slotOf(round, i)]);
+        }
+        sink = sink + sum;
+      }
+    });
+    test::measure("GLResources::names, dense", lookup_rounds * live, [&]
+    {
+      for (std::size_t round = 0; round < lookup_rounds; ++round)
+      {
+        GLuint sum = 0;
+        for (GLuint const name : resources.names(VNgine::GLResourceType::BUFFER))
+        {
+          sum += name;
+        }
+        sink = sink + sum;
+      }
+    });
+  }
+  resources.reset();
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <vector>
+
+#include <VNgine/gl_resources.h>
+#include <VNgine/gl_state.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+TEST_CASE(gl_resources_detect_stale_handles)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+  VNgine::GLResources resources;
+  VNgine::GLBufferHandle const first = resources.create<VNgine::GLResourceType::BUFFER>();
+  GLuint const name = resources.get(first);
+  CHECK(first && name != 0);
+  CHECK(resources.isValid(first));
+
+  resources.release(first);
+  CHECK(!resources.isValid(first));
+  CHECK(resources.get(first) == 0);
+  CHECK(resources.stats().stale_lookups == 1);
+
+  // The slot is reused under a new generation, so the old handle stays stale
+  VNgine::GLBufferHandle const second = resources.create<VNgine::GLResourceType::BUFFER>();
+  CHECK(second.index() == first.index() && second.generation() == first.generation() + 1);
+  CHECK(!resources.isValid(first) && resources.isValid(second));
+  CHECK(!resources.isValid(VNgine::GLBufferHandle{}));
+
+  resources.reset();
+  CHECK(!resources.isValid(second));
+}
+
+TEST_CASE(gl_resources_keep_names_dense)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+  VNgine::GLResources resources;
+  std::vector<VNgine::GLTextureHandle> handles;
+  for (int i = 0; i < 8; ++i)
+  {
+    handles.push_back(resources.create<VNgine::GLResourceType::TEXTURE>());
+  }
+  resources.release(handles[2]);
+  resources.release(handles[5]);
+
+  array_view<GLuint const> const names = resources.names(VNgine::GLResourceType::TEXTURE);
+  CHECK(names.size() == 6);
+  bool all_found = true;
+  for (std::size_t i = 0; i < handles.size(); ++i)
+  {
+    if (i == 2 || i == 5)
+    {
+      continue;
+    }
+    GLuint const name = resources.get(handles[i]);
+    all_found = all_found && std::find(names.begin(), names.end(), name) != names.end();
+  }
+  CHECK(all_found);
+
+  VNgine::GLResources::Stats const stats = resources.stats();
+  CHECK(stats.live[to_integral(VNgine::GLResourceType::TEXTURE)] == 6);
+  CHECK(stats.live[to_integral(VNgine::GLResourceType::BUFFER)] == 0);
+  CHECK(stats.created == 8 && stats.retired == 2 && stats.pending == 2);
+  resources.reset();
+  CHECK(resources.stats().deleted == 8 && resources.stats().pending == 0);
+}
+
+TEST_CASE(gl_resources_delete_after_the_fence)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+  VNgine::GLState& gl = VNgine::GLState::current();
+  VNgine::GLResources resources;
+  resources.makeCurrent();
+
+  VNgine::GLBufferHandle const handles[3] = {
+    resources.create<VNgine::GLResourceType::BUFFER>(),
+    resources.create<VNgine::GLResourceType::BUFFER>(),
+    resources.create<VNgine::GLResourceType::BUFFER>()
+  };
+  GLuint const bound = resources.get(handles[0]);
+  gl.bindBuffer(GL_ARRAY_BUFFER, bound);
+  glBufferData(GL_ARRAY_BUFFER, 256, nullptr, GL_STATIC_DRAW);
+  GLuint vertex_array = 0;
+  glGenVertexArrays(1, &vertex_array);
+  gl.bindVertexArray(vertex_array);
+  for (VNgine::GLBufferHandle const handle : handles)
+  {
+    resources.release(handle);
+  }
+  VNgine::GLResources::retire(VNgine::GLResourceType::VERTEX_ARRAY, vertex_array);
+
+  // Released, but the name lives until the frame's fence has signalled
+  CHECK(glIsBuffer(bound) == GL_TRUE);
+  CHECK(glIsVertexArray(vertex_array) == GL_TRUE);
+  CHECK(resources.stats().pending == 4);
+
+  resources.endFrame();
+  glFinish();
+  resources.endFrame();
+  CHECK(glIsBuffer(bound) == GL_FALSE);
+  CHECK(glIsVertexArray(vertex_array) == GL_FALSE);
+  VNgine::GLResources::Stats const stats = resources.stats();
+  CHECK(stats.pending == 0 && stats.deleted == 4);
+  // One call for the three buffers, one for the vertex array
+  CHECK(stats.delete_calls == 2);
+
+  // Deleted through GLState, so the binding it remembered is gone too
+  GLuint recycled = 0;
+  glGenBuffers(1, &recycled);
+  gl.bindBuffer(GL_ARRAY_BUFFER, recycled);
+  GLint binding = 0;
+  glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &binding);
+  CHECK(binding == static_cast<GLint>(recycled));
+  gl.deleteBuffer(recycled);
+
+  resources.reset();
+  VNgine::GLResources::clearCurrent();
+}
+
+TEST_CASE(gl_resources_retire_immediately_without_a_pool)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+  CHECK(VNgine::GLResources::current() == nullptr);
+  GLuint texture = 0;
+  glGenTextures(1, &texture);
+  VNgine::GLState::current().bindTexture(GL_TEXTURE_2D, texture);
+  VNgine::GLResources::retire(VNgine::GLResourceType::TEXTURE, texture);
+  CHECK(glIsTexture(texture) == GL_FALSE);
+}
@@ -0,0 +1,92 @@
+#include <VNgine/gl_state.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+GLint boundInteger(GLenum name)
+{
+  GLint value = -1;
+  glGetIntegerv(name, &value);
+  return value;
+}
+
+}
+
+TEST_CASE(gl_state_skips_redundant_binds)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+  VNgine::GLState& gl = VNgine::GLState::current();
+  GLuint buffers[2];
+  glGenBuffers(2, buffers);
+  GLuint textures[2];
+  glGenTextures(2, textures);
+
+  gl.endFrame();
+  gl.bindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+  gl.bindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+  gl.bindBuffer(GL_ARRAY_BUFFER, buffers[1]);
+  CHECK(boundInteger(GL_ARRAY_BUFFER_BINDING) == static_cast<GLint>(buffers[1]));
+  CHECK(gl.stats().issued == 2 && gl.stats().skipped == 1);
+
+  // Units are tracked separately, and a texture already on its unit skips the unit switch
+  gl.bindTexture(0, GL_TEXTURE_2D, textures[0]);
+  gl.bindTexture(3, GL_TEXTURE_2D, textures[1]);
+  gl.bindTexture(0, GL_TEXTURE_2D, textures[0]);
+  CHECK(boundInteger(GL_ACTIVE_TEXTURE) == GL_TEXTURE3);
+  CHECK(boundInteger(GL_TEXTURE_BINDING_2D) == static_cast<GLint>(textures[1]));
+
+  gl.viewport(0, 0, 32, 32);
+  gl.viewport(0, 0, 32, 32);
+  CHECK(gl.stats().issued == 7 && gl.stats().skipped == 3);
+
+  gl.endFrame();
+  CHECK(gl.lastFrame().issued == 7 && gl.stats().issued == 0);
+
+  // Deleting a bound object resets its binding, so a recycled name is bound again
+  gl.deleteBuffer(buffers[1]);
+  CHECK(boundInteger(GL_ARRAY_BUFFER_BINDING) == 0);
+  gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+  CHECK(gl.stats().skipped == 1);
+  gl.deleteTexture(textures[1]);
+  gl.deleteTexture(textures[0]);
+  gl.deleteBuffer(buffers[0]);
+
+  // After invalidate() nothing is assumed
+  gl.invalidate();
+  gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+  CHECK(gl.stats().issued == 1);
+}
+
+TEST_CASE(gl_state_flushes_net_capability_changes)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+  VNgine::GLState& gl = VNgine::GLState::current();
+
+  gl.enable(GL_BLEND);
+  gl.enable(GL_DEPTH_TEST);
+  CHECK(!glIsEnabled(GL_BLEND));
+  gl.flush();
+  CHECK(glIsEnabled(GL_BLEND) && glIsEnabled(GL_DEPTH_TEST));
+  CHECK(gl.stats().issued == 2);
+
+  // Toggled and restored between flushes: no call reaches the driver
+  gl.disable(GL_BLEND);
+  gl.enable(GL_BLEND);
+  gl.flush();
+  CHECK(gl.stats().issued == 2 && gl.stats().skipped == 1);
+
+  gl.disable(GL_DEPTH_TEST);
+  gl.flush();
+  CHECK(!glIsEnabled(GL_DEPTH_TEST) && glIsEnabled(GL_BLEND));
+  CHECK(gl.stats().issued == 3);
+}
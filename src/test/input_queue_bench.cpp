@@ -0,0 +1,127 @@
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include <GLFW/glfw3.h>
+
+#include <VNgine/input_queue.h>
+#include <VNgine/thunk.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+constexpr std::size_t total_events = 1'000'000;
+// Roughly what a fast typist plus a 1000 Hz mouse deliver in a single poll
+constexpr std::size_t events_per_poll = 64;
+
+// The previous callback body, minus the console itself: formatting into memory is a lower
+// bound on what writing the same lines to std::cout costs inside glfwPollEvents
+struct PrintingReceiver
+{
+  std::ostringstream out;
+  long long member = 0x69;
+
+  void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+  {
+    out << "Window: 0x" << window << "\n";
+    out << "Key: " << (char)key << "\n";
+    out << "Scancode: 0x" << std::hex << scancode << std::dec << "\n";
+    out << "Action: " << action << "\n";
+    out << "Mods: " << mods << "\n";
+    out << "Member is: " << member << "\n";
+    out.str({});
+  }
+};
+
+// Delivers `events_per_poll` mixed events the way glfwPollEvents would, through the thunks
+template <typename KeyThunk>
+void simulatePoll(KeyThunk const& key, GLFWcursorposfun cursor, GLFWcharfun character, std::size_t frame)
+{
+  for (std::size_t i = 0; i < events_per_poll; i += 4)
+  {
+    int const code = static_cast<int>('A' + (frame + i) % 26);
+    key.getCallback()(nullptr, code, 0, GLFW_PRESS, 0);
+    character(nullptr, static_cast<unsigned int>(code));
+    cursor(nullptr, static_cast<double>(i), static_cast<double>(frame));
+    cursor(nullptr, static_cast<double>(i + 1), static_cast<double>(frame));
+  }
+}
+
+}
+
+BENCHMARK(input_queue_event_flood)
+{
+  VNgine::InputQueue queue;
+  VNgine::Thunk<VNgine::InputQueue, GLFWkeyfun> const key{ &queue, &VNgine::InputQueue::keyCallback };
+  VNgine::Thunk<VNgine::InputQueue, GLFWcharfun> const character{ &queue, &VNgine::InputQueue::charCallback };
+  VNgine::Thunk<VNgine::InputQueue, GLFWcursorposfun> const cursor{ &queue, &VNgine::InputQueue::cursorPosCallback };
+  std::size_t const frames = total_events / events_per_poll;
+
+  PrintingReceiver printing;
+  VNgine::Thunk<PrintingReceiver, GLFWkeyfun> const printing_key{ &printing, &PrintingReceiver::keyCallback };
+  test::measure("previous: format six lines per key event", total_events, [&]
+  {
+    for (std::size_t i = 0; i < total_events; ++i)
+    {
+      printing_key.getCallback()(nullptr, static_cast<int>('A' + i % 26), 0x22, GLFW_PRESS, 0);
+    }
+  });
+
+  test::measure("queue: push per event", total_events, [&]
+  {
+    for (std::size_t i = 0; i < total_events; i += VNgine::InputQueue::capacity)
+    {
+      for (std::size_t j = 0; j < VNgine::InputQueue::capacity; ++j)
+      {
+        key.getCallback()(nullptr, static_cast<int>('A' + j % 26), 0x22, GLFW_PRESS, 0);
+      }
+      queue.drain();
+    }
+  });
+
+  // Time spent inside the callbacks for one poll's worth of events, i.e. what the queue
+  // adds to Window::poll(), followed by the game loop's drain of the same frame
+  double callback_seconds = 0.0;
+  double drain_seconds = 0.0;
+  std::size_t drained = 0;
+  for (std::size_t frame = 0; frame < frames; ++frame)
+  {
+    auto const start = std::chrono::steady_clock::now();
+    simulatePoll(key, cursor.getCallback(), character.getCallback(), frame);
+    auto const polled = std::chrono::steady_clock::now();
+    drained += queue.drain().size();
+    auto const end = std::chrono::steady_clock::now();
+    callback_seconds += std::chrono::duration<double>(polled - start).count();
+    drain_seconds += std::chrono::duration<double>(end - polled).count();
+  }
+  std::printf("  %zu events per poll, %zu after cursor coalescing\n", events_per_poll, drained / frames);
+  std::printf("  %-48s %10.3f us/poll\n", "callbacks inside poll()", callback_seconds * 1e6 / frames);
+  std::printf("  %-48s %10.3f us/frame\n", "drain()", drain_seconds * 1e6 / frames);
+
+  // Producer and consumer on separate threads, as with a dedicated input thread. With a
+  // single core the consumer only runs when the producer is preempted, so skip it there.
+  if (std::thread::hardware_concurrency() < 2)
+  {
+    std::printf("  %-48s skipped, needs two hardware threads\n", "queue: cross-thread push and drain");
+    return;
+  }
+  std::size_t const dropped_before = queue.droppedEvents();
+  test::measure("queue: cross-thread push and drain", total_events, [&]
+  {
+    std::thread producer{ [&key]
+    {
+      for (std::size_t i = 0; i < total_events; ++i)
+      {
+        key.getCallback()(nullptr, static_cast<int>(i), 0, GLFW_PRESS, 0);
+      }
+    } };
+    std::size_t seen = 0;
+    while (seen + queue.droppedEvents() - dropped_before < total_events)
+    {
+      seen += queue.drain().size();
+    }
+    producer.join();
+  });
+  std::printf("  dropped while the consumer lagged: %zu\n", queue.droppedEvents() - dropped_before);
+}
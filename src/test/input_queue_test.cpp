@@ -0,0 +1,117 @@
+#include <thread>
+
+#include <GLFW/glfw3.h>
+
+#include <VNgine/input_queue.h>
+#include <VNgine/ring_buffer.h>
+#include <VNgine/thunk.h>
+#include <test/test_framework.h>
+
+using VNgine::InputEvent;
+
+TEST_CASE(ring_buffer_wraps_and_reports_full)
+{
+  VNgine::SpscRingBuffer<int, 4> buffer;
+  int value = 0;
+  CHECK(!buffer.pop(value));
+
+  for (int round = 0; round < 3; ++round)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      CHECK(buffer.push(round * 4 + i));
+    }
+    CHECK(!buffer.push(-1));
+    CHECK(buffer.size() == 4);
+
+    CHECK(buffer.pop(value) && value == round * 4);
+    int expected = round * 4 + 1;
+    std::size_t const consumed = buffer.consume([&](int item) { CHECK(item == expected++); });
+    CHECK(consumed == 3);
+    CHECK(buffer.size() == 0);
+  }
+}
+
+TEST_CASE(ring_buffer_hands_items_across_threads_in_order)
+{
+  constexpr int count = 100'000;
+  VNgine::SpscRingBuffer<int, 64> buffer;
+  std::thread producer{ [&buffer]
+  {
+    for (int i = 0; i < count; ++i)
+    {
+      while (!buffer.push(i))
+      {
+        std::this_thread::yield();
+      }
+    }
+  } };
+
+  int expected = 0;
+  bool in_order = true;
+  while (expected < count)
+  {
+    buffer.consume([&](int item) { in_order = in_order && (item == expected++); });
+  }
+  producer.join();
+  CHECK(in_order);
+}
+
+TEST_CASE(input_queue_drains_events_in_order_through_thunks)
+{
+  VNgine::InputQueue queue;
+  VNgine::Thunk<VNgine::InputQueue, GLFWkeyfun> const key{ &queue, &VNgine::InputQueue::keyCallback };
+  VNgine::Thunk<VNgine::InputQueue, GLFWcharfun> const character{ &queue, &VNgine::InputQueue::charCallback };
+  VNgine::Thunk<VNgine::InputQueue, GLFWscrollfun> const scroll{ &queue, &VNgine::InputQueue::scrollCallback };
+  VNgine::Thunk<VNgine::InputQueue, GLFWmousebuttonfun> const button{ &queue, &VNgine::InputQueue::mouseButtonCallback };
+
+  key.getCallback()(nullptr, 'G', 0x22, GLFW_PRESS, 0);
+  character.getCallback()(nullptr, 'g');
+  scroll.getCallback()(nullptr, 0.0, -1.5);
+  button.getCallback()(nullptr, 1, GLFW_RELEASE, 0);
+
+  auto const events = queue.drain();
+  CHECK(events.size() == 4);
+  if (events.size() == 4)
+  {
+    CHECK(events[0].type == InputEvent::Type::Key && events[0].code == 'G' && events[0].scancode == 0x22);
+    CHECK(events[0].action == GLFW_PRESS);
+    CHECK(events[1].type == InputEvent::Type::Char && events[1].code == 'g');
+    CHECK(events[2].type == InputEvent::Type::Scroll && events[2].y == -1.5f);
+    CHECK(events[3].type == InputEvent::Type::MouseButton && events[3].code == 1 && events[3].action == GLFW_RELEASE);
+    CHECK(events[0].timestamp <= events[3].timestamp);
+  }
+  CHECK(queue.drain().empty());
+}
+
+TEST_CASE(input_queue_coalesces_consecutive_cursor_motion)
+{
+  VNgine::InputQueue queue;
+  queue.cursorPosCallback(nullptr, 1.0, 1.0);
+  queue.cursorPosCallback(nullptr, 2.0, 2.0);
+  queue.keyCallback(nullptr, 'A', 0, GLFW_PRESS, 0);
+  queue.cursorPosCallback(nullptr, 3.0, 3.0);
+  queue.cursorPosCallback(nullptr, 4.0, 5.0);
+
+  auto const events = queue.drain();
+  CHECK(events.size() == 3);
+  if (events.size() == 3)
+  {
+    CHECK(events[0].type == InputEvent::Type::CursorPos && events[0].x == 2.0f);
+    CHECK(events[1].type == InputEvent::Type::Key);
+    CHECK(events[2].type == InputEvent::Type::CursorPos && events[2].x == 4.0f && events[2].y == 5.0f);
+  }
+}
+
+TEST_CASE(input_queue_counts_events_dropped_when_full)
+{
+  VNgine::InputQueue queue;
+  for (std::size_t i = 0; i < VNgine::InputQueue::capacity + 10; ++i)
+  {
+    queue.charCallback(nullptr, static_cast<unsigned int>(i));
+  }
+  CHECK(queue.droppedEvents() == 10);
+  auto const events = queue.drain();
+  CHECK(events.size() == VNgine::InputQueue::capacity);
+  CHECK(!events.empty() && events[0].code == 0);
+}
@@ -0,0 +1,110 @@
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+
+#include <VNgine/input_state.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+constexpr std::size_t action_count = 256;
+constexpr std::size_t bindings_per_action = 2;
+constexpr std::size_t frames = 100'000;
+
+enum class Action : std::uint16_t
+{
+  Count = action_count
+};
+
+using Actions = VNgine::ActionMap<Action>;
+
+struct BindingTable
+{
+  Actions::Binding bindings[action_count * bindings_per_action];
+};
+
+// Spreads the bindings over every key and mouse button
+constexpr BindingTable makeBindings()
+{
+  BindingTable table{};
+  for (std::size_t i = 0; i < action_count * bindings_per_action; ++i)
+  {
+    table.bindings[i] = { static_cast<Action>(i % action_count),
+                          static_cast<std::uint16_t>((i * 7) % VNgine::button_count) };
+  }
+  return table;
+}
+
+constexpr BindingTable binding_table = makeBindings();
+constexpr Actions actions{ binding_table.bindings };
+
+}
+
+BENCHMARK(input_action_queries)
+{
+  constexpr std::size_t queries = frames * action_count;
+
+  // A handful of keys held, as in a typical frame
+  VNgine::InputState state;
+  state.beginFrame();
+  std::unordered_set<int> held;
+  for (int const key : { GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_SPACE, GLFW_KEY_LEFT_CONTROL })
+  {
+    state.apply({ VNgine::InputEvent::Type::Key, GLFW_PRESS, 0, key, 0, 0.0f, 0.0f, 0 });
+    held.insert(key);
+  }
+
+  // What each system would otherwise do: name the action, then look up its keys
+  std::unordered_map<std::string, std::vector<int>> named_bindings;
+  std::vector<std::string> names;
+  for (Actions::Binding const& binding : binding_table.bindings)
+  {
+    std::string name = "action_" + std::to_string(static_cast<std::size_t>(binding.action));
+    named_bindings[name].push_back(binding.button);
+    if (named_bindings[name].size() == 1)
+    {
+      names.push_back(std::move(name));
+    }
+  }
+
+  std::size_t volatile sink = 0;
+  test::measure("hashed name -> keys -> hashed key state", queries, [&]
+  {
+    std::size_t active = 0;
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      for (std::string const& name : names)
+      {
+        for (int const button : named_bindings.find(name)->second)
+        {
+          if (held.count(button))
+          {
+            ++active;
+            break;
+          }
+        }
+      }
+    }
+    sink = active;
+  });
+
+  test::measure("constexpr action map over bit sets", queries, [&]
+  {
+    std::size_t active = 0;
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      for (std::size_t action = 0; action < action_count; ++action)
+      {
+        active += actions.down(state, static_cast<Action>(action));
+      }
+    }
+    sink = active;
+  });
+
+  std::printf("  action table: %zu bytes, button state: %zu bytes\n", sizeof(actions), sizeof(VNgine::InputState));
+}
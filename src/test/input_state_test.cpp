@@ -0,0 +1,97 @@
+#include <GLFW/glfw3.h>
+
+#include <VNgine/input_queue.h>
+#include <VNgine/input_state.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+enum class Action
+{
+  Jump,
+  Fire,
+  Unbound,
+  Count
+};
+
+constexpr VNgine::ActionMap<Action> actions{ {
+  { Action::Jump, VNgine::key(GLFW_KEY_SPACE) },
+  { Action::Fire, VNgine::mouseButton(GLFW_MOUSE_BUTTON_LEFT) },
+  { Action::Fire, VNgine::key(GLFW_KEY_LEFT_CONTROL) },
+} };
+
+VNgine::InputEvent keyEvent(int key, int action)
+{
+  return { VNgine::InputEvent::Type::Key, static_cast<std::uint8_t>(action), 0, key, 0, 0.0f, 0.0f, 0 };
+}
+
+VNgine::InputEvent buttonEvent(int button, int action)
+{
+  return { VNgine::InputEvent::Type::MouseButton, static_cast<std::uint8_t>(action), 0, button, 0, 0.0f, 0.0f, 0 };
+}
+
+}
+
+static_assert(VNgine::mouseButton(GLFW_MOUSE_BUTTON_LAST) < VNgine::button_count);
+
+TEST_CASE(input_state_tracks_held_buttons_and_per_frame_edges)
+{
+  VNgine::InputState state;
+  std::size_t const space = VNgine::key(GLFW_KEY_SPACE);
+
+  state.beginFrame();
+  state.apply(keyEvent(GLFW_KEY_SPACE, GLFW_PRESS));
+  CHECK(state.down(space) && state.pressed(space) && !state.released(space));
+
+  state.beginFrame();
+  state.apply(keyEvent(GLFW_KEY_SPACE, GLFW_REPEAT));
+  CHECK(state.down(space) && !state.pressed(space));
+
+  state.beginFrame();
+  state.apply(keyEvent(GLFW_KEY_SPACE, GLFW_RELEASE));
+  CHECK(!state.down(space) && state.released(space));
+
+  // A tap shorter than a frame still registers both edges
+  state.beginFrame();
+  state.apply(keyEvent(GLFW_KEY_SPACE, GLFW_PRESS));
+  state.apply(keyEvent(GLFW_KEY_SPACE, GLFW_RELEASE));
+  CHECK(!state.down(space) && state.pressed(space) && state.released(space));
+
+  state.apply(keyEvent(GLFW_KEY_UNKNOWN, GLFW_PRESS));
+  state.apply(buttonEvent(GLFW_MOUSE_BUTTON_LAST, GLFW_PRESS));
+  CHECK(state.down(VNgine::mouseButton(GLFW_MOUSE_BUTTON_LAST)));
+  CHECK(!state.down(VNgine::key(GLFW_KEY_LAST)));
+}
+
+TEST_CASE(input_state_accumulates_scroll_and_keeps_latest_cursor)
+{
+  VNgine::InputState state;
+  state.beginFrame();
+  state.apply({ VNgine::InputEvent::Type::Scroll, 0, 0, 0, 0, 0.0f, 1.0f, 0 });
+  state.apply({ VNgine::InputEvent::Type::Scroll, 0, 0, 0, 0, 0.5f, 2.0f, 0 });
+  state.apply({ VNgine::InputEvent::Type::CursorPos, 0, 0, 0, 0, 10.0f, 20.0f, 0 });
+  CHECK(state.scrollX() == 0.5f && state.scrollY() == 3.0f);
+  CHECK(state.cursorX() == 10.0f && state.cursorY() == 20.0f);
+
+  state.beginFrame();
+  CHECK(state.scrollY() == 0.0f && state.cursorX() == 10.0f);
+}
+
+TEST_CASE(action_map_answers_for_any_bound_button)
+{
+  VNgine::InputState state;
+  state.beginFrame();
+  CHECK(!actions.down(state, Action::Jump) && !actions.down(state, Action::Fire));
+
+  state.apply(keyEvent(GLFW_KEY_LEFT_CONTROL, GLFW_PRESS));
+  CHECK(actions.down(state, Action::Fire) && actions.pressed(state, Action::Fire));
+  CHECK(!actions.down(state, Action::Jump));
+  CHECK(!actions.down(state, Action::Unbound));
+
+  state.beginFrame();
+  state.apply(buttonEvent(GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS));
+  state.apply(keyEvent(GLFW_KEY_LEFT_CONTROL, GLFW_RELEASE));
+  CHECK(actions.down(state, Action::Fire));
+  CHECK(actions.pressed(state, Action::Fire) && actions.released(state, Action::Fire));
+}
@@ -0,0 +1,108 @@
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <VNgine/job_system.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+std::vector<std::size_t> threadCounts()
+{
+  std::size_t const hardware = std::max(std::thread::hardware_concurrency(), 1u);
+  std::vector<std::size_t> counts;
+  for (std::size_t threads = 1; threads < hardware; threads *= 2)
+  {
+    counts.push_back(threads);
+  }
+  counts.push_back(hardware);
+  // Oversubscribed, to show what stealing does when workers outnumber cores
+  if (hardware < 4)
+  {
+    counts.push_back(4);
+  }
+  return counts;
+}
+
+float work(std::size_t i, std::size_t iterations)
+{
+  float value = static_cast<float>(i);
+  for (std::size_t j = 0; j < iterations; ++j)
+  {
+    value = std::sqrt(value + 1.0f);
+  }
+  return value;
+}
+
+}
+
+BENCHMARK(job_system_scaling)
+{
+  std::printf("  %u hardware threads\n", std::thread::hardware_concurrency());
+
+  // Fine grained: 1M elements of ~10 ns each, 256 per range; scheduling cost shows
+  constexpr std::size_t fine_count = 1 << 20;
+  // Coarse grained: 256 jobs of ~0.2 ms each; only load balance matters
+  constexpr std::size_t coarse_count = 256;
+  constexpr std::size_t coarse_iterations = 20000;
+  std::vector<float> out(fine_count);
+
+  test::measure("serial, fine grained", fine_count, [&]
+  {
+    for (std::size_t i = 0; i < fine_count; ++i)
+    {
+      out[i] = work(i, 4);
+    }
+  });
+  test::measure("serial, coarse grained", coarse_count, [&]
+  {
+    for (std::size_t i = 0; i < coarse_count; ++i)
+    {
+      out[i] = work(i, coarse_iterations);
+    }
+  });
+
+  for (std::size_t const threads : threadCounts())
+  {
+    VNgine::JobSystem jobs{ { threads - 1, false } };
+    char label[64];
+    std::snprintf(label, sizeof(label), "%zu threads, fine grained", threads);
+    test::measure(label, fine_count, [&]
+    {
+      jobs.parallelFor(fine_count, 256, [&out](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          out[i] = work(i, 4);
+        }
+      });
+    });
+    std::snprintf(label, sizeof(label), "%zu threads, coarse grained", threads);
+    test::measure(label, coarse_count, [&]
+    {
+      jobs.parallelFor(coarse_count, 1, [&out](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          out[i] = work(i, coarse_iterations);
+        }
+      });
+    });
+    // Overhead of a job on its own: run, then wait for 100k empty ones
+    constexpr std::size_t empty_count = 100000;
+    std::snprintf(label, sizeof(label), "%zu threads, empty jobs", threads);
+    test::measure(label, empty_count, [&]
+    {
+      VNgine::JobCounter counter;
+      for (std::size_t i = 0; i < empty_count; ++i)
+      {
+        jobs.run(counter, [] {});
+      }
+      jobs.wait(counter);
+    });
+    VNgine::JobSystem::Stats const stats = jobs.stats();
+    std::printf("  %llu jobs, %llu steals, %llu sleeps\n", static_cast<unsigned long long>(stats.jobs),
+      static_cast<unsigned long long>(stats.steals), static_cast<unsigned long long>(stats.sleeps));
+  }
+}
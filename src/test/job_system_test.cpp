@@ -0,0 +1,105 @@
+#include <atomic>
+#include <vector>
+
+#include <VNgine/job_system.h>
+#include <VNgine/work_stealing_deque.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+struct Tree
+{
+  VNgine::JobSystem* jobs;
+  std::atomic<std::size_t>* visited;
+  unsigned depth;
+
+  void operator()() const
+  {
+    visited->fetch_add(1, std::memory_order_relaxed);
+    if (depth > 0)
+    {
+      jobs->runChild(Tree{ jobs, visited, depth - 1 });
+      jobs->runChild(Tree{ jobs, visited, depth - 1 });
+    }
+  }
+};
+
+}
+
+TEST_CASE(work_stealing_deque_pops_newest_and_steals_oldest)
+{
+  VNgine::WorkStealingDeque<int, 4> deque;
+  int item = 0;
+  CHECK(!deque.pop(item) && !deque.steal(item));
+  CHECK(deque.push(1) && deque.push(2) && deque.push(3) && deque.push(4));
+  CHECK(!deque.push(5));
+  CHECK(deque.pop(item) && item == 4);
+  CHECK(deque.steal(item) && item == 1);
+  CHECK(deque.size() == 2);
+  CHECK(deque.push(6) && deque.push(7) && !deque.push(8));
+  CHECK(deque.steal(item) && item == 2);
+  CHECK(deque.pop(item) && item == 7);
+  CHECK(deque.pop(item) && item == 6);
+  CHECK(deque.pop(item) && item == 3);
+  CHECK(!deque.pop(item) && !deque.steal(item) && deque.size() == 0);
+}
+
+TEST_CASE(job_system_waits_for_children)
+{
+  for (std::size_t workers : { 0, 1, 3 })
+  {
+    VNgine::JobSystem jobs{ { workers, workers == 1 } };
+    CHECK(jobs.threadCount() == workers + 1);
+
+    // A full binary tree of jobs, each spawning its two children
+    std::atomic<std::size_t> visited{ 0 };
+    VNgine::JobCounter counter;
+    jobs.run(counter, Tree{ &jobs, &visited, 12 });
+    jobs.wait(counter);
+    CHECK(counter.isDone());
+    CHECK(visited == (std::size_t{ 1 } << 13) - 1);
+
+    // More jobs queued at once than a worker has slots for
+    std::atomic<std::size_t> sum{ 0 };
+    for (std::size_t i = 0; i < 3 * VNgine::JobSystem::queue_capacity; ++i)
+    {
+      jobs.run(counter, [&sum, i] { sum.fetch_add(i, std::memory_order_relaxed); });
+    }
+    jobs.wait(counter);
+    std::size_t const n = 3 * VNgine::JobSystem::queue_capacity;
+    CHECK(sum == n * (n - 1) / 2);
+    CHECK(jobs.stats().jobs == (std::size_t{ 1 } << 13) - 1 + n);
+  }
+}
+
+TEST_CASE(job_system_parallel_for_covers_each_index_once)
+{
+  VNgine::JobSystem jobs{ { 3, false } };
+  constexpr std::size_t count = 100003;
+  std::vector<std::atomic<unsigned>> hits(count);
+  std::atomic<std::size_t> largest{ 0 };
+  jobs.parallelFor(count, 100, [&](std::size_t begin, std::size_t end)
+  {
+    std::size_t size = end - begin;
+    std::size_t seen = largest.load();
+    while (size > seen && !largest.compare_exchange_weak(seen, size))
+    {
+    }
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      hits[i].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  bool once = true;
+  for (std::atomic<unsigned> const& hit : hits)
+  {
+    once = once && hit == 1;
+  }
+  CHECK(once);
+  CHECK(largest <= 100);
+
+  bool called = false;
+  jobs.parallelFor(0, 1, [&](std::size_t, std::size_t) { called = true; });
+  CHECK(!called);
+}
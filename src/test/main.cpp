@@ -1,9 +1,18 @@
 #include <iostream>
+#include <string_view>
 
-#include <VNgine/engine.h>
+#include <test/test_framework.h>
 
-int main()
+int main(int argc, char** argv)
 {
+  if (argc > 1 && std::string_view{ argv[1] } == "--bench")
+  {
+    std::cout << "Benchmarks started." << std::endl;
+    return test::runBenchmarks();
+  }
+
   std::cout << "Tests started." << std::endl;
-  return 0;
-}
\ No newline at end of file
+  int const failures = test::runAll();
+  std::cout << "Tests finished with " << failures << " failed check(s)." << std::endl;
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <vector>
+
+#include <VNgine/frame_allocator.h>
+#include <VNgine/object_pool.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+constexpr std::size_t frames = 2000;
+// A busy frame's worth of transient allocations: draw packets, strings, small arrays
+constexpr std::size_t allocations_per_frame = 1000;
+
+// 16 to 256 bytes, the same sequence every frame
+std::size_t sizeOf(std::size_t i)
+{
+  return 16 + (i * 37 % 16) * 16;
+}
+
+struct Packet
+{
+  float transform[16];
+  std::uint32_t key;
+  std::uint32_t count;
+};
+
+}
+
+BENCHMARK(frame_memory_against_malloc)
+{
+  std::size_t const operations = frames * allocations_per_frame;
+  std::vector<void*> pointers(allocations_per_frame);
+  unsigned volatile sink = 0;
+
+  test::measure("malloc and free, per allocation", operations, [&]
+  {
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      for (std::size_t i = 0; i < allocations_per_frame; ++i)
+      {
+        pointers[i] = std::malloc(sizeOf(i));
+        static_cast<unsigned char*>(pointers[i])[0] = static_cast<unsigned char>(i);
+      }
+      sink = sink + static_cast<unsigned char*>(pointers[frame % allocations_per_frame])[0];
+      for (void* const pointer : pointers)
+      {
+        std::free(pointer);
+      }
+    }
+  });
+
+  VNgine::FrameAllocator allocator{ 64 * 1024 };
+  test::measure("FrameAllocator, reset once per frame", operations, [&]
+  {
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      for (std::size_t i = 0; i < allocations_per_frame; ++i)
+      {
+        pointers[i] = allocator.allocate(sizeOf(i), 16);
+        static_cast<unsigned char*>(pointers[i])[0] = static_cast<unsigned char>(i);
+      }
+      sink = sink + static_cast<unsigned char*>(pointers[frame % allocations_per_frame])[0];
+      allocator.reset();
+    }
+  });
+  std::printf("  %zu allocations overflowed to the heap while the block grew to %zu KiB\n",
+              allocator.stats().overflows, allocator.getCapacity() / 1024);
+
+  // Containers built and thrown away each frame, e.g. per-frame draw lists
+  constexpr std::size_t lists = 100;
+  constexpr std::size_t packets_per_list = 64;
+  std::size_t const list_operations = frames * lists * packets_per_list;
+  test::measure("std::vector<Packet>, heap", list_operations, [&]
+  {
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      for (std::size_t list = 0; list < lists; ++list)
+      {
+        std::vector<Packet> packets;
+        for (std::size_t i = 0; i < packets_per_list; ++i)
+        {
+          packets.push_back({ {}, std::uint32_t(i), std::uint32_t(list) });
+        }
+        sink = sink + packets.back().key;
+      }
+    }
+  });
+  test::measure("std::pmr::vector<Packet>, frame arena", list_operations, [&]
+  {
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      for (std::size_t list = 0; list < lists; ++list)
+      {
+        std::pmr::vector<Packet> packets{ VNgine::FrameMemory::resource() };
+        for (std::size_t i = 0; i < packets_per_list; ++i)
+        {
+          packets.push_back({ {}, std::uint32_t(i), std::uint32_t(list) });
+        }
+        sink = sink + packets.back().key;
+      }
+      VNgine::FrameMemory::endFrame();
+    }
+  });
+}
+
+BENCHMARK(object_pool_against_new)
+{
+  // Objects that live a few frames: each frame replaces a quarter of the live set
+  constexpr std::size_t live = 4096;
+  constexpr std::size_t rounds = 2000;
+  constexpr std::size_t replaced = live / 4;
+  std::size_t const operations = rounds * replaced;
+  std::vector<Packet*> objects(live);
+
+  for (Packet*& object : objects)
+  {
+    object = new Packet{};
+  }
+  test::measure("new and delete", operations, [&]
+  {
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+      for (std::size_t i = 0; i < replaced; ++i)
+      {
+        std::size_t const index = (round * 2654435761u + i * 7) % live;
+        delete objects[index];
+        objects[index] = new Packet{ {}, std::uint32_t(i), std::uint32_t(round) };
+      }
+    }
+  });
+  for (Packet* const object : objects)
+  {
+    delete object;
+  }
+
+  VNgine::ObjectPool<Packet> pool;
+  for (Packet*& object : objects)
+  {
+    object = pool.create();
+  }
+  test::measure("ObjectPool create and destroy", operations, [&]
+  {
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+      for (std::size_t i = 0; i < replaced; ++i)
+      {
+        std::size_t const index = (round * 2654435761u + i * 7) % live;
+        pool.destroy(objects[index]);
+        objects[index] = pool.create(Packet{ {}, std::uint32_t(i), std::uint32_t(round) });
+      }
+    }
+  });
+  for (Packet* const object : objects)
+  {
+    pool.destroy(object);
+  }
+}
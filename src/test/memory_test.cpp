@@ -0,0 +1,132 @@
+#include <cstdint>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <VNgine/frame_allocator.h>
+#include <VNgine/memory_tracker.h>
+#include <VNgine/object_pool.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+struct Particle
+{
+  float position[3];
+  float age;
+  static inline int alive = 0;
+
+  Particle(float x, float y, float z)
+    : position{ x, y, z },
+      age{ 0.0f }
+  {
+    ++alive;
+  }
+  ~Particle() { --alive; }
+};
+
+}
+
+TEST_CASE(frame_memory_keeps_a_frame_valid_until_the_one_after_next)
+{
+  // Other tests may have ended frames already
+  std::uint64_t const start = VNgine::FrameMemory::frame();
+  VNgine::FrameAllocator& first = VNgine::FrameMemory::allocator();
+  int* const kept = first.allocate<int>();
+  *kept = 42;
+
+  VNgine::FrameMemory::endFrame();
+  CHECK(VNgine::FrameMemory::frame() == start + 1);
+  VNgine::FrameAllocator& second = VNgine::FrameMemory::allocator();
+  CHECK(&second != &first);
+  second.allocate<int>(16);
+  // Still there a frame later
+  CHECK(*kept == 42 && first.stats().used != 0);
+
+  VNgine::FrameMemory::endFrame();
+  CHECK(&VNgine::FrameMemory::allocator() == &first);
+  CHECK(first.stats().used == 0);
+
+  // Standard containers allocate from the arena and give nothing back
+  std::size_t const used = first.stats().used;
+  {
+    std::pmr::vector<int> numbers{ VNgine::FrameMemory::resource() };
+    for (int i = 0; i < 100; ++i)
+    {
+      numbers.push_back(i);
+    }
+    CHECK(numbers[99] == 99);
+    std::pmr::string text{ "longer than any small-string buffer", VNgine::FrameMemory::resource() };
+    CHECK(text.size() == 35);
+  }
+  CHECK(first.stats().used >= used + 100 * sizeof(int));
+}
+
+TEST_CASE(object_pool_reuses_slots)
+{
+  VNgine::MemoryTracker::Stats const before = VNgine::MemoryTracker::stats(VNgine::MemoryTag::ENTITIES);
+  {
+    VNgine::ObjectPool<Particle, 4> pool{ VNgine::MemoryTag::ENTITIES };
+    std::vector<Particle*> particles;
+    for (int i = 0; i < 10; ++i)
+    {
+      particles.push_back(pool.create(float(i), 0.0f, 0.0f));
+    }
+    CHECK(Particle::alive == 10 && pool.size() == 10 && pool.capacity() == 12);
+    CHECK(particles[9]->position[0] == 9.0f);
+    // A fresh chunk hands out its slots in order
+    CHECK(particles[1] == particles[0] + 1);
+
+    Particle* const freed = particles[3];
+    pool.destroy(freed);
+    CHECK(Particle::alive == 9);
+    // The slot freed last is the next one used, and the pool does not grow
+    CHECK(pool.create(1.0f, 2.0f, 3.0f) == freed);
+    CHECK(pool.capacity() == 12);
+    CHECK(VNgine::MemoryTracker::stats(VNgine::MemoryTag::ENTITIES).current > before.current);
+
+    particles[3] = freed;
+    for (Particle* const particle : particles)
+    {
+      pool.destroy(particle);
+    }
+    CHECK(Particle::alive == 0 && pool.size() == 0);
+  }
+  CHECK(VNgine::MemoryTracker::stats(VNgine::MemoryTag::ENTITIES).current == before.current);
+}
+
+TEST_CASE(memory_tracker_counts_tagged_blocks_and_peaks)
+{
+  VNgine::MemoryTracker::Stats const before = VNgine::MemoryTracker::stats(VNgine::MemoryTag::SHADERS);
+  VNgine::MemoryTracker::Stats const total_before = VNgine::MemoryTracker::total();
+  {
+    VNgine::TrackedResource tracked{ VNgine::MemoryTag::SHADERS };
+    std::pmr::vector<char> bytes{ &tracked };
+    bytes.resize(1000);
+    VNgine::MemoryTracker::Stats const during = VNgine::MemoryTracker::stats(VNgine::MemoryTag::SHADERS);
+    CHECK(during.current == before.current + 1000);
+    CHECK(during.peak >= before.current + 1000);
+    CHECK(during.allocations == before.allocations + 1);
+    CHECK(VNgine::MemoryTracker::total().current == total_before.current + 1000);
+  }
+  VNgine::MemoryTracker::Stats const after = VNgine::MemoryTracker::stats(VNgine::MemoryTag::SHADERS);
+  CHECK(after.current == before.current && after.peak >= before.current + 1000);
+
+  // A frame allocator reports its block, and its grown block after an overflow
+  VNgine::MemoryTracker::Stats const rendering = VNgine::MemoryTracker::stats(VNgine::MemoryTag::RENDERING);
+  {
+    VNgine::FrameAllocator allocator{ 256, VNgine::MemoryTag::RENDERING };
+    CHECK(VNgine::MemoryTracker::stats(VNgine::MemoryTag::RENDERING).current == rendering.current + 256);
+    allocator.allocate(1024);
+    allocator.reset();
+    CHECK(VNgine::MemoryTracker::stats(VNgine::MemoryTag::RENDERING).current
+          == rendering.current + allocator.getCapacity());
+  }
+  CHECK(VNgine::MemoryTracker::stats(VNgine::MemoryTag::RENDERING).current == rendering.current);
+
+  std::ostringstream report;
+  VNgine::MemoryTracker::report(report);
+  CHECK(report.str().find("shaders") != std::string::npos && report.str().find("total") != std::string::npos);
+}
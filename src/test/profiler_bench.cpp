@@ -0,0 +1,43 @@
+#include <chrono>
+#include <sstream>
+
+#include <VNgine/profiler.h>
+#include <test/test_framework.h>
+
+BENCHMARK(profiler_scope_overhead)
+{
+  constexpr std::size_t scopes = 1000000;
+  VNgine::Profiler::clear();
+  test::measure("scope, recording off", scopes, []
+  {
+    for (std::size_t i = 0; i < scopes; ++i)
+    {
+      VNgine::CpuScope const scope{ "off" };
+    }
+  });
+  VNgine::Profiler::setEnabled(true);
+  test::measure("scope, recording on", scopes, []
+  {
+    for (std::size_t i = 0; i < scopes; ++i)
+    {
+      VNgine::CpuScope const scope{ "on" };
+    }
+  });
+  VNgine::Profiler::setEnabled(false);
+  volatile std::int64_t sink = 0;
+  test::measure("two steady_clock::now() calls, for comparison", scopes, [&]
+  {
+    for (std::size_t i = 0; i < scopes; ++i)
+    {
+      auto const begin = std::chrono::steady_clock::now();
+      sink = sink + (std::chrono::steady_clock::now() - begin).count();
+    }
+  });
+  std::ostringstream out;
+  test::measure("export ring to Chrome trace JSON", VNgine::Profiler::events_per_thread, [&]
+  {
+    VNgine::Profiler::writeChromeTrace(out);
+  });
+  std::printf("  %zu bytes of JSON\n", out.str().size());
+  VNgine::Profiler::clear();
+}
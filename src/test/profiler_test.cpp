@@ -0,0 +1,123 @@
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <VNgine/profiler.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+std::size_t occurrences(std::string const& text, std::string const& pattern)
+{
+  std::size_t count = 0;
+  for (std::size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1))
+  {
+    ++count;
+  }
+  return count;
+}
+
+std::string trace()
+{
+  std::ostringstream out;
+  VNgine::Profiler::writeChromeTrace(out);
+  return out.str();
+}
+
+}
+
+TEST_CASE(profiler_exports_cpu_scopes_per_thread)
+{
+  VNgine::Profiler::clear();
+  {
+    VNgine::CpuScope const ignored{ "disabled scope" };
+  }
+  VNgine::Profiler::setEnabled(true);
+  {
+    VNgine::CpuScope const outer{ "outer" };
+    VNgine::CpuScope const inner{ "inner \"quoted\"" };
+  }
+  std::thread{ []
+  {
+    VNgine::Profiler::setThreadName("Helper");
+    VNgine::CpuScope const scope{ "on helper" };
+  } }.join();
+  VNgine::Profiler::setEnabled(false);
+
+  std::string const json = trace();
+  CHECK(json.front() == '{' && json.find("\n]}\n") == json.size() - 4);
+  CHECK(occurrences(json, "\"ph\":\"X\"") == 3);
+  CHECK(json.find("disabled scope") == std::string::npos);
+  CHECK(json.find("\"name\":\"inner \\\"quoted\\\"\"") != std::string::npos);
+  CHECK(json.find("\"args\":{\"name\":\"Helper\"}") != std::string::npos);
+  CHECK(json.find("\"name\":\"on helper\"") != std::string::npos);
+
+  // The outer scope starts first and lasts longer
+  auto const field = [&](std::string const& name, char const* key)
+  {
+    std::size_t const at = json.find(key, json.find("\"name\":\"" + name));
+    return std::stod(json.substr(at + std::string{ key }.size()));
+  };
+  CHECK(field("outer", "\"ts\":") <= field("inner", "\"ts\":"));
+  CHECK(field("outer", "\"dur\":") >= field("inner", "\"dur\":"));
+
+  // The helper thread is gone, its track with it
+  VNgine::Profiler::clear();
+  std::string const cleared = trace();
+  CHECK(occurrences(cleared, "\"ph\":\"X\"") == 0);
+  CHECK(cleared.find("Helper") == std::string::npos);
+}
+
+TEST_CASE(gpu_profiler_reads_back_timestamps_without_stalling)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+  VNgine::Profiler::clear();
+  VNgine::Profiler::setEnabled(true);
+  {
+    VNgine::GpuProfiler profiler;
+    profiler.makeCurrent();
+    for (int frame = 0; frame < 8; ++frame)
+    {
+      {
+        VNgine::GpuScope const outer{ "frame" };
+        VNgine::GpuScope const inner{ "flush" };
+        glFlush();
+      }
+      // Lets the queries finish before the next frame looks at them
+      glFinish();
+      profiler.endFrame();
+    }
+    VNgine::GpuProfiler::Stats const stats = profiler.stats();
+    CHECK(stats.frames_read + stats.frames_dropped <= 8 && stats.frames_read >= 4);
+    CHECK(stats.scopes == 2 * stats.frames_read);
+    profiler.reset();
+    VNgine::GpuProfiler::clearCurrent();
+  }
+  VNgine::Profiler::setEnabled(false);
+
+  std::string const json = trace();
+  CHECK(occurrences(json, "\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":0") >= 4);
+  CHECK(occurrences(json, "\"name\":\"flush\",\"ph\":\"X\",\"pid\":1,\"tid\":0") >= 4);
+  CHECK(glGetError() == GL_NO_ERROR);
+  VNgine::Profiler::clear();
+}
+
+TEST_CASE(profiler_keeps_the_last_gpu_scopes)
+{
+  VNgine::Profiler::clear();
+  for (std::size_t i = 0; i < VNgine::Profiler::events_per_thread + 10; ++i)
+  {
+    VNgine::Profiler::recordGpu(i < 10 ? "overwritten" : "kept", i, i + 1);
+  }
+
+  std::string const json = trace();
+  CHECK(occurrences(json, "\"name\":\"kept\",\"ph\":\"X\",\"pid\":1,\"tid\":0") == VNgine::Profiler::events_per_thread);
+  CHECK(json.find("overwritten") == std::string::npos);
+  VNgine::Profiler::clear();
+}
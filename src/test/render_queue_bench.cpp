@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <VNgine/gl_state.h>
+#include <VNgine/render_queue.h>
+#include <VNgine/shader.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr std::size_t program_count = 8;
+constexpr std::size_t texture_count = 64;
+
+GLint offset_location = -1;
+
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void setOffset(VNgine::ShaderProgram const& program, void const* payload)
+{
+  program.setUniform(offset_location, *static_cast<float const*>(payload));
+}
+
+// Fills the queue the way a frame of scattered systems would: random layers, programs,
+// textures and depths, one float of payload per draw
+void submitFrame(VNgine::RenderQueue& queue, std::size_t count, std::vector<std::unique_ptr<VNgine::ShaderProgram>> const& programs,
+                 GLuint vertex_array, std::vector<GLuint> const& textures)
+{
+  std::mt19937 random{ 7 };
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    std::uint32_t const program = random() % program_count;
+    std::uint32_t const texture = random() % texture_count;
+    float* const offset = queue.allocate<float>();
+    *offset = static_cast<float>(i % 100) * 0.01f;
+    VNgine::DrawCommand& command = queue.submit(VNgine::RenderKey::make(static_cast<std::uint8_t>(random() % 4),
+      0, program, 0, texture));
+    command.program = programs[program].get();
+    command.vertex_array = vertex_array;
+    command.texture = textures[texture];
+    command.mode = GL_POINTS;
+    command.count = 1;
+    command.prepare = setOffset;
+    command.payload = offset;
+  }
+}
+
+}
+
+BENCHMARK(render_queue_sort_and_submit)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    test::GLContext::skip("render queue sort and submit");
+    return;
+  }
+
+  fs::path const directory = fs::temp_directory_path() / "vngine_render_queue_bench";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  std::ofstream{ directory / "point.vs" } <<
+    "#version 330 core\nuniform float offset;\n"
+    "void main() { gl_Position = vec4(offset, 0.0, 0.0, 1.0); }\n";
+  std::ofstream{ directory / "point.fs" } <<
+    "#version 330 core\nout vec4 frag_color;\nvoid main() { frag_color = vec4(1.0); }\n";
+
+  {
+    VNgine::ShaderPool const pool{ directory.string() };
+    std::vector<std::unique_ptr<VNgine::ShaderProgram>> programs;
+    for (std::size_t i = 0; i < program_count; ++i)
+    {
+      programs.push_back(std::make_unique<VNgine::ShaderProgram>(pool, "point", "point"));
+    }
+    offset_location = programs.front()->getUniformLocation("offset");
+    std::vector<GLuint> textures(texture_count);
+    glGenTextures(static_cast<GLsizei>(texture_count), textures.data());
+    GLuint vertex_array;
+    glGenVertexArrays(1, &vertex_array);
+    VNgine::GLState& gl = VNgine::GLState::current();
+    GLuint framebuffer, color;
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 1, 1);
+    gl.bindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    // Submission cost is the point here, not fill rate
+    gl.enable(GL_RASTERIZER_DISCARD);
+
+    std::printf("  %-10s %12s %12s %12s %12s %14s\n", "packets", "submit ms", "radix ms", "std::sort ms", "execute ms", "state changes");
+    for (std::size_t const count : { std::size_t{ 10000 }, std::size_t{ 100000 }, std::size_t{ 1000000 } })
+    {
+      VNgine::RenderQueue queue{ count };
+      // A first frame sizes the queue's memory and warms the driver, as in a running game
+      submitFrame(queue, count, programs, vertex_array, textures);
+      queue.sort();
+      queue.execute();
+      glFinish();
+      queue.clear();
+      std::size_t const overflows = queue.getAllocator().stats().overflows;
+
+      auto start = std::chrono::steady_clock::now();
+      submitFrame(queue, count, programs, vertex_array, textures);
+      double const submit = millisecondsSince(start);
+
+      std::vector<VNgine::RenderQueue::Packet> copy{ queue.getPackets().begin(), queue.getPackets().end() };
+      start = std::chrono::steady_clock::now();
+      std::sort(copy.begin(), copy.end(),
+        [](VNgine::RenderQueue::Packet const& a, VNgine::RenderQueue::Packet const& b) { return a.key < b.key; });
+      double const reference = millisecondsSince(start);
+
+      start = std::chrono::steady_clock::now();
+      queue.sort();
+      double const sort = millisecondsSince(start);
+
+      start = std::chrono::steady_clock::now();
+      queue.execute();
+      glFinish();
+      double const execute = millisecondsSince(start);
+
+      VNgine::RenderQueue::Stats const& stats = queue.stats();
+      std::printf("  %-10zu %12.3f %12.3f %12.3f %12.3f %14zu\n", count, submit, sort, reference, execute,
+        stats.program_changes + stats.texture_changes + stats.vertex_array_changes);
+      CHECK(glGetError() == GL_NO_ERROR);
+      CHECK(stats.draw_calls == count && queue.getAllocator().stats().overflows == overflows);
+      queue.clear();
+    }
+
+    gl.disable(GL_RASTERIZER_DISCARD);
+    gl.flush();
+    gl.deleteVertexArray(vertex_array);
+    gl.deleteFramebuffer(framebuffer);
+    glDeleteRenderbuffers(1, &color);
+    for (GLuint const texture : textures)
+    {
+      gl.deleteTexture(texture);
+    }
+  }
+  fs::remove_all(directory);
+}
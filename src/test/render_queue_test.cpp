@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include <VNgine/frame_allocator.h>
+#include <VNgine/gl_state.h>
+#include <VNgine/render_queue.h>
+#include <VNgine/shader.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+int prepared = 0;
+
+void countPrepare(VNgine::ShaderProgram const&, void const* payload)
+{
+  prepared += *static_cast<int const*>(payload);
+}
+
+// Submits `count` packets with keys drawn from few distinct values, recording submission
+// order in `first`, and checks the sort against std::stable_sort
+void checkSortOrder(std::size_t count)
+{
+  VNgine::RenderQueue queue{ 16, 64 };
+  std::mt19937_64 random{ count };
+  std::vector<VNgine::RenderQueue::Packet> expected;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    std::uint64_t const key = VNgine::RenderKey::make(static_cast<std::uint8_t>(random() % 3),
+      static_cast<std::uint32_t>(random() % 5), 7, static_cast<std::uint32_t>(random() % 4), 1);
+    VNgine::DrawCommand& command = queue.submit(key);
+    command.first = i;
+    expected.push_back({ key, &command });
+  }
+  std::stable_sort(expected.begin(), expected.end(),
+    [](VNgine::RenderQueue::Packet const& a, VNgine::RenderQueue::Packet const& b) { return a.key < b.key; });
+  queue.sort();
+
+  array_view<VNgine::RenderQueue::Packet const> const sorted = queue.getPackets();
+  CHECK(sorted.size() == count);
+  bool same = true;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    same = same && sorted[i].key == expected[i].key && sorted[i].command == expected[i].command;
+  }
+  CHECK(same);
+}
+
+}
+
+TEST_CASE(frame_allocator_aligns_and_grows_after_overflow)
+{
+  VNgine::FrameAllocator allocator{ 64 };
+  auto* const byte = allocator.allocate<char>();
+  auto* const wide = allocator.allocate<double>(2);
+  CHECK(reinterpret_cast<std::uintptr_t>(wide) % alignof(double) == 0);
+  CHECK(reinterpret_cast<char*>(wide) > byte);
+  void* const page = allocator.allocate(16, 64);
+  CHECK(reinterpret_cast<std::uintptr_t>(page) % 64 == 0);
+
+  // Beyond the block: served from the heap, and the block grows at the next reset
+  int* const overflow = allocator.allocate<int>(100);
+  overflow[99] = 1;
+  CHECK(allocator.stats().overflows >= 1);
+  std::size_t const used = allocator.stats().used;
+  allocator.reset();
+  CHECK(allocator.stats().used == 0 && allocator.stats().peak == used);
+  CHECK(allocator.getCapacity() >= used);
+
+  std::size_t const overflows = allocator.stats().overflows;
+  allocator.allocate<int>(100);
+  CHECK(allocator.stats().overflows == overflows);
+}
+
+TEST_CASE(render_queue_sorts_by_key_and_keeps_submission_order)
+{
+  CHECK(VNgine::RenderKey::make(1, 0, 0, 0, 0) > VNgine::RenderKey::make(0, 0xFFFFFF, 1023, 1023, 4095));
+  CHECK(VNgine::RenderKey::make(0, 1, 0, 0, 0) > VNgine::RenderKey::make(0, 0, 1023, 1023, 4095));
+  CHECK(VNgine::RenderKey::make(0, 0, 0, 0, 4096) == VNgine::RenderKey::make(0, 0, 0, 0, 0));
+  CHECK(VNgine::RenderKey::depth(10.0f, 10.0f, true) < VNgine::RenderKey::depth(1.0f, 10.0f, true));
+
+  // Both the small-queue path and the radix sort
+  checkSortOrder(100);
+  checkSortOrder(5000);
+}
+
+TEST_CASE(render_queue_binds_only_what_changes)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+
+  fs::path const directory = fs::temp_directory_path() / "vngine_render_queue_test";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  std::ofstream{ directory / "point.vs" } << "#version 330 core\nvoid main() { gl_Position = vec4(0.0); }\n";
+  std::ofstream{ directory / "point.fs" } <<
+    "#version 330 core\nout vec4 frag_color;\nvoid main() { frag_color = vec4(1.0); }\n";
+
+  {
+    VNgine::ShaderPool const pool{ directory.string() };
+    VNgine::ShaderProgram const first{ pool, "point", "point" };
+    VNgine::ShaderProgram const second{ pool, "point", "point" };
+    GLuint vertex_array;
+    glGenVertexArrays(1, &vertex_array);
+    GLuint textures[2];
+    glGenTextures(2, textures);
+    VNgine::GLState& gl = VNgine::GLState::current();
+    // The hidden window's default framebuffer may not be drawable
+    GLuint framebuffer, color;
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 1, 1);
+    gl.bindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    gl.enable(GL_RASTERIZER_DISCARD);
+
+    VNgine::RenderQueue queue;
+    int* const weight = queue.allocate<int>();
+    *weight = 2;
+    // Interleaved submissions: two programs, each drawing with both textures twice
+    for (std::uint32_t i = 0; i < 8; ++i)
+    {
+      std::uint32_t const program = i % 2;
+      std::uint32_t const texture = (i / 2) % 2;
+      VNgine::DrawCommand& command = queue.submit(VNgine::RenderKey::make(0, 0, program, 0, texture));
+      command.program = program ? &second : &first;
+      command.vertex_array = vertex_array;
+      command.texture = textures[texture];
+      command.mode = GL_POINTS;
+      command.count = 1;
+      command.prepare = countPrepare;
+      command.payload = weight;
+    }
+    queue.sort();
+    prepared = 0;
+    queue.execute();
+    CHECK(glGetError() == GL_NO_ERROR);
+    CHECK(queue.stats().draw_calls == 8 && prepared == 16);
+    CHECK(queue.stats().program_changes == 2);
+    CHECK(queue.stats().vertex_array_changes == 1);
+    CHECK(queue.stats().texture_changes == 4);
+    queue.clear();
+    CHECK(queue.getPackets().empty() && queue.getAllocator().stats().used == 0);
+
+    gl.disable(GL_RASTERIZER_DISCARD);
+    gl.flush();
+    gl.deleteTexture(textures[0]);
+    gl.deleteTexture(textures[1]);
+    gl.deleteVertexArray(vertex_array);
+    gl.deleteFramebuffer(framebuffer);
+    glDeleteRenderbuffers(1, &color);
+  }
+  fs::remove_all(directory);
+}
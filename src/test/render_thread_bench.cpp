@@ -0,0 +1,103 @@
+#include <chrono>
+#include <thread>
+
+#include <VNgine/engine.h>
+#include <VNgine/render_thread.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t frames = 60;
+// A 60 Hz display. The swap is emulated by sleeping to the next vblank, since a hidden
+// window never blocks in glfwSwapBuffers.
+constexpr std::chrono::microseconds refresh{ 16667 };
+// Each side alone fits in a frame, both together do not
+constexpr std::chrono::microseconds simulate_time{ 10000 };
+constexpr std::chrono::microseconds render_time{ 9000 };
+
+struct Packet
+{
+  std::size_t frame;
+};
+
+void spin(std::chrono::microseconds duration)
+{
+  Clock::time_point const end = Clock::now() + duration;
+  while (Clock::now() < end)
+  {
+  }
+}
+
+// Stands in for a frame of driver work that is mostly waiting on the GPU, then the swap
+void renderAndWaitForVblank(Clock::time_point epoch)
+{
+  glClear(GL_COLOR_BUFFER_BIT);
+  std::this_thread::sleep_for(render_time);
+  auto const since = Clock::now() - epoch;
+  std::this_thread::sleep_until(epoch + (since / refresh + 1) * refresh);
+}
+
+void report(char const* label, double seconds, VNgine::RenderThreadBase::Stats const* stats)
+{
+  std::printf("  %-28s %8.1f fps", label, static_cast<double>(frames) / seconds);
+  if (stats && stats->frames)
+  {
+    std::printf(" %8.2f ms latency %8.2f ms worst %8.1f%% overlapped",
+      static_cast<double>(stats->latency_ns) / static_cast<double>(stats->frames) / 1e6,
+      static_cast<double>(stats->max_latency_ns) / 1e6,
+      100.0 * static_cast<double>(VNgine::RenderThreadBase::overlapNs(*stats)) / (seconds * 1e9));
+  }
+  std::printf("\n");
+}
+
+}
+
+BENCHMARK(render_thread_frame_rate)
+{
+  {
+    test::GLContext const probe;
+    if (!probe)
+    {
+      test::GLContext::skip("render thread frame rate");
+      return;
+    }
+  }
+  VNgine::Window window{ 64, 64, "render thread bench" };
+  std::printf("  %lld us simulation, %lld us rendering, %lld us refresh\n",
+    static_cast<long long>(simulate_time.count()), static_cast<long long>(render_time.count()),
+    static_cast<long long>(refresh.count()));
+
+  {
+    Clock::time_point const start = Clock::now();
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      window.poll();
+      spin(simulate_time);
+      renderAndWaitForVblank(start);
+      window.present();
+    }
+    report("single thread", std::chrono::duration<double>(Clock::now() - start).count(), nullptr);
+  }
+
+  for (std::size_t const in_flight : { std::size_t{ 2 }, std::size_t{ 3 } })
+  {
+    Clock::time_point const start = Clock::now();
+    VNgine::RenderThread<Packet> renderer{ window, [start](Packet const&) { renderAndWaitForVblank(start); }, in_flight };
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      window.poll();
+      Packet& packet = renderer.beginFrame();
+      spin(simulate_time);
+      packet.frame = frame;
+      renderer.submit();
+    }
+    renderer.finish();
+    VNgine::RenderThreadBase::Stats const stats = renderer.stats();
+    report(in_flight == 2 ? "render thread, 2 in flight" : "render thread, 3 in flight",
+      std::chrono::duration<double>(Clock::now() - start).count(), &stats);
+  }
+}
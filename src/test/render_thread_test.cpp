@@ -0,0 +1,79 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <VNgine/engine.h>
+#include <VNgine/gl_state.h>
+#include <VNgine/render_thread.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+struct Packet
+{
+  std::size_t frame;
+  std::vector<int> payload;
+};
+
+}
+
+TEST_CASE(render_thread_presents_packets_in_order_with_bounded_latency)
+{
+  {
+    test::GLContext const probe;
+    if (!probe)
+    {
+      return;
+    }
+  }
+  VNgine::Window window{ 64, 64, "render thread test" };
+  std::thread::id const main_thread = std::this_thread::get_id();
+
+  std::vector<std::size_t> rendered;
+  bool on_render_thread = true;
+  bool context_current = true;
+  bool packets_intact = true;
+  {
+    VNgine::RenderThread<Packet> renderer{ window, [&](Packet const& packet)
+    {
+      on_render_thread = on_render_thread && std::this_thread::get_id() != main_thread;
+      context_current = context_current && glGetString(GL_VERSION) != nullptr;
+      packets_intact = packets_intact && packet.payload.size() == packet.frame % 7;
+      rendered.push_back(packet.frame);
+      // Slower than the main thread, so it has to wait for free packets
+      std::this_thread::sleep_for(std::chrono::milliseconds{ 2 });
+    }, 2 };
+    // The main thread no longer owns the context
+    CHECK(&VNgine::GLState::current() != &window.getGLState());
+
+    constexpr std::size_t frames = 20;
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      Packet& packet = renderer.beginFrame();
+      packet.frame = frame;
+      packet.payload.assign(frame % 7, 1);
+      renderer.submit();
+    }
+    renderer.finish();
+
+    VNgine::RenderThreadBase::Stats const stats = renderer.stats();
+    CHECK(stats.frames == frames);
+    CHECK(stats.main_wait_ns > 0);
+    // Two packets in flight: a frame never waits on more than two renders
+    CHECK(stats.max_latency_ns < 200000000);
+    CHECK(stats.latency_ns >= stats.frames * 2000000);
+  }
+  CHECK(on_render_thread && context_current && packets_intact);
+  bool in_order = rendered.size() == 20;
+  for (std::size_t i = 0; in_order && i < rendered.size(); ++i)
+  {
+    in_order = rendered[i] == i;
+  }
+  CHECK(in_order);
+
+  // The context and its tracker are back on this thread
+  CHECK(&VNgine::GLState::current() == &window.getGLState());
+  CHECK(glGetString(GL_VERSION) != nullptr);
+}
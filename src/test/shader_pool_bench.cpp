@@ -0,0 +1,264 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <VNgine/shader.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr std::size_t program_count = 200;
+
+// Enough work per shader that compiling, not file I/O, dominates. `variant` changes the
+// source text so no run is served from the driver's shader cache.
+std::string vertexSource(std::size_t index, std::size_t variant)
+{
+  return "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\n"
+    "uniform mat4 model;\nuniform mat4 view;\nuniform mat4 projection;\n"
+    "out vec3 color;\n"
+    "vec3 wave(vec3 p, float k)\n{\n"
+    "  for (int i = 0; i < 8; ++i) { p = sin(p * k + float(i)) * 0.5 + cos(p.zxy * k) * 0.25 + p; }\n"
+    "  return p;\n}\n"
+    "void main()\n{\n"
+    "  vec3 p = wave(aPos, " + std::to_string(index) + ".0 + " + std::to_string(variant) + ".5);\n"
+    "  color = p;\n"
+    "  gl_Position = projection * view * model * vec4(p, 1.0);\n}\n";
+}
+
+std::string fragmentSource(std::size_t index, std::size_t variant)
+{
+  return "#version 330 core\n"
+    "in vec3 color;\nout vec4 FragColor;\n"
+    "vec3 shade(vec3 c, float k)\n{\n"
+    "  for (int i = 0; i < 8; ++i) { c = fract(c * k + vec3(float(i))) + smoothstep(0.0, 1.0, c.yzx); }\n"
+    "  return c;\n}\n"
+    "void main()\n{\n"
+    "  FragColor = vec4(shade(color, " + std::to_string(index) + ".0 + " + std::to_string(variant) + ".5), 1.0);\n}\n";
+}
+
+fs::path writeShaderDirectory(std::size_t variant)
+{
+  fs::path const directory = fs::temp_directory_path() / ("vngine_shader_bench_" + std::to_string(variant));
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  for (std::size_t i = 0; i < program_count; ++i)
+  {
+    std::string const name = "material_" + std::to_string(i);
+    std::ofstream{ directory / (name + ".vs") } << vertexSource(i, variant);
+    std::ofstream{ directory / (name + ".fs") } << fragmentSource(i, variant);
+  }
+  return directory;
+}
+
+// The previous startup path: read through a stringstream, compile and wait, one at a time
+GLuint compileAndWait(fs::path const& path, GLenum type)
+{
+  std::stringstream source_stream;
+  source_stream << std::ifstream{ path }.rdbuf();
+  std::string const source = source_stream.str();
+  char const* text = source.c_str();
+
+  GLuint const id = glCreateShader(type);
+  glShaderSource(id, 1, &text, nullptr);
+  glCompileShader(id);
+  GLint success;
+  glGetShaderiv(id, GL_COMPILE_STATUS, &success);
+  return id;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+BENCHMARK(shader_pool_startup)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    test::GLContext::skip("shader pool startup");
+    return;
+  }
+  std::printf("  %zu programs, %s, parallel compile %s\n", program_count,
+    reinterpret_cast<char const*>(glGetString(GL_RENDERER)),
+    (GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile) ? "available" : "unavailable");
+
+  {
+    fs::path const directory = writeShaderDirectory(0);
+    std::vector<GLuint> programs;
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < program_count; ++i)
+    {
+      std::string const name = "material_" + std::to_string(i);
+      GLuint const vs = compileAndWait(directory / (name + ".vs"), GL_VERTEX_SHADER);
+      GLuint const fs = compileAndWait(directory / (name + ".fs"), GL_FRAGMENT_SHADER);
+      GLuint const program = glCreateProgram();
+      glAttachShader(program, vs);
+      glAttachShader(program, fs);
+      glLinkProgram(program);
+      GLint success;
+      glGetProgramiv(program, GL_LINK_STATUS, &success);
+      programs.push_back(program);
+    }
+    std::printf("  %-48s %10.3f ms\n", "previous: serial compile and wait", secondsSince(start) * 1e3);
+    for (GLuint const program : programs)
+    {
+      glDeleteProgram(program);
+    }
+    fs::remove_all(directory);
+  }
+
+  {
+    fs::path const directory = writeShaderDirectory(1);
+    auto const start = std::chrono::steady_clock::now();
+    VNgine::ShaderPool const pool{ directory.string() };
+    std::vector<std::unique_ptr<VNgine::ShaderProgram>> programs;
+    for (std::size_t i = 0; i < program_count; ++i)
+    {
+      std::string const name = "material_" + std::to_string(i);
+      programs.push_back(std::make_unique<VNgine::ShaderProgram>(pool, std::string_view{ name }, std::string_view{ name }));
+    }
+    double const issued = secondsSince(start);
+
+    double first_ready = 0.0;
+    std::size_t ready = 0;
+    std::vector<bool> done(program_count, false);
+    while (ready < program_count)
+    {
+      for (std::size_t i = 0; i < program_count; ++i)
+      {
+        if (!done[i] && programs[i]->isReady())
+        {
+          done[i] = true;
+          first_ready = (ready++ == 0) ? secondsSince(start) : first_ready;
+        }
+      }
+    }
+    double const all_ready = secondsSince(start);
+    std::printf("  %-48s %10.3f ms\n", "pool: every compile and link issued", issued * 1e3);
+    std::printf("  %-48s %10.3f ms\n", "pool: first program ready", first_ready * 1e3);
+    std::printf("  %-48s %10.3f ms\n", "pool: every program ready", all_ready * 1e3);
+    fs::remove_all(directory);
+  }
+}
+
+namespace
+{
+
+// One launch: load the pool, build every program and wait until all of them are linked
+double launch(fs::path const& shaders, fs::path const& cache_directory, VNgine::ProgramCache::Stats& stats)
+{
+  auto const start = std::chrono::steady_clock::now();
+  VNgine::ProgramCache cache{ cache_directory.string() };
+  VNgine::ShaderPool const pool{ shaders.string(), &cache };
+  std::vector<std::unique_ptr<VNgine::ShaderProgram>> programs;
+  for (std::size_t i = 0; i < program_count; ++i)
+  {
+    std::string const name = "material_" + std::to_string(i);
+    programs.push_back(std::make_unique<VNgine::ShaderProgram>(pool, std::string_view{ name }, std::string_view{ name }));
+  }
+  for (auto const& program : programs)
+  {
+    program->isLinked();
+  }
+  stats = cache.stats();
+  return secondsSince(start);
+}
+
+void printLaunch(char const* label, double seconds, VNgine::ProgramCache::Stats const& stats)
+{
+  std::printf("  %-48s %10.3f ms   hits %zu, misses %zu, read %zu KiB, written %zu KiB\n", label, seconds * 1e3,
+    stats.hits, stats.misses, stats.bytes_read / 1024, stats.bytes_written / 1024);
+}
+
+}
+
+BENCHMARK(program_cache_startup)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    test::GLContext::skip("program cache startup");
+    return;
+  }
+
+  fs::path const shaders = writeShaderDirectory(2);
+  fs::path const cache_directory = fs::temp_directory_path() / "vngine_program_cache_bench";
+  fs::remove_all(cache_directory);
+  if (!VNgine::ProgramCache{ cache_directory.string() }.isEnabled())
+  {
+    std::printf("  skipped, the driver offers no program binary formats\n");
+    fs::remove_all(shaders);
+    return;
+  }
+
+  VNgine::ProgramCache::Stats stats{};
+  printLaunch("cold cache: compile, link and store", launch(shaders, cache_directory, stats), stats);
+  printLaunch("warm cache: load binaries", launch(shaders, cache_directory, stats), stats);
+
+  fs::remove_all(cache_directory);
+  fs::remove_all(shaders);
+}
+
+BENCHMARK(shader_hot_reload_idle)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    test::GLContext::skip("shader hot reload idle");
+    return;
+  }
+
+  fs::path const shaders = writeShaderDirectory(3);
+  VNgine::ShaderPool pool{ shaders.string() };
+  if (!pool.watch())
+  {
+    std::printf("  skipped, the shader directory cannot be watched\n");
+    fs::remove_all(shaders);
+    return;
+  }
+  std::vector<std::unique_ptr<VNgine::ShaderProgram>> programs;
+  for (std::size_t i = 0; i < program_count; ++i)
+  {
+    std::string const name = "material_" + std::to_string(i);
+    programs.push_back(std::make_unique<VNgine::ShaderProgram>(pool, std::string_view{ name }, std::string_view{ name }));
+  }
+
+  // What every frame pays while nothing is being edited
+  constexpr std::size_t frames = 100000;
+  test::measure("idle frame: pool and program updates", frames, [&]
+  {
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      pool.update();
+      for (auto const& program : programs)
+      {
+        program->update();
+      }
+    }
+  });
+
+  // One saved edit: recompile the file and relink the one program that uses it
+  std::ofstream{ shaders / "material_0.fs" } << fragmentSource(0, 4);
+  auto const start = std::chrono::steady_clock::now();
+  std::size_t const reloaded = pool.update();
+  std::size_t relinked = 0;
+  for (auto const& program : programs)
+  {
+    relinked += program->update();
+  }
+  std::printf("  %-48s %10.3f ms   %zu shader, %zu program\n", "one edit: recompile and relink",
+    secondsSince(start) * 1e3, reloaded, relinked);
+  fs::remove_all(shaders);
+}
@@ -0,0 +1,175 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+
+#include <VNgine/shader.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+void writeFlatShaders(fs::path const& directory)
+{
+  fs::create_directories(directory);
+  std::ofstream{ directory / "flat.vs" } <<
+    "#version 330 core\nlayout (location = 0) in vec3 aPos;\nvoid main() { gl_Position = vec4(aPos, 1.0); }\n";
+  std::ofstream{ directory / "flat.fs" } <<
+    "#version 330 core\nout vec4 FragColor;\nvoid main() { FragColor = vec4(0.5); }\n";
+}
+
+// Builds the program through a fresh pool and cache, as a new launch would
+bool linkThroughCache(fs::path const& shaders, fs::path const& cache_directory, VNgine::ProgramCache::Stats& stats)
+{
+  VNgine::ProgramCache cache{ cache_directory.string() };
+  VNgine::ShaderPool const pool{ shaders.string(), &cache };
+  VNgine::ShaderProgram const program{ pool, "flat", "flat" };
+  bool const linked = program.isLinked();
+  stats = cache.stats();
+  return linked;
+}
+
+}
+
+TEST_CASE(shader_pool_compiles_in_the_background_and_reports_readiness)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+
+  fs::path const directory = fs::temp_directory_path() / "vngine_shader_pool_test";
+  fs::remove_all(directory);
+  writeFlatShaders(directory);
+  std::ofstream{ directory / "notes.txt" } << "not a shader";
+
+  {
+    VNgine::ShaderPool const pool{ directory.string() };
+    CHECK(pool.find("flat", VNgine::Shader::Type::VERTEX).has_value());
+    CHECK(pool.find("flat", VNgine::Shader::Type::FRAGMENT).has_value());
+    CHECK(!pool.find("notes", VNgine::Shader::Type::VERTEX).has_value());
+
+    VNgine::ShaderProgram const program{ pool, "flat", "flat" };
+    while (!program.isReady())
+    {
+    }
+    CHECK(pool.isReady());
+    CHECK(program.isLinked());
+  }
+  fs::remove_all(directory);
+}
+
+TEST_CASE(shader_pool_hot_reload_relinks_changed_programs)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+
+  fs::path const directory = fs::temp_directory_path() / "vngine_shader_reload_test";
+  fs::remove_all(directory);
+  writeFlatShaders(directory);
+
+  {
+    VNgine::ShaderPool pool{ directory.string() };
+    VNgine::ShaderProgram program{ pool, "flat", "flat" };
+    CHECK(program.isLinked());
+    if (!pool.watch())
+    {
+      fs::remove_all(directory);
+      return;
+    }
+    CHECK(pool.update() == 0);
+    CHECK(!program.update());
+
+    GLint old_id;
+    program.use();
+    glGetIntegerv(GL_CURRENT_PROGRAM, &old_id);
+
+    std::ofstream{ directory / "flat.fs" } <<
+      "#version 330 core\nout vec4 FragColor;\nvoid main() { FragColor = vec4(1.0); }\n";
+    // The vertex shader is saved unchanged, which must not count as a reload
+    std::ofstream{ directory / "flat.vs" } <<
+      "#version 330 core\nlayout (location = 0) in vec3 aPos;\nvoid main() { gl_Position = vec4(aPos, 1.0); }\n";
+    CHECK(pool.update() == 1);
+    CHECK(pool.get(*pool.find("flat", VNgine::Shader::Type::FRAGMENT)).getVersion() == 1);
+    CHECK(pool.get(*pool.find("flat", VNgine::Shader::Type::VERTEX)).getVersion() == 0);
+    CHECK(program.update());
+    CHECK(!program.update());
+
+    GLint new_id;
+    program.use();
+    glGetIntegerv(GL_CURRENT_PROGRAM, &new_id);
+    CHECK(new_id != old_id);
+
+    // A broken edit is reported and the last good shader stays in use
+    std::ofstream{ directory / "flat.fs" } << "#version 330 core\nvoid main() { this does not compile }\n";
+    CHECK(pool.update() == 0);
+    CHECK(!program.update());
+    CHECK(program.isLinked());
+    GLint kept_id;
+    program.use();
+    glGetIntegerv(GL_CURRENT_PROGRAM, &kept_id);
+    CHECK(kept_id == new_id);
+  }
+  fs::remove_all(directory);
+}
+
+TEST_CASE(program_cache_serves_binaries_and_recovers_from_corruption)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+
+  fs::path const root = fs::temp_directory_path() / "vngine_program_cache_test";
+  fs::path const cache_directory = root / "cache";
+  fs::remove_all(root);
+  if (!VNgine::ProgramCache{ cache_directory.string() }.isEnabled())
+  {
+    fs::remove_all(root);
+    return;
+  }
+  writeFlatShaders(root / "shaders");
+
+  VNgine::ProgramCache::Stats stats{};
+  CHECK(linkThroughCache(root / "shaders", cache_directory, stats));
+  CHECK(stats.misses == 1 && stats.hits == 0 && stats.stores == 1 && stats.bytes_written > 0);
+
+  CHECK(linkThroughCache(root / "shaders", cache_directory, stats));
+  CHECK(stats.hits == 1 && stats.misses == 0 && stats.bytes_read > 0);
+
+  // Flip a byte in the middle of the stored binary; the checksum catches it
+  for (auto const& entry : fs::directory_iterator{ cache_directory })
+  {
+    std::fstream file{ entry.path(), std::ios::binary | std::ios::in | std::ios::out };
+    file.seekg(static_cast<std::streamoff>(fs::file_size(entry.path()) / 2));
+    char const byte = static_cast<char>(file.peek() ^ 0x5A);
+    file.seekp(static_cast<std::streamoff>(fs::file_size(entry.path()) / 2));
+    file.put(byte);
+  }
+  CHECK(linkThroughCache(root / "shaders", cache_directory, stats));
+  CHECK(stats.rejected == 1 && stats.hits == 0 && stats.stores == 1);
+
+  CHECK(linkThroughCache(root / "shaders", cache_directory, stats));
+  CHECK(stats.hits == 1);
+
+  // A huge length field is rejected before anything is allocated for it
+  for (auto const& entry : fs::directory_iterator{ cache_directory })
+  {
+    std::fstream file{ entry.path(), std::ios::binary | std::ios::in | std::ios::out };
+    std::uint32_t const length = 0xFFFFFFF0;
+    // After magic, version, key, checksum and format
+    file.seekp(28);
+    file.write(reinterpret_cast<char const*>(&length), sizeof(length));
+  }
+  CHECK(linkThroughCache(root / "shaders", cache_directory, stats));
+  CHECK(stats.rejected == 1 && stats.hits == 0 && stats.stores == 1);
+  fs::remove_all(root);
+}
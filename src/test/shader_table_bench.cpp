@@ -0,0 +1,94 @@
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <VNgine/shader_table.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+constexpr std::size_t shader_count = 10'000;
+constexpr int vertex = 1;
+constexpr int fragment = 2;
+
+struct Entry
+{
+  std::string name;
+  int type;
+};
+
+// The previous ShaderPool::getVS/getFS: a scan comparing types and then names
+std::size_t linearFind(std::vector<Entry> const& entries, std::string_view name, int type)
+{
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    if (entries[i].type == type && entries[i].name == name)
+    {
+      return i;
+    }
+  }
+  return entries.size();
+}
+
+}
+
+BENCHMARK(shader_pool_lookup)
+{
+  // Half vertex and half fragment shaders, paired by name as they are on disk
+  std::vector<Entry> entries;
+  VNgine::ShaderTable table;
+  table.reserve(shader_count);
+  for (std::size_t i = 0; i < shader_count; ++i)
+  {
+    entries.push_back({ "content/shaders/material_" + std::to_string(i / 2), (i % 2) ? fragment : vertex });
+    table.insert(std::string_view{ entries.back().name }, entries.back().type, { static_cast<std::uint32_t>(i) });
+  }
+
+  // Build one program per vertex/fragment pair, resolving both names each time
+  std::size_t const programs = shader_count / 2;
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i < programs; ++i)
+  {
+    names.push_back(entries[i * 2].name);
+  }
+
+  std::size_t volatile sink = 0;
+  test::measure("linear scan per program", programs, [&]
+  {
+    std::size_t found = 0;
+    for (std::string const& name : names)
+    {
+      found += linearFind(entries, name, vertex) + linearFind(entries, name, fragment);
+    }
+    sink = found;
+  });
+
+  test::measure("hashed table per program", programs, [&]
+  {
+    std::size_t found = 0;
+    for (std::string const& name : names)
+    {
+      found += table.find(std::string_view{ name }, vertex)->index + table.find(std::string_view{ name }, fragment)->index;
+    }
+    sink = found;
+  });
+
+  // Names resolved once up front, as systems holding handles would do
+  std::vector<VNgine::ShaderHandle> handles;
+  for (std::string const& name : names)
+  {
+    handles.push_back(*table.find(std::string_view{ name }, vertex));
+    handles.push_back(*table.find(std::string_view{ name }, fragment));
+  }
+  test::measure("pre-resolved handles per program", programs, [&]
+  {
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < handles.size(); i += 2)
+    {
+      found += entries[handles[i].index].type + entries[handles[i + 1].index].type;
+    }
+    sink = found;
+  });
+}
@@ -0,0 +1,57 @@
+#include <string>
+
+#include <VNgine/shader_table.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+constexpr int vertex = 1;
+constexpr int fragment = 2;
+
+constexpr VNgine::ShaderName basic_name{ "basic" };
+static_assert(basic_name.hash() == fnv1a_hash("basic"));
+static_assert(fnv1a_hash("") == 0xCBF29CE484222325);
+static_assert(fnv1a_hash("a") == 0xAF63DC4C8601EC8C);
+
+}
+
+TEST_CASE(shader_table_keys_on_name_and_type)
+{
+  VNgine::ShaderTable table;
+  CHECK(!table.find("basic", vertex));
+
+  CHECK(table.insert("basic", vertex, { 0 }));
+  CHECK(table.insert("basic", fragment, { 1 }));
+  CHECK(!table.insert("basic", vertex, { 2 }));
+  CHECK(table.size() == 2);
+
+  std::optional<VNgine::ShaderHandle> const vs = table.find(basic_name, vertex);
+  std::optional<VNgine::ShaderHandle> const fs = table.find(basic_name, fragment);
+  CHECK(vs && vs->index == 0);
+  CHECK(fs && fs->index == 1);
+  CHECK(!table.find("basic", 3));
+  CHECK(!table.find("basics", vertex));
+}
+
+TEST_CASE(shader_table_finds_every_entry_after_growing)
+{
+  constexpr std::uint32_t count = 5000;
+  VNgine::ShaderTable table;
+  for (std::uint32_t i = 0; i < count; ++i)
+  {
+    std::string const name = "shader_" + std::to_string(i);
+    CHECK(table.insert(std::string_view{ name }, (i % 2) ? vertex : fragment, { i }));
+  }
+  CHECK(table.size() == count);
+
+  bool all_found = true;
+  for (std::uint32_t i = 0; i < count; ++i)
+  {
+    std::string const name = "shader_" + std::to_string(i);
+    std::optional<VNgine::ShaderHandle> const handle = table.find(std::string_view{ name }, (i % 2) ? vertex : fragment);
+    all_found = all_found && handle && handle->index == i;
+    all_found = all_found && !table.find(std::string_view{ name }, (i % 2) ? fragment : vertex);
+  }
+  CHECK(all_found);
+}
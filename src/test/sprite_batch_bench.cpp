@@ -0,0 +1,193 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <VNgine/gl_state.h>
+#include <VNgine/shader.h>
+#include <VNgine/sprite_batch.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr std::size_t quad_count = 100000;
+constexpr int target_size = 512;
+
+struct CameraBlock
+{
+  glm::mat4 view;
+  glm::mat4 projection;
+};
+
+void writeShaders(fs::path const& directory)
+{
+  fs::create_directories(directory);
+  // What main.cpp drew with: one model matrix uniform per object
+  std::ofstream{ directory / "single.vs" } <<
+    "#version 330 core\nlayout (location = 0) in vec3 aPos;\n"
+    "layout (std140) uniform Camera { mat4 view; mat4 projection; };\n"
+    "uniform mat4 model;\nuniform vec4 tint;\nout vec4 color;\n"
+    "void main() { gl_Position = projection * view * model * vec4(aPos, 1.0); color = tint; }\n";
+  std::ofstream{ directory / "single.fs" } <<
+    "#version 330 core\nin vec4 color;\nout vec4 frag_color;\nvoid main() { frag_color = color; }\n";
+  std::ofstream{ directory / "sprite.vs" } <<
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\nlayout (location = 1) in vec2 aUV;\n"
+    "layout (location = 2) in mat4 aTransform;\nlayout (location = 6) in vec4 aColor;\n"
+    "layout (location = 7) in vec4 aUVRect;\n"
+    "layout (std140) uniform Camera { mat4 view; mat4 projection; };\n"
+    "out vec2 uv;\nout vec4 color;\n"
+    "void main()\n{\n"
+    "  gl_Position = projection * view * aTransform * vec4(aPos, 1.0);\n"
+    "  uv = aUVRect.xy + aUV * aUVRect.zw;\n  color = aColor;\n}\n";
+  std::ofstream{ directory / "sprite.fs" } <<
+    "#version 330 core\nin vec2 uv;\nin vec4 color;\nout vec4 frag_color;\n"
+    "uniform sampler2D sprite_texture;\n"
+    "void main() { frag_color = texture(sprite_texture, uv) * color; }\n";
+}
+
+struct Quad
+{
+  glm::mat4 transform;
+  glm::vec4 color;
+};
+
+std::vector<Quad> scatterQuads()
+{
+  std::vector<Quad> quads;
+  quads.reserve(quad_count);
+  std::uint32_t seed = 12345;
+  auto const next = [&seed] { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / float(1 << 24); };
+  for (std::size_t i = 0; i < quad_count; ++i)
+  {
+    glm::mat4 transform = glm::translate(glm::mat4{ 1.0f }, glm::vec3{ next() * target_size, next() * target_size, 0.0f });
+    transform = glm::scale(transform, glm::vec3{ 3.0f, 3.0f, 1.0f });
+    quads.push_back({ transform, glm::vec4{ next(), next(), next(), 1.0f } });
+  }
+  return quads;
+}
+
+// `submit_seconds` is the CPU time spent issuing the frames, before waiting on the GPU
+void report(char const* label, double seconds, double submit_seconds, std::size_t frames, std::size_t draw_calls)
+{
+  std::printf("  %-40s %8.2f fps %10.2f ms submit/frame %8zu draw calls/frame\n", label,
+    static_cast<double>(frames) / seconds, submit_seconds * 1e3 / static_cast<double>(frames), draw_calls);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+BENCHMARK(sprite_batch_100k_quads)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    test::GLContext::skip("sprite batch 100k quads");
+    return;
+  }
+
+  fs::path const directory = fs::temp_directory_path() / "vngine_sprite_batch_bench";
+  fs::remove_all(directory);
+  writeShaders(directory);
+
+  GLuint framebuffer, color;
+  glGenFramebuffers(1, &framebuffer);
+  glGenRenderbuffers(1, &color);
+  glBindRenderbuffer(GL_RENDERBUFFER, color);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, target_size, target_size);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+  glViewport(0, 0, target_size, target_size);
+
+  {
+    VNgine::ShaderPool const pool{ directory.string() };
+    VNgine::ShaderProgram single{ pool, "single", "single" };
+    VNgine::ShaderProgram sprite{ pool, "sprite", "sprite" };
+    VNgine::UniformBuffer<CameraBlock> camera{ 0 };
+    camera.update({ glm::mat4{ 1.0f }, glm::ortho(0.0f, float(target_size), 0.0f, float(target_size), -1.0f, 1.0f) });
+    single.bindUniformBlock("Camera", camera);
+    sprite.bindUniformBlock("Camera", camera);
+    std::vector<Quad> const quads = scatterQuads();
+    std::printf("  %zu quads into %dx%d, %s\n", quad_count, target_size, target_size,
+      reinterpret_cast<char const*>(glGetString(GL_RENDERER)));
+
+    {
+      float const vertices[] = { 0.5f, 0.5f, 0.0f, 0.5f, -0.5f, 0.0f, -0.5f, -0.5f, 0.0f, -0.5f, 0.5f, 0.0f };
+      unsigned int const indices[] = { 0, 1, 3, 1, 2, 3 };
+      GLuint vao, vbo, ebo;
+      glGenVertexArrays(1, &vao);
+      glGenBuffers(1, &vbo);
+      glGenBuffers(1, &ebo);
+      glBindVertexArray(vao);
+      glBindBuffer(GL_ARRAY_BUFFER, vbo);
+      glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), static_cast<void*>(0));
+      glEnableVertexAttribArray(0);
+
+      single.use();
+      GLint const model = single.getUniformLocation("model");
+      GLint const tint = single.getUniformLocation("tint");
+      constexpr std::size_t frames = 5;
+      auto const start = std::chrono::steady_clock::now();
+      double submit = 0.0;
+      for (std::size_t frame = 0; frame < frames; ++frame)
+      {
+        glClear(GL_COLOR_BUFFER_BIT);
+        auto const frame_start = std::chrono::steady_clock::now();
+        for (Quad const& quad : quads)
+        {
+          single.setUniform(model, quad.transform);
+          single.setUniform(tint, quad.color);
+          glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        }
+        submit += secondsSince(frame_start);
+        glFinish();
+      }
+      report("previous: uniform and draw per quad", secondsSince(start), submit, frames, quad_count);
+      glDeleteBuffers(1, &ebo);
+      glDeleteBuffers(1, &vbo);
+      glDeleteVertexArrays(1, &vao);
+      // The baseline bound its objects directly
+      VNgine::GLState::current().invalidate();
+    }
+
+    {
+      VNgine::SpriteBatch batch;
+      constexpr std::size_t frames = 20;
+      auto const start = std::chrono::steady_clock::now();
+      double submit = 0.0;
+      for (std::size_t frame = 0; frame < frames; ++frame)
+      {
+        glClear(GL_COLOR_BUFFER_BIT);
+        auto const frame_start = std::chrono::steady_clock::now();
+        batch.begin();
+        for (Quad const& quad : quads)
+        {
+          batch.draw(sprite, 0, quad.transform, quad.color);
+        }
+        batch.end();
+        submit += secondsSince(frame_start);
+        glFinish();
+      }
+      report("sprite batch: instanced", secondsSince(start), submit, frames, batch.stats().draw_calls);
+    }
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glDeleteRenderbuffers(1, &color);
+  glDeleteFramebuffers(1, &framebuffer);
+  fs::remove_all(directory);
+}
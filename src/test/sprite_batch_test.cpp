@@ -0,0 +1,145 @@
+#include <filesystem>
+#include <fstream>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <VNgine/gl_state.h>
+#include <VNgine/shader.h>
+#include <VNgine/sprite_batch.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+struct CameraBlock
+{
+  glm::mat4 view;
+  glm::mat4 projection;
+};
+
+constexpr int target_size = 16;
+
+void writeSpriteShaders(fs::path const& directory)
+{
+  fs::create_directories(directory);
+  std::ofstream{ directory / "sprite.vs" } <<
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\nlayout (location = 1) in vec2 aUV;\n"
+    "layout (location = 2) in mat4 aTransform;\nlayout (location = 6) in vec4 aColor;\n"
+    "layout (location = 7) in vec4 aUVRect;\n"
+    "layout (std140) uniform Camera { mat4 view; mat4 projection; };\n"
+    "out vec2 uv;\nout vec4 color;\n"
+    "void main()\n{\n"
+    "  gl_Position = projection * view * aTransform * vec4(aPos, 1.0);\n"
+    "  uv = aUVRect.xy + aUV * aUVRect.zw;\n  color = aColor;\n}\n";
+  std::ofstream{ directory / "sprite.fs" } <<
+    "#version 330 core\nin vec2 uv;\nin vec4 color;\nout vec4 frag_color;\n"
+    "uniform sampler2D sprite_texture;\n"
+    "void main() { frag_color = texture(sprite_texture, uv) * color; }\n";
+}
+
+GLuint solidTexture(unsigned char r, unsigned char g, unsigned char b)
+{
+  unsigned char const texel[4] = { r, g, b, 255 };
+  GLuint texture;
+  glGenTextures(1, &texture);
+  VNgine::GLState::current().bindTexture(0, GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  return texture;
+}
+
+// One pixel-sized sprite centred on pixel (x, y)
+glm::mat4 pixelAt(int x, int y, float size = 1.0f)
+{
+  glm::mat4 transform = glm::translate(glm::mat4{ 1.0f }, glm::vec3{ x + 0.5f, y + 0.5f, 0.0f });
+  return glm::scale(transform, glm::vec3{ size, size, 1.0f });
+}
+
+void renderAndCheck(VNgine::ShaderProgram const& program, GLuint red, GLuint blue)
+{
+  glClear(GL_COLOR_BUFFER_BIT);
+  VNgine::SpriteBatch batch{ 2 };
+  batch.begin();
+  // Interleaved textures collapse into one run per texture
+  batch.draw(program, red, pixelAt(1, 1));
+  batch.draw(program, blue, pixelAt(2, 1));
+  batch.draw(program, red, pixelAt(3, 1));
+  batch.draw(program, blue, pixelAt(4, 1));
+  // Submitted first but on a higher layer, so it still covers the green one
+  batch.draw(program, red, pixelAt(8, 8, 4.0f), glm::vec4{ 1.0f }, { 0.0f, 0.0f, 1.0f, 1.0f }, 1);
+  batch.draw(program, 0, pixelAt(8, 8, 4.0f), glm::vec4{ 0.0f, 1.0f, 0.0f, 1.0f });
+  // Untextured, tinted, and beyond the initial capacity of two
+  batch.draw(program, 0, pixelAt(12, 1), glm::vec4{ 1.0f, 1.0f, 0.0f, 1.0f });
+  batch.end();
+  CHECK(batch.stats().sprites == 7);
+  CHECK(batch.stats().draw_calls == 4);
+
+  unsigned char pixels[target_size][target_size][4];
+  glReadPixels(0, 0, target_size, target_size, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+  auto const is = [&pixels](int x, int y, unsigned char r, unsigned char g, unsigned char b)
+  {
+    return pixels[y][x][0] == r && pixels[y][x][1] == g && pixels[y][x][2] == b;
+  };
+  CHECK(is(1, 1, 255, 0, 0) && is(2, 1, 0, 0, 255) && is(3, 1, 255, 0, 0) && is(4, 1, 0, 0, 255));
+  CHECK(is(8, 8, 255, 0, 0));
+  CHECK(is(12, 1, 255, 255, 0));
+  CHECK(is(0, 0, 0, 0, 0));
+
+  batch.begin();
+  batch.end();
+  CHECK(batch.stats().sprites == 0 && batch.stats().draw_calls == 0);
+}
+
+}
+
+TEST_CASE(sprite_batch_sorts_into_instanced_runs_and_keeps_layers)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+
+  fs::path const directory = fs::temp_directory_path() / "vngine_sprite_batch_test";
+  fs::remove_all(directory);
+  writeSpriteShaders(directory);
+
+  GLuint framebuffer, color;
+  glGenFramebuffers(1, &framebuffer);
+  glGenRenderbuffers(1, &color);
+  glBindRenderbuffer(GL_RENDERBUFFER, color);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, target_size, target_size);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+  glViewport(0, 0, target_size, target_size);
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT);
+
+  {
+    VNgine::ShaderPool const pool{ directory.string() };
+    VNgine::ShaderProgram program{ pool, "sprite", "sprite" };
+    VNgine::UniformBuffer<CameraBlock> camera{ 0 };
+    camera.update({ glm::mat4{ 1.0f }, glm::ortho(0.0f, float(target_size), 0.0f, float(target_size), -1.0f, 1.0f) });
+    program.bindUniformBlock("Camera", camera);
+    CHECK(program.isLinked());
+
+    GLuint const red = solidTexture(255, 0, 0);
+    GLuint const blue = solidTexture(0, 0, 255);
+    renderAndCheck(program, red, blue);
+    // Again through the path for drivers without ARB_base_instance
+    GLboolean const base_instance = GLEW_ARB_base_instance;
+    GLEW_ARB_base_instance = GL_FALSE;
+    renderAndCheck(program, red, blue);
+    GLEW_ARB_base_instance = base_instance;
+    VNgine::GLState::current().deleteTexture(red);
+    VNgine::GLState::current().deleteTexture(blue);
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glDeleteRenderbuffers(1, &color);
+  glDeleteFramebuffers(1, &framebuffer);
+  fs::remove_all(directory);
+}
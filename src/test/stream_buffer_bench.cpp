@@ -0,0 +1,126 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <VNgine/shader.h>
+#include <VNgine/stream_buffer.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr std::size_t frame_bytes = 4 << 20;
+constexpr std::size_t frames = 200;
+// The draw reads one vec4 out of every `stride` bytes, so the GPU touches each frame's data
+constexpr GLsizei stride = 256;
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void bindPoints(GLuint buffer, std::size_t offset)
+{
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void const*>(offset));
+}
+
+void drawPoints()
+{
+  glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(frame_bytes / stride));
+}
+
+void report(char const* label, double seconds, std::size_t stalls, std::uint64_t stall_ns)
+{
+  std::printf("  %-40s %10.1f MB/s %8zu stalls %10.3f ms stalled\n", label,
+    static_cast<double>(frame_bytes * frames) / seconds / 1e6, stalls, static_cast<double>(stall_ns) / 1e6);
+}
+
+void streamWith(char const* label, VNgine::StreamBuffer::Strategy strategy, std::size_t regions,
+                std::vector<float> const& source)
+{
+  VNgine::StreamBuffer stream{ GL_ARRAY_BUFFER, frame_bytes, regions, strategy };
+  auto const start = std::chrono::steady_clock::now();
+  for (std::size_t frame = 0; frame < frames; ++frame)
+  {
+    VNgine::StreamBuffer::Allocation const allocation = stream.map(frame_bytes, stride);
+    std::memcpy(allocation.data, source.data(), frame_bytes);
+    stream.unmap();
+    bindPoints(stream.getID(), allocation.offset);
+    drawPoints();
+    stream.endFrame();
+  }
+  glFinish();
+  report(label, secondsSince(start), stream.stats().stalls, stream.stats().stall_ns);
+}
+
+}
+
+BENCHMARK(stream_buffer_upload)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    test::GLContext::skip("stream buffer upload");
+    return;
+  }
+
+  fs::path const directory = fs::temp_directory_path() / "vngine_stream_buffer_bench";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  std::ofstream{ directory / "points.vs" } <<
+    "#version 330 core\nlayout (location = 0) in vec4 aPos;\nvoid main() { gl_Position = aPos; }\n";
+  std::ofstream{ directory / "points.fs" } <<
+    "#version 330 core\nout vec4 frag_color;\nvoid main() { frag_color = vec4(1.0); }\n";
+
+  {
+    VNgine::ShaderPool const pool{ directory.string() };
+    VNgine::ShaderProgram const program{ pool, "points", "points" };
+    program.use();
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glEnableVertexAttribArray(0);
+    glEnable(GL_RASTERIZER_DISCARD);
+    std::vector<float> const source(frame_bytes / sizeof(float), 0.5f);
+    std::printf("  %zu MiB per frame, %zu frames\n", frame_bytes >> 20, frames);
+
+    {
+      GLuint buffer;
+      glGenBuffers(1, &buffer);
+      glBindBuffer(GL_ARRAY_BUFFER, buffer);
+      glBufferData(GL_ARRAY_BUFFER, frame_bytes, nullptr, GL_DYNAMIC_DRAW);
+      auto const start = std::chrono::steady_clock::now();
+      for (std::size_t frame = 0; frame < frames; ++frame)
+      {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, frame_bytes, source.data());
+        bindPoints(buffer, 0);
+        drawPoints();
+      }
+      glFinish();
+      report("glBufferSubData into one buffer", secondsSince(start), 0, 0);
+      glDeleteBuffers(1, &buffer);
+    }
+
+    streamWith("orphan and map unsynchronized", VNgine::StreamBuffer::Strategy::ORPHAN, 1, source);
+    if (GLEW_ARB_buffer_storage)
+    {
+      streamWith("persistent, 1 region", VNgine::StreamBuffer::Strategy::PERSISTENT, 1, source);
+      streamWith("persistent, 3 regions", VNgine::StreamBuffer::Strategy::PERSISTENT, 3, source);
+    }
+    else
+    {
+      std::printf("  persistent mapping skipped, ARB_buffer_storage unavailable\n");
+    }
+
+    glDisable(GL_RASTERIZER_DISCARD);
+    glDeleteVertexArrays(1, &vao);
+  }
+  fs::remove_all(directory);
+}
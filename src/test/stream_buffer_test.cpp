@@ -0,0 +1,61 @@
+#include <cstring>
+
+#include <VNgine/stream_buffer.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+void checkStreaming(VNgine::StreamBuffer::Strategy strategy)
+{
+  constexpr std::size_t region_size = 1024;
+  VNgine::StreamBuffer stream{ GL_ARRAY_BUFFER, region_size, 3, strategy };
+  CHECK(stream.getStrategy() == strategy);
+
+  std::size_t previous_offset = region_size * 3;
+  for (int frame = 0; frame < 5; ++frame)
+  {
+    // Non power-of-two alignment, as for a vertex stride
+    VNgine::StreamBuffer::Allocation const first = stream.map(100, 1);
+    CHECK(first.data != nullptr);
+    std::memset(first.data, frame, 100);
+    stream.unmap();
+    VNgine::StreamBuffer::Allocation const second = stream.map(96, 96);
+    CHECK(second.data != nullptr && second.offset % 96 == 0 && second.offset >= first.offset + 100);
+    std::memset(second.data, 0x40 + frame, 96);
+    stream.unmap();
+    CHECK(stream.map(region_size, 1).data == nullptr);
+
+    unsigned char readback[96];
+    glBindBuffer(GL_ARRAY_BUFFER, stream.getID());
+    glGetBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(second.offset), sizeof(readback), readback);
+    CHECK(readback[0] == 0x40 + frame && readback[95] == 0x40 + frame);
+    if (strategy == VNgine::StreamBuffer::Strategy::PERSISTENT)
+    {
+      // Consecutive frames write to different regions
+      CHECK(first.offset / region_size != previous_offset / region_size);
+    }
+    previous_offset = first.offset;
+    stream.endFrame();
+  }
+
+  VNgine::StreamBuffer::Stats const& stats = stream.stats();
+  CHECK(stats.frames == 5 && stats.overflows == 5 && stats.bytes_written == 5 * 196);
+}
+
+}
+
+TEST_CASE(stream_buffer_hands_out_aligned_ranges_per_frame)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+  checkStreaming(VNgine::StreamBuffer::Strategy::ORPHAN);
+  if (GLEW_ARB_buffer_storage)
+  {
+    checkStreaming(VNgine::StreamBuffer::Strategy::PERSISTENT);
+  }
+}
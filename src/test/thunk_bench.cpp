@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN64
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <GLFW/glfw3.h>
+
+#include <VNgine/thunk.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+constexpr std::size_t total_thunks = 1'000'000;
+// Thunks kept alive at once by each thread before they are all destroyed again
+constexpr std::size_t round_size = 256;
+
+struct Receiver
+{
+  void keyCallback(GLFWwindow*, int, int, int, int) {}
+};
+
+using KeyThunk = VNgine::JitThunk<Receiver, GLFWkeyfun>;
+
+/*
+ * Replica of the previous per-thunk path for comparison: every allocation and free goes
+ * through one global mutex, and every thunk pays for its own round trip into the OS
+ * allocator (HeapAlloc on Win64, a protection flip each way on POSIX).
+ */
+class LegacyHeap
+{
+public:
+#ifdef _WIN64
+  LegacyHeap() : heap_{ HeapCreate(HEAP_CREATE_ENABLE_EXECUTE, 0, 0) } {}
+  ~LegacyHeap() { HeapDestroy(heap_); }
+
+  void* emplace(void const* code, std::size_t size)
+  {
+    std::scoped_lock lock{ mutex_ };
+    void* const mem = HeapAlloc(heap_, 0, size);
+    std::memcpy(mem, code, size);
+    FlushInstructionCache(GetCurrentProcess(), mem, size);
+    return mem;
+  }
+
+  void dealloc(void* mem)
+  {
+    std::scoped_lock lock{ mutex_ };
+    HeapFree(heap_, 0, mem);
+  }
+
+private:
+  HANDLE heap_;
+#else
+  LegacyHeap() : page_size_{ static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) } {}
+  ~LegacyHeap()
+  {
+    for (Page const& page : pages_)
+    {
+      munmap(page.base, page_size_);
+    }
+  }
+
+  void* emplace(void const* code, std::size_t size)
+  {
+    std::scoped_lock lock{ mutex_ };
+    std::size_t const block_size = (size + 16 + 15) / 16 * 16;
+    std::uint8_t* block = nullptr;
+    auto const reuse = std::find_if(free_.begin(), free_.end(),
+      [block_size](auto const& free) { return free.second == block_size; });
+    if (reuse != free_.end())
+    {
+      block = reuse->first;
+      *reuse = free_.back();
+      free_.pop_back();
+    }
+    else
+    {
+      if (pages_.empty() || page_size_ - pages_.back().used < block_size)
+      {
+        void* const base = mmap(nullptr, page_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        pages_.push_back({ static_cast<std::uint8_t*>(base), 0 });
+      }
+      block = pages_.back().base + pages_.back().used;
+      pages_.back().used += block_size;
+    }
+
+    std::uint8_t* const page = block - reinterpret_cast<std::uintptr_t>(block) % page_size_;
+    mprotect(page, page_size_, PROT_READ | PROT_WRITE);
+    std::memcpy(block, &block_size, sizeof(block_size));
+    std::memcpy(block + 16, code, size);
+    mprotect(page, page_size_, PROT_READ | PROT_EXEC);
+    return block + 16;
+  }
+
+  void dealloc(void* mem)
+  {
+    std::uint8_t* const block = static_cast<std::uint8_t*>(mem) - 16;
+    std::size_t block_size;
+    std::memcpy(&block_size, block, sizeof(block_size));
+    std::scoped_lock lock{ mutex_ };
+    free_.emplace_back(block, block_size);
+  }
+
+private:
+  struct Page
+  {
+    std::uint8_t* base;
+    std::size_t used;
+  };
+  std::size_t page_size_;
+  std::vector<Page> pages_;
+  std::vector<std::pair<std::uint8_t*, std::size_t>> free_;
+#endif
+  std::mutex mutex_;
+};
+
+template <typename Work>
+void runThreads(std::size_t thread_count, Work const& work)
+{
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i)
+  {
+    threads.emplace_back([&work, thread_count] { work(total_thunks / thread_count); });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+}
+
+void legacyPath(LegacyHeap& heap, std::size_t count)
+{
+  // Roughly the size of a key callback thunk; code generation is not included here
+  std::uint8_t code[48];
+  std::memset(code, 0xCC, sizeof(code));
+
+  void* mems[round_size];
+  for (std::size_t done = 0; done < count; done += round_size)
+  {
+    for (void*& mem : mems)
+    {
+      mem = heap.emplace(code, sizeof(code));
+    }
+    for (void* mem : mems)
+    {
+      heap.dealloc(mem);
+    }
+  }
+}
+
+void slabPath(std::size_t count, bool batched)
+{
+  Receiver receiver;
+  std::optional<KeyThunk> thunks[round_size];
+  for (std::size_t done = 0; done < count; done += round_size)
+  {
+    {
+      std::optional<VNgine::ThunkHeap::Batch> batch;
+      if (batched)
+      {
+        batch.emplace();
+      }
+      for (std::optional<KeyThunk>& thunk : thunks)
+      {
+        thunk.emplace(&receiver, &Receiver::keyCallback);
+      }
+    }
+    for (std::optional<KeyThunk>& thunk : thunks)
+    {
+      thunk.reset();
+    }
+  }
+}
+
+}
+
+BENCHMARK(thunk_heap_create_destroy)
+{
+  std::vector<std::size_t> thread_counts{ 1 };
+  if (std::thread::hardware_concurrency() > 1)
+  {
+    thread_counts.push_back(std::thread::hardware_concurrency());
+  }
+  for (std::size_t const thread_count : thread_counts)
+  {
+    std::printf("  %zu thunks, %zu thread(s)\n", total_thunks, thread_count);
+
+    LegacyHeap legacy;
+    test::measure("previous per-thunk heap", total_thunks, [&]
+    {
+      runThreads(thread_count, [&legacy](std::size_t count) { legacyPath(legacy, count); });
+    });
+    test::measure("slab heap", total_thunks, [&]
+    {
+      runThreads(thread_count, [](std::size_t count) { slabPath(count, false); });
+    });
+    test::measure("slab heap, batched cache flushes", total_thunks, [&]
+    {
+      runThreads(thread_count, [](std::size_t count) { slabPath(count, true); });
+    });
+  }
+
+  VNgine::ThunkHeap::Stats const stats = VNgine::ThunkHeap::stats();
+  std::printf("  live thunks: %zu, slabs: %zu, committed: %zu bytes, fragmentation: %.1f%%\n",
+    stats.live_thunks, stats.slabs, stats.committed_bytes, stats.fragmentation * 100.0);
+}
+
+BENCHMARK(thunk_bytecode_creation)
+{
+  using Codegen = VNgine::detail::NativeCodegen<GLFWwindow*, int, int, int, int>;
+  using Bytecode = VNgine::detail::BytecodeTemplate<Codegen>;
+  constexpr std::size_t iterations = 1'000'000;
+
+  Receiver receiver;
+  void* const instance = &receiver;
+  void* const function = &receiver;
+  std::uint8_t out[Codegen::MaxSize];
+  std::uint8_t volatile sink = 0;
+
+  // Before: the image is assembled instruction by instruction every time a thunk is made.
+  // Calling through a volatile function pointer keeps the compiler from folding it away.
+  auto (* volatile assemble)() = &Codegen::assemble<Codegen::MaxSize>;
+  test::measure("assemble at runtime, then patch", iterations, [&]
+  {
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+      auto const code = assemble();
+      std::memcpy(out, code.bytes.data(), code.size);
+      std::memcpy(out + code.this_offset, &instance, sizeof(instance));
+      std::memcpy(out + code.function_offset, &function, sizeof(function));
+      sink = sink + out[i % code.size];
+    }
+  });
+
+  // After: one copy of the compile-time image and two pointer patches
+  test::measure("copy compile-time image, then patch", iterations, [&]
+  {
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+      std::memcpy(out, Bytecode::bytes.data(), Bytecode::size);
+      std::memcpy(out + Bytecode::this_offset, &instance, sizeof(instance));
+      std::memcpy(out + Bytecode::function_offset, &function, sizeof(function));
+      sink = sink + out[i % Bytecode::size];
+    }
+  });
+
+  // End to end, with instruction cache flushes amortized so the copy itself dominates
+  std::optional<KeyThunk> thunks[round_size];
+  test::measure("Thunk construction inside a batch", iterations, [&]
+  {
+    for (std::size_t done = 0; done < iterations; done += round_size)
+    {
+      {
+        VNgine::ThunkHeap::Batch batch;
+        for (std::optional<KeyThunk>& thunk : thunks)
+        {
+          thunk.emplace(&receiver, &Receiver::keyCallback);
+        }
+      }
+      for (std::optional<KeyThunk>& thunk : thunks)
+      {
+        thunk.reset();
+      }
+    }
+  });
+}
+
+namespace
+{
+
+struct Counter
+{
+  long long sum = 0;
+  void keyCallback(GLFWwindow*, int key, int, int, int) { sum += key; }
+};
+
+// The usual alternative to thunks: one free function that finds the receiver through GLFW
+void userPointerKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+  static_cast<Counter*>(glfwGetWindowUserPointer(window))->keyCallback(window, key, scancode, action, mods);
+}
+
+void measureCalls(char const* label, GLFWkeyfun callback, GLFWwindow* window)
+{
+  constexpr std::size_t calls = 10'000'000;
+  // Reading the pointer through a volatile keeps every call an indirect call
+  GLFWkeyfun volatile target = callback;
+  test::measure(label, calls, [&]
+  {
+    for (std::size_t i = 0; i < calls; ++i)
+    {
+      target(window, static_cast<int>(i), 0, GLFW_PRESS, 0);
+    }
+  });
+}
+
+}
+
+BENCHMARK(thunk_call_latency)
+{
+  Counter counter;
+  VNgine::JitThunk<Counter, GLFWkeyfun> const jit{ &counter, &Counter::keyCallback };
+  VNgine::StaticThunk<Counter, GLFWkeyfun> const trampoline{ &counter, &Counter::keyCallback };
+
+  measureCalls("JIT thunk", jit.getCallback(), nullptr);
+  measureCalls("static trampoline pool", trampoline.getCallback(), nullptr);
+
+  // The user pointer lookup needs a real window; display-less hosts skip it
+  GLFWwindow* window = nullptr;
+  if (glfwInit())
+  {
+    // Hints are rejected before glfwInit(), which would leave the window visible
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    window = glfwCreateWindow(1, 1, "", nullptr, nullptr);
+  }
+  if (window)
+  {
+    glfwSetWindowUserPointer(window, &counter);
+    measureCalls("glfwGetWindowUserPointer lookup", userPointerKeyCallback, window);
+    glfwDestroyWindow(window);
+  }
+  else
+  {
+    std::printf("  %-48s skipped, no window could be created\n", "glfwGetWindowUserPointer lookup");
+  }
+  glfwTerminate();
+}
@@ -0,0 +1,320 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <tuple>
+
+#include <GLFW/glfw3.h>
+
+#include <VNgine/thunk.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+GLFWwindow* const fake_window = reinterpret_cast<GLFWwindow*>(std::uintptr_t{ 0x0000123456789ABC });
+
+// Records the arguments its method receives, so a direct call and a thunked call can be compared
+template <typename Callback>
+struct Forwarding;
+
+template <typename Ret, typename... Args>
+struct Forwarding<Ret(*)(Args...)>
+{
+  std::tuple<Args...> seen{};
+  int calls = 0;
+
+  Ret callback(Args... args)
+  {
+    seen = std::tuple<Args...>{ args... };
+    ++calls;
+    return Ret();
+  }
+
+  template <template <typename, typename> class ThunkType>
+  static bool check(Args... args)
+  {
+    Forwarding direct;
+    direct.callback(args...);
+
+    Forwarding thunked;
+    ThunkType<Forwarding, Ret(*)(Args...)> const thunk{ &thunked, &Forwarding::callback };
+    thunk.getCallback()(args...);
+
+    return thunked.calls == 1 && thunked.seen == direct.seen;
+  }
+};
+
+// Checks the callback through both the JIT and the static trampoline backends
+template <typename Callback, typename... Args>
+bool forwards(Args... args)
+{
+  return Forwarding<Callback>::template check<VNgine::JitThunk>(args...)
+      && Forwarding<Callback>::template check<VNgine::StaticThunk>(args...);
+}
+
+}
+
+/*
+ * Compile-time checks that each generator produces exactly the expected instruction sequence.
+ * Both generators are plain constexpr code, so both are checked whatever the host ABI is.
+ */
+namespace
+{
+
+template <typename Codegen, std::size_t N>
+constexpr bool assemblesTo(std::array<std::uint8_t, N> const& expected)
+{
+  using Bytecode = VNgine::detail::BytecodeTemplate<Codegen>;
+  if (Bytecode::size != N)
+  {
+    return false;
+  }
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    if (Bytecode::bytes[i] != expected[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+#define IMM64 0, 0, 0, 0, 0, 0, 0, 0
+
+using SysVKey = VNgine::detail::SysVCodegen<GLFWwindow*, int, int, int, int>;
+static_assert(assemblesTo<SysVKey>(std::array<std::uint8_t, 40>{
+  0x4D, 0x89, 0xC1,                           // mov r9, r8
+  0x49, 0x89, 0xC8,                           // mov r8, rcx
+  0x48, 0x89, 0xD1,                           // mov rcx, rdx
+  0x48, 0x89, 0xF2,                           // mov rdx, rsi
+  0x48, 0x89, 0xFE,                           // mov rsi, rdi
+  0x48, 0xBF, IMM64,                          // mov rdi, this_ptr
+  0x48, 0xB8, IMM64,                          // mov rax, function
+  0xFF, 0xE0,                                 // jmp rax
+  0xCC, 0xCC, 0xCC                            // int3
+}));
+static_assert(VNgine::detail::BytecodeTemplate<SysVKey>::this_offset == 17);
+static_assert(VNgine::detail::BytecodeTemplate<SysVKey>::function_offset == 27);
+
+using SysVSixInts = VNgine::detail::SysVCodegen<int, int, int, int, int, int>;
+static_assert(assemblesTo<SysVSixInts>(std::array<std::uint8_t, 63>{
+  0x48, 0x81, 0xEC, 0x08, 0x00, 0x00, 0x00,   // sub rsp, 8
+  0x4C, 0x89, 0x8C, 0x24, 0, 0, 0, 0,         // mov qword ptr [rsp], r9
+  0x4D, 0x89, 0xC1,                           // mov r9, r8
+  0x49, 0x89, 0xC8,                           // mov r8, rcx
+  0x48, 0x89, 0xD1,                           // mov rcx, rdx
+  0x48, 0x89, 0xF2,                           // mov rdx, rsi
+  0x48, 0x89, 0xFE,                           // mov rsi, rdi
+  0x48, 0xBF, IMM64,                          // mov rdi, this_ptr
+  0x48, 0xB8, IMM64,                          // mov rax, function
+  0xFF, 0xD0,                                 // call rax
+  0x48, 0x81, 0xC4, 0x08, 0x00, 0x00, 0x00,   // add rsp, 8
+  0xC3,                                       // ret
+  0xCC, 0xCC, 0xCC                            // int3
+}));
+
+using Win64Key = VNgine::detail::Win64Codegen<GLFWwindow*, int, int, int, int>;
+static_assert(assemblesTo<Win64Key>(std::array<std::uint8_t, 73>{
+  0x48, 0x81, 0xEC, 0x38, 0x00, 0x00, 0x00,   // sub rsp, 56
+  0x48, 0x8B, 0x84, 0x24, 0x60, 0, 0, 0,      // mov rax, qword ptr [rsp + 96]
+  0x48, 0x89, 0x84, 0x24, 0x28, 0, 0, 0,      // mov qword ptr [rsp + 40], rax
+  0x4C, 0x89, 0x8C, 0x24, 0x20, 0, 0, 0,      // mov qword ptr [rsp + 32], r9
+  0x4D, 0x89, 0xC1,                           // mov r9, r8
+  0x49, 0x89, 0xD0,                           // mov r8, rdx
+  0x48, 0x89, 0xCA,                           // mov rdx, rcx
+  0x48, 0xB9, IMM64,                          // mov rcx, this_ptr
+  0x48, 0xB8, IMM64,                          // mov rax, function
+  0xFF, 0xD0,                                 // call rax
+  0x48, 0x81, 0xC4, 0x38, 0x00, 0x00, 0x00,   // add rsp, 56
+  0xC3,                                       // ret
+  0xCC, 0xCC, 0xCC                            // int3
+}));
+
+using Win64CursorPos = VNgine::detail::Win64Codegen<GLFWwindow*, double, double>;
+static_assert(assemblesTo<Win64CursorPos>(std::array<std::uint8_t, 34>{
+  0x0F, 0x28, 0xDA,                           // movaps xmm3, xmm2
+  0x0F, 0x28, 0xD1,                           // movaps xmm2, xmm1
+  0x48, 0x89, 0xCA,                           // mov rdx, rcx
+  0x48, 0xB9, IMM64,                          // mov rcx, this_ptr
+  0x48, 0xB8, IMM64,                          // mov rax, function
+  0xFF, 0xE0,                                 // jmp rax
+  0xCC, 0xCC, 0xCC                            // int3
+}));
+
+#undef IMM64
+
+}
+
+TEST_CASE(thunk_forwards_glfw_key_callback)
+{
+  CHECK(forwards<GLFWkeyfun>(fake_window, GLFW_KEY_G, 0x22, GLFW_PRESS, GLFW_MOD_SHIFT | GLFW_MOD_ALT));
+  CHECK(forwards<GLFWkeyfun>(fake_window, -1, -2, -3, -4));
+}
+
+TEST_CASE(thunk_forwards_glfw_callback_arities)
+{
+  // 1 argument
+  CHECK(forwards<GLFWwindowclosefun>(fake_window));
+  CHECK(forwards<GLFWwindowrefreshfun>(fake_window));
+  // 2 arguments
+  CHECK(forwards<GLFWwindowfocusfun>(fake_window, GLFW_TRUE));
+  CHECK(forwards<GLFWcursorenterfun>(fake_window, GLFW_FALSE));
+  CHECK(forwards<GLFWcharfun>(fake_window, 0x1F600u));
+  CHECK(forwards<GLFWerrorfun>(0x10008, "error description"));
+  CHECK(forwards<GLFWjoystickfun>(GLFW_JOYSTICK_3, GLFW_CONNECTED));
+  // 3 arguments
+  CHECK(forwards<GLFWwindowposfun>(fake_window, -1920, 1080));
+  CHECK(forwards<GLFWframebuffersizefun>(fake_window, 2368, 1332));
+  CHECK(forwards<GLFWcursorposfun>(fake_window, 123.25, -456.5));
+  CHECK(forwards<GLFWscrollfun>(fake_window, 0.0, -1.75));
+  CHECK(forwards<GLFWcharmodsfun>(fake_window, 0xE9u, GLFW_MOD_CONTROL));
+  static char const* paths[] = { "a.vs", "b.fs" };
+  CHECK(forwards<GLFWdropfun>(fake_window, 2, paths));
+  // 4 arguments
+  CHECK(forwards<GLFWmousebuttonfun>(fake_window, GLFW_MOUSE_BUTTON_RIGHT, GLFW_RELEASE, GLFW_MOD_SUPER));
+}
+
+TEST_CASE(thunk_forwards_stack_arguments)
+{
+  // Six integer arguments push the one arriving in R9 onto the stack
+  using six_ints = void(*)(int, long long, short, char, unsigned, void*);
+  CHECK(forwards<six_ints>(1, -2LL, short{ 3 }, char{ 4 }, 5u, static_cast<void*>(fake_window)));
+
+  // More than that also moves existing stack arguments, interleaved with spilled doubles
+  using mixed = void(*)(double, int, double, int, double, int, double, int,
+                        double, int, double, int, double, int, double, double);
+  CHECK(forwards<mixed>(0.5, 1, 1.5, 2, 2.5, 3, 3.5, 4, 4.5, 5, 5.5, 6, 6.5, 7, 7.5, 8.5));
+}
+
+namespace
+{
+
+struct Base
+{
+  virtual ~Base() = default;
+  virtual int scaled(int value, double factor) { return value + static_cast<int>(factor); }
+  long long member = 0x69;
+};
+
+struct Derived : Base
+{
+  int scaled(int value, double factor) override
+  {
+    return static_cast<int>(member * value * factor);
+  }
+};
+
+}
+
+TEST_CASE(thunk_returns_values_and_dispatches_virtually)
+{
+  Derived derived;
+  VNgine::JitThunk<Base, int(*)(int, double)> const thunk{ &derived, &Base::scaled };
+  CHECK(thunk.getCallback()(3, 2.0) == 0x69 * 6);
+  VNgine::StaticThunk<Base, int(*)(int, double)> const trampoline{ &derived, &Base::scaled };
+  CHECK(trampoline.getCallback()(3, 2.0) == 0x69 * 6);
+}
+
+TEST_CASE(thunk_heap_recycles_slots_and_tracks_stats)
+{
+  using Key = Forwarding<GLFWkeyfun>;
+  Key receiver;
+  VNgine::ThunkHeap::Stats const before = VNgine::ThunkHeap::stats();
+  void* first_address = nullptr;
+  {
+    VNgine::JitThunk<Key, GLFWkeyfun> const thunk{ &receiver, &Key::callback };
+    first_address = reinterpret_cast<void*>(thunk.getCallback());
+    CHECK(VNgine::ThunkHeap::stats().live_thunks == before.live_thunks + 1);
+  }
+  CHECK(VNgine::ThunkHeap::stats().live_thunks == before.live_thunks);
+
+  // A freed slot is the first to be handed out again
+  VNgine::JitThunk<Key, GLFWkeyfun> const reused{ &receiver, &Key::callback };
+  CHECK(reinterpret_cast<void*>(reused.getCallback()) == first_address);
+}
+
+TEST_CASE(thunk_heap_batch_thunks_run_once_it_ends)
+{
+  using Key = Forwarding<GLFWkeyfun>;
+  Key receivers[100];
+  std::optional<VNgine::JitThunk<Key, GLFWkeyfun>> thunks[100];
+  {
+    VNgine::ThunkHeap::Batch batch;
+    for (int i = 0; i < 100; ++i)
+    {
+      thunks[i].emplace(&receivers[i], &Key::callback);
+    }
+  }
+  for (int i = 0; i < 100; ++i)
+  {
+    thunks[i]->getCallback()(fake_window, i, 0, GLFW_PRESS, 0);
+    CHECK(receivers[i].calls == 1 && std::get<1>(receivers[i].seen) == i);
+  }
+}
+
+TEST_CASE(thunk_heap_keeps_live_thunks_running_while_writing_their_slab)
+{
+  using Key = Forwarding<GLFWkeyfun>;
+  Key caller_receiver;
+  VNgine::JitThunk<Key, GLFWkeyfun> const live{ &caller_receiver, &Key::callback };
+  std::uintptr_t const live_page = reinterpret_cast<std::uintptr_t>(live.getCallback()) & ~std::uintptr_t{ 4095 };
+
+  // Stands in for a GLFW callback firing on another thread while thunks are being created
+  std::atomic<bool> stop{ false };
+  std::thread caller{ [&]
+  {
+    while (!stop.load(std::memory_order_relaxed))
+    {
+      live.getCallback()(fake_window, GLFW_KEY_A, 0, GLFW_PRESS, 0);
+    }
+  } };
+
+  Key receiver;
+  bool shared_page = false;
+  std::optional<VNgine::JitThunk<Key, GLFWkeyfun>> thunks[128];
+  for (int round = 0; round < 500; ++round)
+  {
+    std::optional<VNgine::ThunkHeap::Batch> batch;
+    if (round % 2)
+    {
+      batch.emplace();
+    }
+    for (auto& thunk : thunks)
+    {
+      thunk.emplace(&receiver, &Key::callback);
+      std::uintptr_t const page = reinterpret_cast<std::uintptr_t>(thunk->getCallback()) & ~std::uintptr_t{ 4095 };
+      shared_page = shared_page || page == live_page;
+    }
+    batch.reset();
+    for (auto& thunk : thunks)
+    {
+      thunk.reset();
+    }
+  }
+  stop.store(true, std::memory_order_relaxed);
+  caller.join();
+
+  CHECK(shared_page);
+  CHECK(caller_receiver.calls > 0 && std::get<1>(caller_receiver.seen) == GLFW_KEY_A);
+}
+
+TEST_CASE(trampoline_pool_reuses_released_slots)
+{
+  using Key = Forwarding<GLFWkeyfun>;
+  Key first;
+  Key second;
+  GLFWkeyfun released_callback = nullptr;
+  {
+    VNgine::StaticThunk<Key, GLFWkeyfun> const thunk{ &first, &Key::callback };
+    released_callback = thunk.getCallback();
+  }
+  VNgine::StaticThunk<Key, GLFWkeyfun> const reused{ &second, &Key::callback };
+  VNgine::StaticThunk<Key, GLFWkeyfun> const other{ &first, &Key::callback };
+  CHECK(reused.getCallback() == released_callback);
+  CHECK(other.getCallback() != reused.getCallback());
+
+  reused.getCallback()(fake_window, GLFW_KEY_G, 0, GLFW_PRESS, 0);
+  CHECK(second.calls == 1 && first.calls == 0);
+}
@@ -0,0 +1,81 @@
+#include <cmath>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <VNgine/transform.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+struct Object
+{
+  glm::vec3 position;
+  float angle;
+  glm::vec3 axis;
+};
+
+char const* kernelName(VNgine::TransformArray::Kernel kernel)
+{
+  switch (kernel)
+  {
+  case VNgine::TransformArray::Kernel::SSE:
+    return "SSE";
+  case VNgine::TransformArray::Kernel::AVX2:
+    return "AVX2";
+  default:
+    return "scalar";
+  }
+}
+
+}
+
+BENCHMARK(transform_model_matrices)
+{
+  for (std::size_t const count : { std::size_t{ 1000 }, std::size_t{ 100000 }, std::size_t{ 1000000 } })
+  {
+    std::vector<Object> objects;
+    VNgine::TransformArray transforms;
+    transforms.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      float const f = static_cast<float>(i % 1000);
+      objects.push_back({ { f, 0.5f * f, -f }, 0.01f * f, { 1.0f, 0.3f, 0.5f } });
+      transforms.add(objects.back().position, objects.back().angle, objects.back().axis);
+    }
+    std::vector<glm::mat4> matrices(count);
+    // Enough repetitions that the smallest size still takes measurable time
+    std::size_t const repeats = 10000000 / count;
+    std::printf("  %zu transforms\n", count);
+
+    test::measure("glm translate * rotate per object", count * repeats, [&]
+    {
+      for (std::size_t repeat = 0; repeat < repeats; ++repeat)
+      {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          glm::mat4 model = glm::translate(glm::mat4{ 1.0f }, objects[i].position);
+          matrices[i] = glm::rotate(model, objects[i].angle, objects[i].axis);
+        }
+      }
+    });
+    for (VNgine::TransformArray::Kernel const kernel :
+      { VNgine::TransformArray::Kernel::SCALAR, VNgine::TransformArray::Kernel::SSE, VNgine::TransformArray::Kernel::AVX2 })
+    {
+      if (!VNgine::TransformArray::isSupported(kernel))
+      {
+        continue;
+      }
+      char label[64];
+      std::snprintf(label, sizeof(label), "TransformArray, %s", kernelName(kernel));
+      test::measure(label, count * repeats, [&]
+      {
+        for (std::size_t repeat = 0; repeat < repeats; ++repeat)
+        {
+          transforms.computeMatrices(matrices.data(), sizeof(glm::mat4), kernel);
+        }
+      });
+    }
+  }
+}
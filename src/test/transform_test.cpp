@@ -0,0 +1,70 @@
+#include <cmath>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <VNgine/sprite_batch.h>
+#include <VNgine/transform.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+bool nearlyEqual(glm::mat4 const& a, glm::mat4 const& b)
+{
+  for (int column = 0; column < 4; ++column)
+  {
+    for (int row = 0; row < 4; ++row)
+    {
+      if (std::fabs(a[column][row] - b[column][row]) > 1e-5f * (1.0f + std::fabs(b[column][row])))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+TEST_CASE(transform_kernels_match_glm)
+{
+  // Not a multiple of any SIMD width, so every kernel also runs its scalar tail
+  constexpr std::size_t count = 37;
+  VNgine::TransformArray transforms;
+  std::vector<glm::mat4> expected;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    float const f = static_cast<float>(i);
+    glm::vec3 const position{ f - 18.0f, 0.5f * f, -3.0f * f };
+    float const angle = 0.37f * f - 4.0f;
+    glm::vec3 const axis{ 1.0f + f, 0.3f - 0.1f * f, 0.5f };
+    glm::vec3 const scale{ 1.0f + 0.1f * f, 2.0f, 0.25f * (f + 1.0f) };
+    transforms.add(position, angle, axis, scale);
+    glm::mat4 model = glm::translate(glm::mat4{ 1.0f }, position);
+    model = glm::rotate(model, angle, axis);
+    expected.push_back(glm::scale(model, scale));
+  }
+
+  for (VNgine::TransformArray::Kernel const kernel :
+    { VNgine::TransformArray::Kernel::SCALAR, VNgine::TransformArray::Kernel::SSE, VNgine::TransformArray::Kernel::AVX2 })
+  {
+    if (!VNgine::TransformArray::isSupported(kernel))
+    {
+      continue;
+    }
+    // Written straight into instance data, leaving the other members alone
+    std::vector<VNgine::SpriteInstance> instances(count, { glm::mat4{ 0.0f }, glm::vec4{ 7.0f }, glm::vec4{ 9.0f } });
+    transforms.computeMatrices(&instances[0].transform, sizeof(VNgine::SpriteInstance), kernel);
+    bool matches = true;
+    bool untouched = true;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      matches = matches && nearlyEqual(instances[i].transform, expected[i]);
+      untouched = untouched && instances[i].color.x == 7.0f && instances[i].uv_rect.w == 9.0f;
+    }
+    CHECK(matches);
+    CHECK(untouched);
+  }
+  CHECK(VNgine::TransformArray::isSupported(VNgine::TransformArray::bestKernel()));
+}
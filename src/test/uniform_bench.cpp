@@ -0,0 +1,169 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <VNgine/shader.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr std::size_t program_count = 32;
+constexpr std::size_t draws_per_program = 16;
+constexpr std::size_t frames = 2000;
+
+struct CameraBlock
+{
+  glm::mat4 view;
+  glm::mat4 projection;
+};
+
+// The same body twice: once reading the camera from plain uniforms, once from a block
+fs::path writeShaders()
+{
+  fs::path const directory = fs::temp_directory_path() / "vngine_uniform_bench";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  for (std::size_t i = 0; i < program_count; ++i)
+  {
+    std::string const index = std::to_string(i);
+    std::string const body =
+      "layout (location = 0) in vec3 aPos;\nuniform mat4 model;\n"
+      "void main() { gl_Position = projection * view * model * vec4(aPos * " + index + ".0, 1.0); }\n";
+    std::ofstream{ directory / ("plain_" + index + ".vs") } <<
+      "#version 330 core\nuniform mat4 view;\nuniform mat4 projection;\n" << body;
+    std::ofstream{ directory / ("block_" + index + ".vs") } <<
+      "#version 330 core\nlayout (std140) uniform Camera { mat4 view; mat4 projection; };\n" << body;
+  }
+  std::ofstream{ directory / "solid.fs" } <<
+    "#version 330 core\nout vec4 FragColor;\nvoid main() { FragColor = vec4(1.0); }\n";
+  return directory;
+}
+
+glm::mat4 modelFor(std::size_t draw)
+{
+  glm::mat4 model{ 1.0f };
+  model[3][0] = static_cast<float>(draw);
+  return model;
+}
+
+}
+
+BENCHMARK(uniform_upload_per_frame)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    test::GLContext::skip("uniform upload per frame");
+    return;
+  }
+
+  fs::path const directory = writeShaders();
+  VNgine::ShaderPool const pool{ directory.string() };
+  std::vector<std::unique_ptr<VNgine::ShaderProgram>> plain;
+  std::vector<std::unique_ptr<VNgine::ShaderProgram>> block;
+  VNgine::UniformBuffer<CameraBlock> camera{ 0 };
+  for (std::size_t i = 0; i < program_count; ++i)
+  {
+    std::string const index = std::to_string(i);
+    plain.push_back(std::make_unique<VNgine::ShaderProgram>(pool, std::string_view{ "plain_" + index }, "solid"));
+    block.push_back(std::make_unique<VNgine::ShaderProgram>(pool, std::string_view{ "block_" + index }, "solid"));
+    block.back()->bindUniformBlock("Camera", camera);
+  }
+  for (std::size_t i = 0; i < program_count; ++i)
+  {
+    plain[i]->isLinked();
+    block[i]->isLinked();
+  }
+  std::printf("  %zu programs, %zu model matrices each, per frame\n", program_count, draws_per_program);
+
+  CameraBlock frame_camera{ glm::mat4{ 1.0f }, glm::mat4{ 1.0f } };
+  std::vector<GLuint> ids;
+  for (auto const& program : plain)
+  {
+    program->use();
+    GLint id;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &id);
+    ids.push_back(static_cast<GLuint>(id));
+  }
+
+  // What main.cpp did: look every location up by string and upload the camera to each program
+  test::measure("previous: string lookups, camera per program", frames, [&]
+  {
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      frame_camera.view[3][2] = static_cast<float>(frame);
+      for (GLuint const id : ids)
+      {
+        glUseProgram(id);
+        glUniformMatrix4fv(glGetUniformLocation(id, "view"), 1, GL_FALSE, glm::value_ptr(frame_camera.view));
+        glUniformMatrix4fv(glGetUniformLocation(id, "projection"), 1, GL_FALSE, glm::value_ptr(frame_camera.projection));
+        for (std::size_t draw = 0; draw < draws_per_program; ++draw)
+        {
+          glUniformMatrix4fv(glGetUniformLocation(id, "model"), 1, GL_FALSE, glm::value_ptr(modelFor(draw)));
+        }
+      }
+    }
+    glFinish();
+  });
+
+  std::vector<GLint> model_locations;
+  for (auto const& program : block)
+  {
+    model_locations.push_back(program->getUniformLocation("model"));
+  }
+  test::measure("reflected locations, camera block once", frames, [&]
+  {
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      frame_camera.view[3][2] = static_cast<float>(frame);
+      camera.update(frame_camera);
+      for (std::size_t i = 0; i < program_count; ++i)
+      {
+        block[i]->use();
+        for (std::size_t draw = 0; draw < draws_per_program; ++draw)
+        {
+          block[i]->setUniform(model_locations[i], modelFor(draw));
+        }
+      }
+    }
+    glFinish();
+  });
+
+  // Static scenery: the same model matrix every draw, so only the first one reaches GL
+  std::size_t skipped_before = 0;
+  for (auto const& program : block)
+  {
+    skipped_before += program->getUniforms().stats().skipped;
+  }
+  test::measure("reflected locations, unchanged values", frames, [&]
+  {
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+      camera.update(frame_camera);
+      for (std::size_t i = 0; i < program_count; ++i)
+      {
+        block[i]->use();
+        for (std::size_t draw = 0; draw < draws_per_program; ++draw)
+        {
+          block[i]->setUniform(model_locations[i], modelFor(0));
+        }
+      }
+    }
+    glFinish();
+  });
+  std::size_t skipped = 0;
+  for (auto const& program : block)
+  {
+    skipped += program->getUniforms().stats().skipped;
+  }
+  std::printf("  %-48s %10zu\n", "redundant sets skipped", skipped - skipped_before);
+  fs::remove_all(directory);
+}
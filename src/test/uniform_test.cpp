@@ -0,0 +1,195 @@
+#include <filesystem>
+#include <fstream>
+
+#include <VNgine/shader.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+struct LightBlock
+{
+  glm::mat4 view;
+  VNgine::std140::padded<glm::vec3> direction;
+  VNgine::std140::padded<float> weights[2];
+};
+static_assert(sizeof(LightBlock) == 64 + 16 + 32);
+
+void writeReflectionShaders(fs::path const& directory)
+{
+  fs::create_directories(directory);
+  std::ofstream{ directory / "reflect.vs" } <<
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\n"
+    "layout (std140) uniform Light { mat4 view; vec3 direction; float weights[2]; };\n"
+    "uniform mat3 basis;\n"
+    "uniform float scale = 2.0;\n"
+    "void main() { gl_Position = view * vec4(basis * aPos * scale + direction * weights[1], 1.0); }\n";
+  std::ofstream{ directory / "reflect.fs" } <<
+    "#version 330 core\n"
+    "uniform vec3 tint;\n"
+    "uniform ivec2 offset;\n"
+    "uniform uint mask;\n"
+    "uniform bool enabled;\n"
+    "uniform float ramp[4];\n"
+    "uniform sampler2D albedo;\n"
+    "out vec4 FragColor;\n"
+    "void main()\n{\n"
+    "  vec4 texel = texelFetch(albedo, offset, 0);\n"
+    "  float r = ramp[0] + ramp[1] + ramp[2] + ramp[3] + float(mask & 1u);\n"
+    "  FragColor = enabled ? vec4(tint * r, 1.0) * texel : texel;\n}\n";
+}
+
+}
+
+TEST_CASE(shader_program_reflects_uniforms_and_skips_redundant_sets)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+
+  fs::path const directory = fs::temp_directory_path() / "vngine_uniform_test";
+  fs::remove_all(directory);
+  writeReflectionShaders(directory);
+
+  {
+    VNgine::ShaderPool const pool{ directory.string() };
+    VNgine::ShaderProgram program{ pool, "reflect", "reflect" };
+    CHECK(program.isLinked());
+    program.use();
+
+    VNgine::UniformTable const& table = program.getUniforms();
+    VNgine::Uniform const* const ramp = table.find("ramp");
+    CHECK(ramp && ramp->count == 4 && ramp->type == GL_FLOAT);
+    CHECK(!table.find("ramp[0]"));
+    CHECK(table.find("albedo") && table.find("albedo")->type == GL_SAMPLER_2D);
+    CHECK(program.getUniformLocation("missing") == -1);
+    // Block members are set through the block, not one at a time
+    CHECK(!table.find("view"));
+
+    // Seeded from the initializer in the shader, so this first set is already redundant
+    GLint const scale = program.getUniformLocation("scale");
+    program.setUniform(scale, 2.0f);
+    CHECK(table.stats().uploads == 0 && table.stats().skipped == 1);
+
+    GLint const tint = program.getUniformLocation("tint");
+    program.setUniform(tint, glm::vec3{ 0.25f, 0.5f, 1.0f });
+    program.setUniform(tint, glm::vec3{ 0.25f, 0.5f, 1.0f });
+    CHECK(table.stats().uploads == 1 && table.stats().skipped == 2);
+    GLfloat readback[3];
+    GLint current;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+    glGetUniformfv(static_cast<GLuint>(current), tint, readback);
+    CHECK(readback[0] == 0.25f && readback[1] == 0.5f && readback[2] == 1.0f);
+
+    float const tail[2] = { 3.0f, 4.0f };
+    program.setUniform(ramp->location + 2, tail, 2);
+    glGetUniformfv(static_cast<GLuint>(current), ramp->location + 3, readback);
+    CHECK(readback[0] == 4.0f);
+
+    program.setUniform(program.getUniformLocation("enabled"), true);
+    program.setUniform(program.getUniformLocation("offset"), glm::ivec2{ 1, 2 });
+    program.setUniform(program.getUniformLocation("mask"), GLuint{ 7 });
+    program.setUniform(program.getUniformLocation("albedo"), GLint{ 0 });
+    program.setUniform(program.getUniformLocation("basis"), glm::mat3{ 1.0f });
+    CHECK(table.stats().uploads == 6 && table.stats().skipped == 3);
+    program.setUniform(program.getUniformLocation("enabled"), true);
+    CHECK(table.stats().uploads == 6);
+    GLint enabled;
+    glGetUniformiv(static_cast<GLuint>(current), program.getUniformLocation("enabled"), &enabled);
+    CHECK(enabled == 1);
+
+    VNgine::UniformBlock const* const light = table.findBlock("Light");
+    CHECK(light && light->size == static_cast<GLint>(sizeof(LightBlock)));
+    VNgine::UniformBuffer<LightBlock> buffer{ 3 };
+    program.bindUniformBlock("Light", buffer);
+    GLint binding;
+    glGetActiveUniformBlockiv(static_cast<GLuint>(current), light->index, GL_UNIFORM_BLOCK_BINDING, &binding);
+    CHECK(binding == 3);
+
+    LightBlock const block{ glm::mat4{ 1.0f }, { glm::vec3{ 0.0f, 1.0f, 0.0f } }, { { 0.5f }, { 1.5f } } };
+    buffer.update(block);
+    buffer.update(block);
+    CHECK(buffer.getUploads() == 1);
+    float weight;
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer.getID());
+    glGetBufferSubData(GL_UNIFORM_BUFFER, 64 + 16 + 16, sizeof(float), &weight);
+    CHECK(weight == 1.5f);
+  }
+  fs::remove_all(directory);
+}
+
+TEST_CASE(shader_program_sets_non_square_and_double_uniforms)
+{
+  test::GLContext const context;
+  if (!context)
+  {
+    return;
+  }
+
+  fs::path const directory = fs::temp_directory_path() / "vngine_uniform_types_test";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  std::ofstream{ directory / "shapes.vs" } <<
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\n"
+    "uniform mat2x3 skew;\n"
+    "uniform mat4x3 frame;\n"
+    "void main() { gl_Position = vec4(skew * aPos.xy + frame * vec4(aPos, 1.0), 1.0); }\n";
+  std::ofstream{ directory / "shapes.fs" } <<
+    "#version 330 core\nout vec4 FragColor;\nvoid main() { FragColor = vec4(1.0); }\n";
+  std::ofstream{ directory / "doubles.vs" } <<
+    "#version 400 core\n"
+    "layout (location = 0) in vec3 aPos;\n"
+    "uniform double gain;\n"
+    "uniform dvec3 origin;\n"
+    "uniform dmat3 basis;\n"
+    "void main() { gl_Position = vec4(vec3(basis * (dvec3(aPos) - origin) * gain), 1.0); }\n";
+  std::ofstream{ directory / "doubles.fs" } <<
+    "#version 400 core\nout vec4 FragColor;\nvoid main() { FragColor = vec4(1.0); }\n";
+
+  {
+    VNgine::ShaderPool const pool{ directory.string() };
+    VNgine::ShaderProgram shapes{ pool, "shapes", "shapes" };
+    CHECK(shapes.isLinked());
+    shapes.use();
+    VNgine::UniformTable const& table = shapes.getUniforms();
+    CHECK(table.find("skew") && table.find("skew")->type == GL_FLOAT_MAT2x3);
+    glm::mat2x3 skew{};
+    skew[1].z = 3.0f;
+    shapes.setUniform(shapes.getUniformLocation("skew"), skew);
+    shapes.setUniform(shapes.getUniformLocation("skew"), skew);
+    shapes.setUniform(shapes.getUniformLocation("frame"), glm::mat4x3{});
+    CHECK(table.stats().uploads == 1 && table.stats().skipped == 2);
+    GLint current;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+    GLfloat readback[6];
+    glGetUniformfv(static_cast<GLuint>(current), shapes.getUniformLocation("skew"), readback);
+    CHECK(readback[5] == 3.0f);
+
+    // Needs fp64, which not every driver has
+    VNgine::ShaderProgram doubles{ pool, "doubles", "doubles" };
+    if (doubles.isLinked())
+    {
+      doubles.use();
+      VNgine::UniformTable const& double_table = doubles.getUniforms();
+      CHECK(double_table.find("basis") && double_table.find("basis")->type == GL_DOUBLE_MAT3);
+      CHECK(doubles.getUniformLocation("gain") != -1);
+      doubles.setUniform(doubles.getUniformLocation("gain"), 0.125);
+      doubles.setUniform(doubles.getUniformLocation("origin"), glm::dvec3{ 1.0, 2.0, 3.0 });
+      doubles.setUniform(doubles.getUniformLocation("origin"), glm::dvec3{ 1.0, 2.0, 3.0 });
+      doubles.setUniform(doubles.getUniformLocation("basis"), glm::dmat3{});
+      CHECK(double_table.stats().uploads == 2 && double_table.stats().skipped == 2);
+      glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+      GLdouble origin[3];
+      glGetUniformdv(static_cast<GLuint>(current), doubles.getUniformLocation("origin"), origin);
+      CHECK(origin[0] == 1.0 && origin[2] == 3.0);
+    }
+  }
+  fs::remove_all(directory);
+}
@@ -0,0 +1,67 @@
+#include <VNgine/engine.h>
+#include <VNgine/gl_state.h>
+#include <test/gl_context.h>
+#include <test/test_framework.h>
+
+namespace
+{
+
+GLint boundInteger(GLenum name)
+{
+  GLint value = -1;
+  glGetIntegerv(name, &value);
+  return value;
+}
+
+void drawFrame(VNgine::Window& window, float green)
+{
+  VNgine::GLState& gl = window.getGLState();
+  gl.enable(GL_SCISSOR_TEST);
+  gl.flush();
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  glScissor(0, 0, 32, 32);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  glClearColor(1.0f, green, 0.0f, 1.0f);
+  glScissor(4, 8, 12, 6);
+  glClear(GL_COLOR_BUFFER_BIT);
+  gl.disable(GL_SCISSOR_TEST);
+  gl.flush();
+}
+
+}
+
+TEST_CASE(headless_window_renders_offscreen_and_hashes_frames)
+{
+  {
+    test::GLContext const probe;
+    if (!probe)
+    {
+      return;
+    }
+  }
+  VNgine::Window window{ 32, 32, "headless test", VNgine::Window::Mode::HEADLESS };
+  CHECK(window.isHeadless());
+  CHECK(window.getFramebuffer() != 0);
+  CHECK(boundInteger(GL_DRAW_FRAMEBUFFER_BINDING) == static_cast<GLint>(window.getFramebuffer()));
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  CHECK(viewport[2] == 32 && viewport[3] == 32);
+  // Stays hidden
+  window.show();
+
+  drawFrame(window, 0.0f);
+  unsigned char pixel[4];
+  glReadPixels(5, 9, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+  CHECK(pixel[0] == 255 && pixel[1] == 0 && pixel[2] == 0);
+  std::uint64_t const first = window.hashFrame();
+  window.present();
+
+  // The same frame drawn again hashes the same; a one-channel change does not
+  drawFrame(window, 0.0f);
+  CHECK(window.hashFrame() == first);
+  window.present();
+  drawFrame(window, 0.5f);
+  CHECK(window.hashFrame() != first);
+  window.present();
+  CHECK(glGetError() == GL_NO_ERROR);
+}